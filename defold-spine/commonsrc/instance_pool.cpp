@@ -0,0 +1,117 @@
+#include <common/instance_pool.h>
+
+#include <dmsdk/dlib/math.h>
+
+#include <spine/AnimationState.h>
+#include <spine/PhysicsConstraint.h>
+#include <spine/Skeleton.h>
+
+namespace dmSpine
+{
+    void SetInstancePoolSize(SpineInstancePool* pool, uint32_t max_free_count, uint32_t prewarm_count)
+    {
+        pool->m_MaxFreeCount = max_free_count;
+        pool->m_PrewarmCount = dmMath::Min(prewarm_count, max_free_count);
+    }
+
+    static void CreateInstance(SpineInstancePool* pool, spSkeletonData* skeleton_data, spAnimationStateData* state_data, SpineInstance* out)
+    {
+        out->m_Arena = BeginInstanceAllocations(&pool->m_Arenas);
+        out->m_Skeleton = spSkeleton_create(skeleton_data);
+        out->m_AnimationState = spAnimationState_create(state_data);
+        EndInstanceAllocations(&pool->m_Arenas, out->m_Arena);
+    }
+
+    static void DisposeInstance(SpineInstancePool* pool, SpineInstance* instance)
+    {
+        BeginInstanceDispose(instance->m_Arena);
+        if (instance->m_AnimationState)
+            spAnimationState_dispose(instance->m_AnimationState);
+        if (instance->m_Skeleton)
+            spSkeleton_dispose(instance->m_Skeleton);
+        EndInstanceDispose(&pool->m_Arenas, instance->m_Arena);
+    }
+
+    // Puts the instance back in the state spSkeleton_create() and spAnimationState_create() leave it in,
+    // but keeps the memory that grew while it was used (e.g. the tracks, the deforms and the event queue)
+    static void ResetInstance(SpineInstance* instance)
+    {
+        // The events of the cleared tracks go nowhere, since the model is gone
+        spAnimationState* state = instance->m_AnimationState;
+        state->listener = 0;
+        state->userData = 0;
+        spAnimationState_clearTracks(state);
+        state->timeScale = 1.0f;
+
+        spSkeleton* skeleton = instance->m_Skeleton;
+        spSkeleton_setSkin(skeleton, 0);
+        spSkeleton_setToSetupPose(skeleton);
+        spColor_setFromFloats(&skeleton->color, 1, 1, 1, 1);
+        skeleton->x = 0;
+        skeleton->y = 0;
+        skeleton->scaleX = 1;
+        skeleton->scaleY = 1;
+        skeleton->time = 0;
+        for (int i = 0; i < skeleton->physicsConstraintsCount; ++i)
+            spPhysicsConstraint_reset(skeleton->physicsConstraints[i]);
+    }
+
+    void AcquireInstance(SpineInstancePool* pool, spSkeletonData* skeleton_data, spAnimationStateData* state_data, SpineInstance* out)
+    {
+        if (!pool->m_Free.Empty())
+        {
+            *out = pool->m_Free.Back();
+            pool->m_Free.Pop();
+            return;
+        }
+        CreateInstance(pool, skeleton_data, state_data, out);
+    }
+
+    void ReleaseInstance(SpineInstancePool* pool, spSkeletonData* skeleton_data, SpineInstance* instance)
+    {
+        if (!instance->m_Skeleton || !instance->m_AnimationState || instance->m_Skeleton->data != skeleton_data ||
+            pool->m_Free.Size() >= pool->m_MaxFreeCount)
+        {
+            DisposeInstance(pool, instance);
+            return;
+        }
+
+        ResetInstance(instance);
+        if (pool->m_Free.Full())
+            pool->m_Free.OffsetCapacity(dmMath::Min(pool->m_MaxFreeCount - pool->m_Free.Size(), 16U));
+        pool->m_Free.Push(*instance);
+    }
+
+    void PrewarmInstancePool(SpineInstancePool* pool, spSkeletonData* skeleton_data, spAnimationStateData* state_data)
+    {
+        if (pool->m_Free.Size() >= pool->m_PrewarmCount)
+            return;
+
+        pool->m_Free.SetCapacity(pool->m_PrewarmCount);
+        while (pool->m_Free.Size() < pool->m_PrewarmCount)
+        {
+            SpineInstance instance;
+            CreateInstance(pool, skeleton_data, state_data, &instance);
+            if (!instance.m_Skeleton || !instance.m_AnimationState)
+            {
+                DisposeInstance(pool, &instance);
+                return;
+            }
+            pool->m_Free.Push(instance);
+        }
+    }
+
+    void FlushInstancePool(SpineInstancePool* pool)
+    {
+        for (uint32_t i = 0; i < pool->m_Free.Size(); ++i)
+            DisposeInstance(pool, &pool->m_Free[i]);
+        pool->m_Free.SetSize(0);
+    }
+
+    void DestroyInstancePool(SpineInstancePool* pool)
+    {
+        FlushInstancePool(pool);
+        pool->m_Free.SetCapacity(0);
+        DestroyInstanceArenaPool(&pool->m_Arenas);
+    }
+}
@@ -0,0 +1,1117 @@
+#include <common/skeleton_blob.h>
+#include <common/spine_loader.h>
+
+#include <spine/extension.h>
+#include <spine/Animation.h>
+#include <spine/BoneData.h>
+#include <spine/BoundingBoxAttachment.h>
+#include <spine/ClippingAttachment.h>
+#include <spine/EventData.h>
+#include <spine/IkConstraintData.h>
+#include <spine/MeshAttachment.h>
+#include <spine/PathAttachment.h>
+#include <spine/PathConstraintData.h>
+#include <spine/PhysicsConstraintData.h>
+#include <spine/PointAttachment.h>
+#include <spine/RegionAttachment.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+#include <spine/SlotData.h>
+#include <spine/TransformConstraintData.h>
+
+#include <stddef.h> // offsetof
+#include <stdlib.h>
+#include <string.h>
+
+#include <dmsdk/dlib/array.h>
+#include <dmsdk/dlib/hashtable.h>
+#include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/math.h>
+#include <dmsdk/dlib/static_assert.h>
+
+namespace dmSpine
+{
+    static const uint32_t SKELETON_BLOB_MAGIC     = 'S' | 'P' << 8 | 'B' << 16 | 'L' << 24;
+    static const uint32_t SKELETON_BLOB_VERSION   = 2;
+    // The loaded objects are aligned to this (the largest alignment of the fields below)
+    static const uint32_t SKELETON_BLOB_ALIGNMENT = 8;
+
+    // The blob holds the objects of the skeleton data ("blocks"), e.g. a spBoneData, a float array or a string, in a format
+    // that doesn't depend on the struct layout of the platform that wrote it. The fields of each block are packed in the
+    // order of the signature of its type (see BLOCK_TYPES), little endian, and a pointer is stored as the index of the
+    // block it points to, plus one (0 is null). When loading, the blocks are expanded to the struct layout of the platform.
+    struct SkeletonBlobHeader
+    {
+        uint32_t m_Magic;
+        uint32_t m_Version;
+        uint32_t m_FormatHash;          // See GetFormatHash()
+        uint32_t m_Size;                // The header, the block table and the fields of the blocks
+        uint32_t m_BlocksCount;         // The block table comes after the header, and then the fields of the blocks, in the same order
+        uint32_t m_Reserved[3];
+    };
+
+    struct SkeletonBlobBlock
+    {
+        uint32_t m_Type;                // BlockType
+        uint32_t m_Count;               // The number of items, e.g. the length of a float array. 1 for an object
+    };
+
+    enum BlockType
+    {
+        BLOCK_CHARS,
+        BLOCK_UINT16,
+        BLOCK_INT32,                    // Also the floats
+        BLOCK_INT64,
+        BLOCK_POINTERS,
+        BLOCK_SPINE_ARRAY,              // E.g. spFloatArray. The items are a block of their own
+        BLOCK_SKELETON_DATA,            // Always the first block
+        BLOCK_BONE_DATA,
+        BLOCK_SLOT_DATA,
+        BLOCK_SKIN,
+        BLOCK_SKIN_ENTRY,
+        BLOCK_SKIN_HASH_TABLE_ENTRY,
+        BLOCK_EVENT_DATA,
+        BLOCK_EVENT,
+        BLOCK_IK_CONSTRAINT_DATA,
+        BLOCK_TRANSFORM_CONSTRAINT_DATA,
+        BLOCK_PATH_CONSTRAINT_DATA,
+        BLOCK_PHYSICS_CONSTRAINT_DATA,
+        BLOCK_ANIMATION,
+        BLOCK_SEQUENCE,
+        BLOCK_INDEX_TIMELINE,           // E.g. spInheritTimeline
+        BLOCK_CURVE_INDEX_TIMELINE,     // E.g. spRotateTimeline
+        BLOCK_ATTACHMENT_TIMELINE,
+        BLOCK_DEFORM_TIMELINE,
+        BLOCK_SEQUENCE_TIMELINE,
+        BLOCK_EVENT_TIMELINE,
+        BLOCK_DRAW_ORDER_TIMELINE,
+        BLOCK_REGION_ATTACHMENT,
+        BLOCK_MESH_ATTACHMENT,          // Also the linked meshes
+        BLOCK_BOUNDING_BOX_ATTACHMENT,
+        BLOCK_PATH_ATTACHMENT,
+        BLOCK_POINT_ATTACHMENT,
+        BLOCK_CLIPPING_ATTACHMENT,
+        BLOCK_TYPE_COUNT
+    };
+
+    // The signature lists the fields of a struct in order: 'c' char, 's' unsigned short, 'i' int, float or enum, 'l' 64 bit
+    // int, 'p' pointer, each optionally followed by a count. '|' ends an embedded struct (e.g. the super struct), which
+    // is padded to its alignment. Spaces are ignored.
+    // The signatures must follow the spine structs. The struct sizes are checked when loading and writing.
+    struct BlockTypeDesc
+    {
+        const char* m_Signature;
+        uint32_t    m_Size;             // The struct size, to check the signature against
+    };
+
+#define SIG_ATTACHMENT          "p i p i p |"
+#define SIG_VERTEX_ATTACHMENT   SIG_ATTACHMENT " i p i p i p i |"
+#define SIG_TIMELINE            "p3 l3 i p i i i |"
+#define SIG_CURVE_TIMELINE      SIG_TIMELINE " p |"
+
+    static const BlockTypeDesc BLOCK_TYPES[] =
+    {
+        { "c",                                              1 },
+        { "s",                                              sizeof(unsigned short) },
+        { "i",                                              sizeof(int) },
+        { "l",                                              sizeof(spPropertyId) },
+        { "p",                                              sizeof(void*) },
+        { "i2 p",                                           sizeof(spFloatArray) },
+        { "p2 i6 p2 ip ip ip ip p ip ip ip ip ip ip p",     sizeof(spSkeletonData) },
+        { "i p2 i i7 i2 i4 p i",                            sizeof(spBoneData) },
+        { "i p3 i4 p i2",                                   sizeof(spSlotData) },
+        { "p6 i4 | p p100",                                 sizeof(_spSkin) },
+        { "i p3",                                           sizeof(_Entry) },
+        { "p2",                                             sizeof(_SkinHashTableEntry) },
+        { "p i2 p2 i2",                                     sizeof(spEventData) },
+        { "p i3 p i2",                                      sizeof(spEvent) },
+        { "p i3 p2 i6",                                     sizeof(spIkConstraintData) },
+        { "p i3 p2 i14",                                    sizeof(spTransformConstraintData) },
+        { "p i3 p2 i9",                                     sizeof(spPathConstraintData) },
+        { "p i2 p i21",                                     sizeof(spPhysicsConstraintData) },
+        { "p i p2",                                         sizeof(spAnimation) },
+        { "i4 p",                                           sizeof(spSequence) },
+        { SIG_TIMELINE " i",                                sizeof(spInheritTimeline) },
+        { SIG_CURVE_TIMELINE " i",                          sizeof(spRotateTimeline) },
+        { SIG_TIMELINE " i p i p2",                         sizeof(spAttachmentTimeline) },
+        { SIG_CURVE_TIMELINE " i p i p",                    sizeof(spDeformTimeline) },
+        { SIG_TIMELINE " i p",                              sizeof(spSequenceTimeline) },
+        { SIG_TIMELINE " p",                                sizeof(spEventTimeline) },
+        { SIG_TIMELINE " p i",                              sizeof(spDrawOrderTimeline) },
+        { SIG_ATTACHMENT " p i7 i4 p3 i8 i8",               sizeof(spRegionAttachment) },
+        { SIG_VERTEX_ATTACHMENT " p6 i p i4 i p i p i2",    sizeof(spMeshAttachment) },
+        { SIG_VERTEX_ATTACHMENT " i4",                      sizeof(spBoundingBoxAttachment) },
+        { SIG_VERTEX_ATTACHMENT " i p i2 i4",               sizeof(spPathAttachment) },
+        { SIG_ATTACHMENT " i7",                             sizeof(spPointAttachment) },
+        { SIG_VERTEX_ATTACHMENT " p i4",                    sizeof(spClippingAttachment) },
+    };
+    DM_STATIC_ASSERT(sizeof(BLOCK_TYPES) / sizeof(BLOCK_TYPES[0]) == BLOCK_TYPE_COUNT, Invalid_block_type_count);
+
+#undef SIG_ATTACHMENT
+#undef SIG_VERTEX_ATTACHMENT
+#undef SIG_TIMELINE
+#undef SIG_CURVE_TIMELINE
+
+    // A blob can only be loaded with the same signatures as when it was written
+    static uint32_t GetFormatHash()
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261U;
+        for (uint32_t i = 0; i < BLOCK_TYPE_COUNT; ++i)
+        {
+            const char* p = BLOCK_TYPES[i].m_Signature;
+            do
+            {
+                hash = (hash ^ (uint8_t)*p) * 16777619U;
+            } while (*p++);
+        }
+        return hash;
+    }
+
+    static uint32_t Align(uint32_t offset, uint32_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    // A run of fields of the same kind, e.g. the 4 floats of a spColor
+    struct BlockField
+    {
+        char        m_Kind;
+        uint8_t     m_Size;             // Of one field on this platform
+        uint16_t    m_Count;
+        uint16_t    m_Offset;           // In the struct
+        uint16_t    m_PackedOffset;     // In the blob
+    };
+
+    static const uint32_t MAX_BLOCK_FIELDS = 32;
+
+    // The layout of a block type on this platform
+    struct BlockLayout
+    {
+        BlockField  m_Fields[MAX_BLOCK_FIELDS];
+        uint32_t    m_FieldsCount;
+        uint32_t    m_Size;
+        uint32_t    m_Alignment;
+        uint32_t    m_PackedSize;
+        bool        m_HasPointers;
+    };
+
+    struct Int64AlignmentTest
+    {
+        char        m_Char;
+        uint64_t    m_Value;
+    };
+
+    static bool GetFieldLayout(char kind, uint32_t* size, uint32_t* alignment, uint32_t* packed_size)
+    {
+        switch (kind)
+        {
+            case 'c':   *size = 1; *alignment = 1; *packed_size = 1; return true;
+            case 's':   *size = 2; *alignment = 2; *packed_size = 2; return true;
+            case 'i':   *size = 4; *alignment = 4; *packed_size = 4; return true;
+            // E.g. 4 on 32 bit Linux, but 8 on 32 bit Windows
+            case 'l':   *size = 8; *alignment = (uint32_t)offsetof(Int64AlignmentTest, m_Value); *packed_size = 8; return true;
+            case 'p':   *size = sizeof(void*); *alignment = sizeof(void*); *packed_size = 4; return true;
+            default:    return false;
+        }
+    }
+
+    // Lays out the fields of the signature the way the compiler does, and checks the result against the struct size
+    static bool GetBlockLayout(uint32_t type, BlockLayout* layout)
+    {
+        layout->m_FieldsCount = 0;
+        layout->m_Size = 0;
+        layout->m_Alignment = 1;
+        layout->m_PackedSize = 0;
+        layout->m_HasPointers = false;
+
+        const char* p = BLOCK_TYPES[type].m_Signature;
+        while (*p)
+        {
+            char kind = *p++;
+            if (kind == ' ')
+                continue;
+            if (kind == '|')
+            {
+                layout->m_Size = Align(layout->m_Size, layout->m_Alignment);
+                continue;
+            }
+
+            uint32_t count = 0;
+            while (*p >= '0' && *p <= '9')
+                count = count * 10 + (uint32_t)(*p++ - '0');
+            count = count ? count : 1;
+
+            uint32_t size, alignment, packed_size;
+            if (!GetFieldLayout(kind, &size, &alignment, &packed_size))
+                break;
+
+            uint32_t offset = Align(layout->m_Size, alignment);
+            BlockField* last = layout->m_FieldsCount ? &layout->m_Fields[layout->m_FieldsCount - 1] : 0;
+            if (last && last->m_Kind == kind && last->m_Offset + last->m_Count * size == offset)
+            {
+                last->m_Count += count;
+            }
+            else
+            {
+                if (layout->m_FieldsCount == MAX_BLOCK_FIELDS)
+                    break;
+                BlockField& field = layout->m_Fields[layout->m_FieldsCount++];
+                field.m_Kind = kind;
+                field.m_Size = (uint8_t)size;
+                field.m_Count = (uint16_t)count;
+                field.m_Offset = (uint16_t)offset;
+                field.m_PackedOffset = (uint16_t)layout->m_PackedSize;
+            }
+            layout->m_Size = offset + count * size;
+            layout->m_Alignment = dmMath::Max(layout->m_Alignment, alignment);
+            layout->m_PackedSize += count * packed_size;
+            layout->m_HasPointers |= kind == 'p';
+        }
+        layout->m_Size = Align(layout->m_Size, layout->m_Alignment);
+
+        if (*p || layout->m_Size != BLOCK_TYPES[type].m_Size)
+        {
+            dmLogError("The signature of the precompiled skeleton block type %u doesn't match the struct (size %u, expected %u)",
+                        type, layout->m_Size, BLOCK_TYPES[type].m_Size);
+            return false;
+        }
+        return true;
+    }
+
+    // Returns an array of BLOCK_TYPE_COUNT layouts, allocated with malloc(), or 0 if a signature doesn't match its struct
+    static BlockLayout* GetBlockLayouts()
+    {
+        BlockLayout* layouts = (BlockLayout*)malloc(sizeof(BlockLayout) * BLOCK_TYPE_COUNT);
+        for (uint32_t i = 0; i < BLOCK_TYPE_COUNT; ++i)
+        {
+            if (!GetBlockLayout(i, &layouts[i]))
+            {
+                free(layouts);
+                return 0;
+            }
+        }
+        return layouts;
+    }
+
+    static bool IsCurveTimeline(spTimelineType type)
+    {
+        switch (type)
+        {
+            case SP_TIMELINE_ATTACHMENT:
+            case SP_TIMELINE_SEQUENCE:
+            case SP_TIMELINE_EVENT:
+            case SP_TIMELINE_DRAWORDER:
+            case SP_TIMELINE_INHERIT:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_RESET:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    static BlockType GetTimelineBlockType(spTimelineType type)
+    {
+        switch (type)
+        {
+            case SP_TIMELINE_ATTACHMENT:                return BLOCK_ATTACHMENT_TIMELINE;
+            case SP_TIMELINE_DEFORM:                    return BLOCK_DEFORM_TIMELINE;
+            case SP_TIMELINE_SEQUENCE:                  return BLOCK_SEQUENCE_TIMELINE;
+            case SP_TIMELINE_EVENT:                     return BLOCK_EVENT_TIMELINE;
+            case SP_TIMELINE_DRAWORDER:                 return BLOCK_DRAW_ORDER_TIMELINE;
+            case SP_TIMELINE_INHERIT:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_RESET:   return BLOCK_INDEX_TIMELINE;
+            // The other timelines only add an index (of a bone, slot or constraint) to the curve timeline
+            default:                                    return BLOCK_CURVE_INDEX_TIMELINE;
+        }
+    }
+
+    static bool IsTimelineBlockType(uint32_t type)
+    {
+        return type >= BLOCK_INDEX_TIMELINE && type <= BLOCK_DRAW_ORDER_TIMELINE;
+    }
+
+    // Returns BLOCK_TYPE_COUNT for an unknown attachment type
+    static BlockType GetAttachmentBlockType(spAttachmentType type)
+    {
+        switch (type)
+        {
+            case SP_ATTACHMENT_REGION:          return BLOCK_REGION_ATTACHMENT;
+            case SP_ATTACHMENT_BOUNDING_BOX:    return BLOCK_BOUNDING_BOX_ATTACHMENT;
+            case SP_ATTACHMENT_MESH:
+            case SP_ATTACHMENT_LINKED_MESH:     return BLOCK_MESH_ATTACHMENT;
+            case SP_ATTACHMENT_PATH:            return BLOCK_PATH_ATTACHMENT;
+            case SP_ATTACHMENT_POINT:           return BLOCK_POINT_ATTACHMENT;
+            case SP_ATTACHMENT_CLIPPING:        return BLOCK_CLIPPING_ATTACHMENT;
+            default:                            return BLOCK_TYPE_COUNT;
+        }
+    }
+
+    static bool IsAttachmentBlockType(uint32_t type)
+    {
+        return type >= BLOCK_REGION_ATTACHMENT && type <= BLOCK_CLIPPING_ATTACHMENT;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Writing
+
+    struct BlobBlock
+    {
+        const void* m_Source;
+        uint32_t    m_Type;
+        uint32_t    m_Count;
+    };
+
+    struct BlobWriter
+    {
+        dmArray<BlobBlock>      m_Blocks;
+        dmHashTable64<uint32_t> m_BlockIndices;     // The source address to the index in m_Blocks
+        dmHashTable64<uint32_t> m_Cleared;          // The addresses of the pointers that are written as null, e.g. to the atlas regions, which are bound when loading
+        const char*             m_Error;
+    };
+
+    template <typename T>
+    static void PushGrow(dmArray<T>& array, const T& value)
+    {
+        if (array.Full())
+            array.OffsetCapacity(dmMath::Max(array.Capacity(), 64U));
+        array.Push(value);
+    }
+
+    static void PutGrow(dmHashTable64<uint32_t>& table, const void* key, uint32_t value)
+    {
+        if (table.Full())
+        {
+            uint32_t capacity = table.Capacity() + 1024;
+            table.SetCapacity(capacity/2+1, capacity);
+        }
+        table.Put((uintptr_t)key, value);
+    }
+
+    // Returns true the first time the block is added, i.e. when its contents need to be visited
+    static bool AddBlock(BlobWriter* writer, const void* source, BlockType type, uint32_t count)
+    {
+        uint32_t* index = writer->m_BlockIndices.Get((uintptr_t)source);
+        if (index)
+        {
+            BlobBlock& block = writer->m_Blocks[*index];
+            if (block.m_Type != (uint32_t)type)
+                writer->m_Error = "An object is used as two different types";
+            block.m_Count = dmMath::Max(block.m_Count, count);
+            return false;
+        }
+
+        PutGrow(writer->m_BlockIndices, source, writer->m_Blocks.Size());
+
+        BlobBlock block;
+        block.m_Source = source;
+        block.m_Type = type;
+        block.m_Count = count;
+        PushGrow(writer->m_Blocks, block);
+        return true;
+    }
+
+    // The pointers in the range are written as null
+    static void ClearField(BlobWriter* writer, const void* field, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size / sizeof(void*); ++i)
+        {
+            PutGrow(writer->m_Cleared, (const void* const*)field + i, 1);
+        }
+    }
+
+    static void WriteString(BlobWriter* writer, const char* string)
+    {
+        if (string)
+            AddBlock(writer, string, BLOCK_CHARS, (uint32_t)strlen(string) + 1);
+    }
+
+    static BlockType GetValueType(const float*)             { return BLOCK_INT32; }
+    static BlockType GetValueType(const int*)               { return BLOCK_INT32; }
+    static BlockType GetValueType(const unsigned short*)    { return BLOCK_UINT16; }
+    static BlockType GetValueType(const spPropertyId*)      { return BLOCK_INT64; }
+    template <typename T>
+    static BlockType GetValueType(T* const*)                { return BLOCK_POINTERS; }
+
+    // A plain array, e.g. of floats
+    template <typename T>
+    static void WriteValues(BlobWriter* writer, T* values, int count)
+    {
+        if (values)
+            AddBlock(writer, values, GetValueType(values), (uint32_t)count);
+    }
+
+    // An array of pointers to other blocks. Returns the items the first time, so that the caller can visit them
+    template <typename T>
+    static T** WritePointers(BlobWriter* writer, T** items, int count)
+    {
+        if (!items || !AddBlock(writer, items, BLOCK_POINTERS, (uint32_t)count))
+            return 0;
+        return items;
+    }
+
+    static void WriteStrings(BlobWriter* writer, char** strings, int count)
+    {
+        if (!WritePointers(writer, strings, count))
+            return;
+        for (int i = 0; i < count; ++i)
+        {
+            WriteString(writer, strings[i]);
+        }
+    }
+
+    // The spine arrays, e.g. spFloatArray. Only the used items are stored
+    template <typename ArrayType>
+    static ArrayType* WriteSpineArray(BlobWriter* writer, ArrayType* array)
+    {
+        if (!array || !AddBlock(writer, array, BLOCK_SPINE_ARRAY, 1))
+            return 0;
+        WriteValues(writer, array->items, array->size);
+        return array;
+    }
+
+    static void WriteAttachment(BlobWriter* writer, spAttachment* attachment);
+
+    static void WriteSequence(BlobWriter* writer, spSequence* sequence)
+    {
+        if (!sequence || !AddBlock(writer, sequence, BLOCK_SEQUENCE, 1))
+            return;
+        spTextureRegionArray* regions = WriteSpineArray(writer, sequence->regions);
+        // The regions are bound when loading
+        if (regions && regions->items)
+            ClearField(writer, regions->items, regions->size * sizeof(spTextureRegion*));
+    }
+
+    static void WriteVertexAttachment(BlobWriter* writer, spVertexAttachment* attachment)
+    {
+        WriteValues(writer, attachment->bones, attachment->bonesCount);
+        WriteValues(writer, attachment->vertices, attachment->verticesCount);
+        if (attachment->timelineAttachment)
+            WriteAttachment(writer, attachment->timelineAttachment);
+    }
+
+    static void WriteAttachment(BlobWriter* writer, spAttachment* attachment)
+    {
+        BlockType type = GetAttachmentBlockType(attachment->type);
+        if (type == BLOCK_TYPE_COUNT)
+        {
+            writer->m_Error = "Unknown attachment type";
+            return;
+        }
+        if (!AddBlock(writer, attachment, type, 1))
+            return;
+
+        WriteString(writer, attachment->name);
+        // Restored when loading
+        ClearField(writer, &attachment->vtable, sizeof(attachment->vtable));
+        ClearField(writer, &attachment->attachmentLoader, sizeof(attachment->attachmentLoader));
+
+        switch (attachment->type)
+        {
+            case SP_ATTACHMENT_REGION: {
+                spRegionAttachment* region = (spRegionAttachment*)attachment;
+                WriteString(writer, region->path);
+                ClearField(writer, &region->rendererObject, sizeof(region->rendererObject));
+                ClearField(writer, &region->region, sizeof(region->region));
+                WriteSequence(writer, region->sequence);
+                break;
+            }
+            case SP_ATTACHMENT_MESH:
+            case SP_ATTACHMENT_LINKED_MESH: {
+                spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+                WriteVertexAttachment(writer, SUPER(mesh));
+                ClearField(writer, &mesh->rendererObject, sizeof(mesh->rendererObject));
+                ClearField(writer, &mesh->region, sizeof(mesh->region));
+                // Allocated by spMeshAttachment_updateRegion() when the region is bound
+                ClearField(writer, &mesh->uvs, sizeof(mesh->uvs));
+                WriteSequence(writer, mesh->sequence);
+                WriteString(writer, mesh->path);
+                // A linked mesh shares these with its parent
+                WriteValues(writer, mesh->regionUVs, SUPER(mesh)->worldVerticesLength);
+                WriteValues(writer, mesh->triangles, mesh->trianglesCount);
+                WriteValues(writer, mesh->edges, mesh->edgesCount);
+                if (mesh->parentMesh)
+                    WriteAttachment(writer, SUPER(SUPER(mesh->parentMesh)));
+                break;
+            }
+            case SP_ATTACHMENT_BOUNDING_BOX:
+                WriteVertexAttachment(writer, (spVertexAttachment*)attachment);
+                break;
+            case SP_ATTACHMENT_PATH: {
+                spPathAttachment* path = (spPathAttachment*)attachment;
+                WriteVertexAttachment(writer, SUPER(path));
+                WriteValues(writer, path->lengths, path->lengthsLength);
+                break;
+            }
+            case SP_ATTACHMENT_CLIPPING: {
+                spClippingAttachment* clipping = (spClippingAttachment*)attachment;
+                WriteVertexAttachment(writer, SUPER(clipping));
+                // The end slot is written with the slots
+                break;
+            }
+            case SP_ATTACHMENT_POINT:
+                break;
+        }
+    }
+
+    static void WriteTimeline(BlobWriter* writer, spTimeline* timeline)
+    {
+        if (!AddBlock(writer, timeline, GetTimelineBlockType(timeline->type), 1))
+            return;
+
+        ClearField(writer, &timeline->vtable, sizeof(timeline->vtable));
+        WriteSpineArray(writer, timeline->frames);
+        if (IsCurveTimeline(timeline->type))
+        {
+            WriteSpineArray(writer, ((spCurveTimeline*)timeline)->curves);
+        }
+
+        int frame_count = timeline->frameCount;
+        switch (timeline->type)
+        {
+            case SP_TIMELINE_ATTACHMENT: {
+                spAttachmentTimeline* t = (spAttachmentTimeline*)timeline;
+                WriteStrings(writer, t->attachmentNames, frame_count);
+                // See spAttachmentTimeline_resolve()
+                WritePointers(writer, t->resolvedSkins, t->resolvedSkinsCount);
+                int count = t->resolvedSkinsCount * (t->super.frames->size + 1);
+                spAttachment** attachments = WritePointers(writer, t->resolvedAttachments, count);
+                for (int i = 0; attachments && i < count; ++i)
+                {
+                    if (attachments[i])
+                        WriteAttachment(writer, attachments[i]);
+                }
+                break;
+            }
+            case SP_TIMELINE_DEFORM: {
+                spDeformTimeline* t = (spDeformTimeline*)timeline;
+                float** frame_vertices = WritePointers(writer, t->frameVertices, frame_count);
+                for (int i = 0; frame_vertices && i < frame_count; ++i)
+                {
+                    WriteValues(writer, frame_vertices[i], t->frameVerticesCount);
+                }
+                if (t->attachment)
+                    WriteAttachment(writer, t->attachment);
+                break;
+            }
+            case SP_TIMELINE_SEQUENCE: {
+                spSequenceTimeline* t = (spSequenceTimeline*)timeline;
+                if (t->attachment)
+                    WriteAttachment(writer, t->attachment);
+                break;
+            }
+            case SP_TIMELINE_EVENT: {
+                spEventTimeline* t = (spEventTimeline*)timeline;
+                spEvent** events = WritePointers(writer, t->events, frame_count);
+                for (int i = 0; events && i < frame_count; ++i)
+                {
+                    spEvent* event = events[i];
+                    // The event data is written with the skeleton data events
+                    if (event && AddBlock(writer, event, BLOCK_EVENT, 1))
+                        WriteString(writer, event->stringValue);
+                }
+                break;
+            }
+            case SP_TIMELINE_DRAWORDER: {
+                spDrawOrderTimeline* t = (spDrawOrderTimeline*)timeline;
+                int** draw_orders = WritePointers(writer, t->drawOrders, frame_count);
+                for (int i = 0; draw_orders && i < frame_count; ++i)
+                {
+                    WriteValues(writer, draw_orders[i], t->slotsCount);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    static void WriteAnimation(BlobWriter* writer, spAnimation* animation)
+    {
+        if (!AddBlock(writer, animation, BLOCK_ANIMATION, 1))
+            return;
+        WriteString(writer, animation->name);
+
+        spTimelineArray* timelines = WriteSpineArray(writer, animation->timelines);
+        for (int i = 0; timelines && i < timelines->size; ++i)
+        {
+            WriteTimeline(writer, timelines->items[i]);
+        }
+        WriteSpineArray(writer, animation->timelineIds);
+    }
+
+    static void WriteSkin(BlobWriter* writer, spSkin* skin)
+    {
+        if (!AddBlock(writer, skin, BLOCK_SKIN, 1))
+            return;
+        WriteString(writer, skin->name);
+        WriteSpineArray(writer, skin->bones);
+        WriteSpineArray(writer, skin->ikConstraints);
+        WriteSpineArray(writer, skin->transformConstraints);
+        WriteSpineArray(writer, skin->pathConstraints);
+        WriteSpineArray(writer, skin->physicsConstraints);
+
+        _spSkin* internal = (_spSkin*)skin;
+        for (_Entry* entry = internal->entries; entry; entry = entry->next)
+        {
+            if (!AddBlock(writer, entry, BLOCK_SKIN_ENTRY, 1))
+                break;
+            WriteString(writer, entry->name);
+            if (entry->attachment)
+                WriteAttachment(writer, entry->attachment);
+        }
+
+        for (int i = 0; i < SKIN_ENTRIES_HASH_TABLE_SIZE; ++i)
+        {
+            for (_SkinHashTableEntry* hash_entry = internal->entriesHashTable[i]; hash_entry; hash_entry = hash_entry->next)
+            {
+                // The entry is also in the entries list
+                if (!AddBlock(writer, hash_entry, BLOCK_SKIN_HASH_TABLE_ENTRY, 1))
+                    break;
+            }
+        }
+    }
+
+    static void WriteSkeletonData(BlobWriter* writer, spSkeletonData* data)
+    {
+        AddBlock(writer, data, BLOCK_SKELETON_DATA, 1);
+        ClearField(writer, &data->arena, sizeof(data->arena)); // The loaded blob is the arena
+        WriteString(writer, data->version);
+        WriteString(writer, data->hash);
+        WriteString(writer, data->imagesPath);
+        WriteString(writer, data->audioPath);
+
+        WriteStrings(writer, data->strings, data->stringsCount);
+
+        spBoneData** bones = WritePointers(writer, data->bones, data->bonesCount);
+        for (int i = 0; bones && i < data->bonesCount; ++i)
+        {
+            spBoneData* bone = bones[i];
+            if (!AddBlock(writer, bone, BLOCK_BONE_DATA, 1))
+                continue;
+            WriteString(writer, bone->name);
+            WriteString(writer, bone->icon);
+        }
+
+        spSlotData** slots = WritePointers(writer, data->slots, data->slotsCount);
+        for (int i = 0; slots && i < data->slotsCount; ++i)
+        {
+            spSlotData* slot = slots[i];
+            if (!AddBlock(writer, slot, BLOCK_SLOT_DATA, 1))
+                continue;
+            WriteString(writer, slot->name);
+            WriteString(writer, slot->attachmentName);
+            if (slot->darkColor)
+                AddBlock(writer, slot->darkColor, BLOCK_INT32, sizeof(spColor) / sizeof(float));
+        }
+
+        spSkin** skins = WritePointers(writer, data->skins, data->skinsCount);
+        for (int i = 0; skins && i < data->skinsCount; ++i)
+        {
+            WriteSkin(writer, skins[i]);
+        }
+        if (data->defaultSkin)
+            WriteSkin(writer, data->defaultSkin);
+
+        spEventData** events = WritePointers(writer, data->events, data->eventsCount);
+        for (int i = 0; events && i < data->eventsCount; ++i)
+        {
+            spEventData* event = events[i];
+            if (!AddBlock(writer, event, BLOCK_EVENT_DATA, 1))
+                continue;
+            WriteString(writer, event->name);
+            WriteString(writer, event->stringValue);
+            WriteString(writer, event->audioPath);
+        }
+
+        spIkConstraintData** ik_constraints = WritePointers(writer, data->ikConstraints, data->ikConstraintsCount);
+        for (int i = 0; ik_constraints && i < data->ikConstraintsCount; ++i)
+        {
+            spIkConstraintData* constraint = ik_constraints[i];
+            if (!AddBlock(writer, constraint, BLOCK_IK_CONSTRAINT_DATA, 1))
+                continue;
+            WriteString(writer, constraint->name);
+            WritePointers(writer, constraint->bones, constraint->bonesCount);
+        }
+
+        spTransformConstraintData** transform_constraints = WritePointers(writer, data->transformConstraints, data->transformConstraintsCount);
+        for (int i = 0; transform_constraints && i < data->transformConstraintsCount; ++i)
+        {
+            spTransformConstraintData* constraint = transform_constraints[i];
+            if (!AddBlock(writer, constraint, BLOCK_TRANSFORM_CONSTRAINT_DATA, 1))
+                continue;
+            WriteString(writer, constraint->name);
+            WritePointers(writer, constraint->bones, constraint->bonesCount);
+        }
+
+        spPathConstraintData** path_constraints = WritePointers(writer, data->pathConstraints, data->pathConstraintsCount);
+        for (int i = 0; path_constraints && i < data->pathConstraintsCount; ++i)
+        {
+            spPathConstraintData* constraint = path_constraints[i];
+            if (!AddBlock(writer, constraint, BLOCK_PATH_CONSTRAINT_DATA, 1))
+                continue;
+            WriteString(writer, constraint->name);
+            WritePointers(writer, constraint->bones, constraint->bonesCount);
+        }
+
+        spPhysicsConstraintData** physics_constraints = WritePointers(writer, data->physicsConstraints, data->physicsConstraintsCount);
+        for (int i = 0; physics_constraints && i < data->physicsConstraintsCount; ++i)
+        {
+            spPhysicsConstraintData* constraint = physics_constraints[i];
+            if (AddBlock(writer, constraint, BLOCK_PHYSICS_CONSTRAINT_DATA, 1))
+                WriteString(writer, constraint->name);
+        }
+
+        // The animations last, since they're only needed when playing them
+        spAnimation** animations = WritePointers(writer, data->animations, data->animationsCount);
+        for (int i = 0; animations && i < data->animationsCount; ++i)
+        {
+            WriteAnimation(writer, animations[i]);
+        }
+    }
+
+    // Packs the fields of each item of the block, in the order of the signature
+    static void PackBlock(BlobWriter* writer, const BlockLayout& layout, const BlobBlock& block, uint8_t* out)
+    {
+        if (!layout.m_HasPointers && layout.m_Size == layout.m_PackedSize)
+        {
+            memcpy(out, block.m_Source, block.m_Count * layout.m_Size);
+            return;
+        }
+
+        for (uint32_t item = 0; item < block.m_Count; ++item)
+        {
+            const uint8_t* source = (const uint8_t*)block.m_Source + item * layout.m_Size;
+            uint8_t* packed = out + item * layout.m_PackedSize;
+            for (uint32_t i = 0; i < layout.m_FieldsCount; ++i)
+            {
+                const BlockField& field = layout.m_Fields[i];
+                if (field.m_Kind != 'p')
+                {
+                    memcpy(packed + field.m_PackedOffset, source + field.m_Offset, field.m_Count * field.m_Size);
+                    continue;
+                }
+
+                const void* const* pointers = (const void* const*)(source + field.m_Offset);
+                for (uint32_t j = 0; j < field.m_Count; ++j)
+                {
+                    uint32_t index = 0;
+                    if (pointers[j] && !writer->m_Cleared.Get((uintptr_t)&pointers[j]))
+                    {
+                        uint32_t* block_index = writer->m_BlockIndices.Get((uintptr_t)pointers[j]);
+                        if (!block_index)
+                        {
+                            writer->m_Error = "A pointer doesn't point to the start of an object";
+                            return;
+                        }
+                        index = *block_index + 1;
+                    }
+                    memcpy(packed + field.m_PackedOffset + j * sizeof(uint32_t), &index, sizeof(index));
+                }
+            }
+        }
+
+        // Only the used items are stored
+        if (block.m_Type == BLOCK_SPINE_ARRAY)
+        {
+            DM_STATIC_ASSERT(offsetof(spFloatArray, capacity) == offsetof(spFloatArray, size) + sizeof(int), Invalid_array_layout);
+            memcpy(out + sizeof(int), out, sizeof(int));
+        }
+    }
+
+    void* WriteSkeletonBlob(spSkeletonData* skeleton_data, uint32_t* out_size)
+    {
+        BlockLayout* layouts = GetBlockLayouts();
+        if (!layouts)
+            return 0;
+
+        BlobWriter writer;
+        writer.m_Error = 0;
+        writer.m_BlockIndices.SetCapacity(1024/2+1, 1024);
+        writer.m_Cleared.SetCapacity(1024/2+1, 1024);
+        WriteSkeletonData(&writer, skeleton_data);
+
+        uint32_t blocks_count = writer.m_Blocks.Size();
+        uint64_t size = sizeof(SkeletonBlobHeader) + blocks_count * sizeof(SkeletonBlobBlock);
+        for (uint32_t i = 0; i < blocks_count; ++i)
+        {
+            const BlobBlock& block = writer.m_Blocks[i];
+            size += (uint64_t)block.m_Count * layouts[block.m_Type].m_PackedSize;
+        }
+        if (!writer.m_Error && size > 0x7fffffff)
+            writer.m_Error = "The skeleton data is too large";
+
+        uint8_t* blob = 0;
+        if (!writer.m_Error)
+        {
+            blob = (uint8_t*)calloc(1, (size_t)size);
+
+            SkeletonBlobHeader header;
+            memset(&header, 0, sizeof(header));
+            header.m_Magic = SKELETON_BLOB_MAGIC;
+            header.m_Version = SKELETON_BLOB_VERSION;
+            header.m_FormatHash = GetFormatHash();
+            header.m_Size = (uint32_t)size;
+            header.m_BlocksCount = blocks_count;
+            memcpy(blob, &header, sizeof(header));
+
+            SkeletonBlobBlock* table = (SkeletonBlobBlock*)(blob + sizeof(SkeletonBlobHeader));
+            uint8_t* out = (uint8_t*)(table + blocks_count);
+            for (uint32_t i = 0; i < blocks_count && !writer.m_Error; ++i)
+            {
+                const BlobBlock& block = writer.m_Blocks[i];
+                table[i].m_Type = block.m_Type;
+                table[i].m_Count = block.m_Count;
+                PackBlock(&writer, layouts[block.m_Type], block, out);
+                out += block.m_Count * layouts[block.m_Type].m_PackedSize;
+            }
+        }
+        free(layouts);
+
+        if (writer.m_Error)
+        {
+            dmLogError("Failed to write the precompiled skeleton: %s", writer.m_Error);
+            free(blob);
+            return 0;
+        }
+        *out_size = (uint32_t)size;
+        return blob;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Loading
+
+    // The skeleton data and all its objects are allocated in one block, after this
+    struct LoadedSkeletonBlob
+    {
+        spAttachment**  m_Attachments;      // In the same block, after the objects
+        uint32_t        m_AttachmentsCount;
+    };
+
+    static const uint32_t LOADED_SKELETON_BLOB_SIZE = (sizeof(LoadedSkeletonBlob) + SKELETON_BLOB_ALIGNMENT - 1) & ~(SKELETON_BLOB_ALIGNMENT - 1);
+
+    bool IsSkeletonBlob(const void* data, uint32_t data_size)
+    {
+        uint32_t magic;
+        if (!data || data_size < sizeof(SkeletonBlobHeader))
+            return false;
+        memcpy(&magic, data, sizeof(magic));
+        return magic == SKELETON_BLOB_MAGIC;
+    }
+
+    bool IsSkeletonBlobCompatible(const void* data, uint32_t data_size)
+    {
+        SkeletonBlobHeader header;
+        if (!IsSkeletonBlob(data, data_size))
+            return false;
+        memcpy(&header, data, sizeof(header));
+        if (header.m_Version != SKELETON_BLOB_VERSION || header.m_FormatHash != GetFormatHash())
+            return false;
+
+        BlockLayout layout;
+        for (uint32_t i = 0; i < BLOCK_TYPE_COUNT; ++i)
+        {
+            if (!GetBlockLayout(i, &layout))
+                return false;
+        }
+        return true;
+    }
+
+    // Expands the packed fields of each item of the block to the struct layout of this platform
+    static bool UnpackBlock(const BlockLayout& layout, const SkeletonBlobBlock& block, const uint8_t* packed_block, uint8_t* out,
+                            uint8_t* const* blocks, uint32_t blocks_count)
+    {
+        if (!layout.m_HasPointers && layout.m_Size == layout.m_PackedSize)
+        {
+            memcpy(out, packed_block, block.m_Count * layout.m_Size);
+            return true;
+        }
+
+        for (uint32_t item = 0; item < block.m_Count; ++item)
+        {
+            const uint8_t* packed = packed_block + item * layout.m_PackedSize;
+            uint8_t* target = out + item * layout.m_Size;
+            for (uint32_t i = 0; i < layout.m_FieldsCount; ++i)
+            {
+                const BlockField& field = layout.m_Fields[i];
+                if (field.m_Kind != 'p')
+                {
+                    memcpy(target + field.m_Offset, packed + field.m_PackedOffset, field.m_Count * field.m_Size);
+                    continue;
+                }
+
+                void** pointers = (void**)(target + field.m_Offset);
+                for (uint32_t j = 0; j < field.m_Count; ++j)
+                {
+                    uint32_t index;
+                    memcpy(&index, packed + field.m_PackedOffset + j * sizeof(uint32_t), sizeof(index));
+                    if (index > blocks_count)
+                        return false;
+                    pointers[j] = index ? blocks[index - 1] : 0;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Returns an error message, or 0
+    static const char* ExpandBlocks(const SkeletonBlobHeader& header, const uint8_t* data, const BlockLayout* layouts, uint8_t** blocks, LoadedSkeletonBlob** out)
+    {
+        const uint32_t blocks_count = header.m_BlocksCount;
+        const SkeletonBlobBlock* table = (const SkeletonBlobBlock*)(data + sizeof(SkeletonBlobHeader));
+        const uint64_t packed_start = sizeof(SkeletonBlobHeader) + (uint64_t)blocks_count * sizeof(SkeletonBlobBlock);
+        if (blocks_count == 0 || packed_start > header.m_Size || table[0].m_Type != BLOCK_SKELETON_DATA || table[0].m_Count != 1)
+            return "invalid header";
+
+        // Lay out the objects, and check that the packed fields are within the blob
+        uint64_t packed_size = packed_start;
+        uint64_t size = LOADED_SKELETON_BLOB_SIZE;
+        uint32_t attachments_count = 0;
+        for (uint32_t i = 0; i < blocks_count; ++i)
+        {
+            const SkeletonBlobBlock& block = table[i];
+            if (block.m_Type >= BLOCK_TYPE_COUNT)
+                return "invalid block type";
+            const BlockLayout& layout = layouts[block.m_Type];
+            packed_size += (uint64_t)block.m_Count * layout.m_PackedSize;
+            if (packed_size > header.m_Size)
+                return "invalid block size";
+            blocks[i] = (uint8_t*)(uintptr_t)size;
+            // An empty block (e.g. the items of an empty array) also gets an address of its own, like when it was written
+            uint64_t block_size = dmMath::Max((uint64_t)block.m_Count * layout.m_Size, (uint64_t)1);
+            size += (block_size + SKELETON_BLOB_ALIGNMENT - 1) & ~(uint64_t)(SKELETON_BLOB_ALIGNMENT - 1);
+            attachments_count += IsAttachmentBlockType(block.m_Type) ? block.m_Count : 0;
+        }
+        uint64_t attachments_offset = size;
+        size += attachments_count * sizeof(spAttachment*);
+        if (size > 0x7fffffff)
+            return "invalid block size";
+
+        uint8_t* base = (uint8_t*)calloc(1, (size_t)size);
+        for (uint32_t i = 0; i < blocks_count; ++i)
+        {
+            blocks[i] = base + (uintptr_t)blocks[i];
+        }
+        LoadedSkeletonBlob* loaded = (LoadedSkeletonBlob*)base;
+        loaded->m_Attachments = (spAttachment**)(base + attachments_offset);
+        loaded->m_AttachmentsCount = 0;
+        *out = loaded;
+
+        const uint8_t* packed = data + packed_start;
+        for (uint32_t i = 0; i < blocks_count; ++i)
+        {
+            const SkeletonBlobBlock& block = table[i];
+            const BlockLayout& layout = layouts[block.m_Type];
+            if (!UnpackBlock(layout, block, packed, blocks[i], blocks, blocks_count))
+                return "invalid pointer";
+            packed += block.m_Count * layout.m_PackedSize;
+        }
+
+        for (uint32_t i = 0; i < blocks_count; ++i)
+        {
+            const SkeletonBlobBlock& block = table[i];
+            const BlockLayout& layout = layouts[block.m_Type];
+            for (uint32_t item = 0; item < block.m_Count; ++item)
+            {
+                uint8_t* object = blocks[i] + item * layout.m_Size;
+                if (IsTimelineBlockType(block.m_Type))
+                {
+                    spTimeline* timeline = (spTimeline*)object;
+                    if (GetTimelineBlockType(timeline->type) != block.m_Type)
+                        return "invalid timeline";
+                    _spTimeline_initVtable(timeline);
+                }
+                else if (IsAttachmentBlockType(block.m_Type))
+                {
+                    spAttachment* attachment = (spAttachment*)object;
+                    if (GetAttachmentBlockType(attachment->type) != block.m_Type)
+                        return "invalid attachment";
+                    _spAttachment_initStaticVtable(attachment);
+                    loaded->m_Attachments[loaded->m_AttachmentsCount++] = attachment;
+                }
+            }
+        }
+        return 0;
+    }
+
+    spSkeletonData* LoadSkeletonBlob(spDefoldAtlasAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size)
+    {
+        spAttachmentLoader* attachment_loader = SUPER(loader);
+
+        SkeletonBlobHeader header;
+        if (!IsSkeletonBlob(data, data_size))
+        {
+            _spAttachmentLoader_setError(attachment_loader, "Not a precompiled skeleton: ", path);
+            return 0;
+        }
+        memcpy(&header, data, sizeof(header));
+
+        if (!IsSkeletonBlobCompatible(data, data_size))
+        {
+            _spAttachmentLoader_setError(attachment_loader, "The precompiled skeleton was built with another version: ", path);
+            dmLogError("Failed to load precompiled skeleton for %s (version %u, format %08x)", path, header.m_Version, header.m_FormatHash);
+            return 0;
+        }
+
+        BlockLayout* layouts = GetBlockLayouts();
+        if (!layouts)
+            return 0;
+
+        const char* error = 0;
+        LoadedSkeletonBlob* loaded = 0;
+        uint8_t** blocks = 0;
+        if (header.m_Size > data_size || header.m_BlocksCount > (header.m_Size - sizeof(SkeletonBlobHeader)) / sizeof(SkeletonBlobBlock))
+        {
+            error = "invalid header";
+        }
+        else
+        {
+            blocks = (uint8_t**)malloc(dmMath::Max(header.m_BlocksCount, 1U) * sizeof(uint8_t*));
+            error = ExpandBlocks(header, (const uint8_t*)data, layouts, blocks, &loaded);
+        }
+        spSkeletonData* skeleton_data = loaded ? (spSkeletonData*)blocks[0] : 0;
+        free(blocks);
+        free(layouts);
+
+        if (error)
+        {
+            _spAttachmentLoader_setError(attachment_loader, "Invalid precompiled skeleton: ", path);
+            dmLogError("Failed to load precompiled skeleton for %s: %s", path, error);
+            free(loaded);
+            return 0;
+        }
+
+        // The atlas regions are bound after all the vtables are set, since linked meshes share data with their parents
+        for (uint32_t i = 0; i < loaded->m_AttachmentsCount; ++i)
+        {
+            if (!BindAttachmentRegion(loader, loaded->m_Attachments[i]))
+            {
+                dmLogError("Failed to load precompiled skeleton for %s: %s%s", path,
+                            attachment_loader->error1 ? attachment_loader->error1 : "",
+                            attachment_loader->error2 ? attachment_loader->error2 : "");
+                DisposeSkeletonBlob(skeleton_data);
+                return 0;
+            }
+        }
+
+        return skeleton_data;
+    }
+
+    void DisposeSkeletonBlob(spSkeletonData* skeleton_data)
+    {
+        if (!skeleton_data)
+            return;
+        LoadedSkeletonBlob* loaded = (LoadedSkeletonBlob*)((uint8_t*)skeleton_data - LOADED_SKELETON_BLOB_SIZE);
+        for (uint32_t i = 0; i < loaded->m_AttachmentsCount; ++i)
+        {
+            spAttachment* attachment = loaded->m_Attachments[i];
+            if (attachment->type == SP_ATTACHMENT_MESH || attachment->type == SP_ATTACHMENT_LINKED_MESH)
+            {
+                spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+                FREE(mesh->uvs);
+                mesh->uvs = 0;
+            }
+        }
+        free(loaded);
+    }
+}
@@ -0,0 +1,54 @@
+#include <common/skeleton_snapshot.h>
+
+#include <spine/Bone.h>
+#include <spine/Skeleton.h>
+#include <spine/Slot.h>
+#include <spine/extension.h>
+
+#include <string.h>
+
+namespace dmSpine
+{
+    static void CopySlotPose(spSlot* dst, const spSlot* src)
+    {
+        dst->attachment = src->attachment;
+        dst->sequenceIndex = src->sequenceIndex;
+        dst->color = src->color;
+        if (dst->darkColor && src->darkColor)
+            *dst->darkColor = *src->darkColor;
+
+        if (dst->deformCapacity < src->deformCount)
+        {
+            FREE(dst->deform);
+            dst->deform = MALLOC(float, src->deformCount);
+            dst->deformCapacity = src->deformCount;
+        }
+        dst->deformCount = src->deformCount;
+        if (src->deformCount > 0)
+            memcpy(dst->deform, src->deform, sizeof(float) * src->deformCount);
+    }
+
+    void CopySkeletonPose(spSkeleton* snapshot, const spSkeleton* skeleton)
+    {
+        snapshot->color = skeleton->color;
+
+        for (int i = 0; i < skeleton->bonesCount; ++i)
+        {
+            spBone* dst = snapshot->bones[i];
+            const spBone* src = skeleton->bones[i];
+            dst->a      = src->a;
+            dst->b      = src->b;
+            dst->c      = src->c;
+            dst->d      = src->d;
+            dst->worldX = src->worldX;
+            dst->worldY = src->worldY;
+            dst->active = src->active;
+        }
+
+        for (int i = 0; i < skeleton->slotsCount; ++i)
+        {
+            CopySlotPose(snapshot->slots[i], skeleton->slots[i]);
+            snapshot->drawOrder[i] = snapshot->slots[skeleton->drawOrder[i]->data->index];
+        }
+    }
+}
@@ -30,6 +30,8 @@
 #include <limits.h>
 #include <spine/Animation.h>
 #include <spine/IkConstraint.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
 #include <spine/extension.h>
 
 _SP_ARRAY_IMPLEMENT_TYPE(spPropertyIdArray, spPropertyId)
@@ -89,33 +91,54 @@ void spAnimation_apply(const spAnimation *self, spSkeleton *skeleton, float last
 						 direction);
 }
 
-static int search(spFloatArray
-						  *values,
-				  float time) {
-	int i, n;
-	float *items = values->items;
-	for (
-			i = 1, n = values->size;
-			i < n;
-			i++)
-		if (items[i] > time) return i - 1;
-	return values->size - 1;
-}
-
-static int search2(spFloatArray
-						   *values,
-				   float time,
-				   int step) {
-	int i, n;
+/* Frame arrays up to this many frames are searched linearly. */
+#define SEARCH_LINEAR_MAX_FRAMES 16
+
+/* The frame (i.e. index / step) found by the last search, see _spTimeline_setFrameHint. */
+static _SP_THREAD_LOCAL int *_spFrameHint = NULL;
+
+void _spTimeline_setFrameHint(int *hint) {
+	_spFrameHint = hint;
+}
+
+/* Returns the index of the last frame with a time <= the given time, or 0 if there is none. */
+static int search2(spFloatArray *values, float time, int step) {
 	float *items = values->items;
-	for (
-			i = step, n = values->size;
-			i < n;
-			i += step)
-		if (items[i] > time) return i -
-									step;
-	return values->size -
-		   step;
+	int n = values->size / step, i, low, high;
+
+	if (n <= SEARCH_LINEAR_MAX_FRAMES) {
+		for (i = step; i < values->size; i += step)
+			if (items[i] > time) return i - step;
+		return values->size - step;
+	}
+
+	/* Playback is usually monotonic, so the hinted frame or the one after it is the likely answer. */
+	if (_spFrameHint) {
+		i = *_spFrameHint;
+		if (i >= 0 && i < n && items[i * step] <= time) {
+			if (i + 1 >= n || items[(i + 1) * step] > time) return i * step;
+			if (i + 2 >= n || items[(i + 2) * step] > time) {
+				*_spFrameHint = i + 1;
+				return (i + 1) * step;
+			}
+		}
+	}
+
+	/* Find the first frame after the given time. */
+	low = 1;
+	high = n;
+	while (low < high) {
+		i = (low + high) >> 1;
+		if (items[i * step] > time) high = i;
+		else low = i + 1;
+	}
+
+	if (_spFrameHint) *_spFrameHint = low - 1;
+	return (low - 1) * step;
+}
+
+static int search(spFloatArray *values, float time) {
+	return search2(values, time, 1);
 }
 
 /**/
@@ -276,14 +299,8 @@ void spCurveTimeline1_setFrame(spCurveTimeline1 *self, int frame, float time, fl
 float spCurveTimeline1_getCurveValue(spCurveTimeline1 *self, float time) {
 	float *frames = self->super.frames->items;
 	float *curves = self->curves->items;
-	int i = self->super.frames->size - 2;
-	int ii, curveType;
-	for (ii = 2; ii <= i; ii += 2) {
-		if (frames[ii] > time) {
-			i = ii - 2;
-			break;
-		}
-	}
+	int i = search2(self->super.frames, time, CURVE1_ENTRIES);
+	int curveType;
 
 	curveType = (int) curves[i >> 1];
 	switch (curveType) {
@@ -1524,15 +1541,59 @@ void spRGB2Timeline_setFrame(spRGB2Timeline *self, int frame, float time, float
 
 /**/
 
+static void _spAttachmentTimeline_clearResolved(spAttachmentTimeline *self) {
+	FREE(self->resolvedSkins);
+	FREE(self->resolvedAttachments);
+	self->resolvedSkins = 0;
+	self->resolvedAttachments = 0;
+	self->resolvedSkinsCount = 0;
+}
+
+void spAttachmentTimeline_resolve(spAttachmentTimeline *self, spSkeletonData *skeletonData) {
+	int i, ii, framesCount = self->super.frames->size, stride = framesCount + 1;
+	const char *setupName = skeletonData->slots[self->slotIndex]->attachmentName;
+
+	_spAttachmentTimeline_clearResolved(self);
+	self->resolvedSkinsCount = skeletonData->skinsCount + 1;
+	self->resolvedSkins = CALLOC(spSkin *, self->resolvedSkinsCount);
+	self->resolvedAttachments = CALLOC(spAttachment *, self->resolvedSkinsCount * stride);
+
+	for (i = 0; i < self->resolvedSkinsCount; ++i) {
+		spSkin *skin = i == 0 ? NULL : skeletonData->skins[i - 1];
+		spAttachment **attachments = self->resolvedAttachments + i * stride;
+		self->resolvedSkins[i] = skin;
+		for (ii = 0; ii < stride; ++ii) {
+			const char *attachmentName = ii < framesCount ? self->attachmentNames[ii] : setupName;
+			spAttachment *attachment = NULL;
+			if (!attachmentName) continue;
+			/* Same order as spSkeleton_getAttachmentForSlotIndex */
+			if (skin) attachment = spSkin_getAttachment(skin, self->slotIndex, attachmentName);
+			if (!attachment && skeletonData->defaultSkin)
+				attachment = spSkin_getAttachment(skeletonData->defaultSkin, self->slotIndex, attachmentName);
+			attachments[ii] = attachment;
+		}
+	}
+}
+
+spAttachment *spAttachmentTimeline_getAttachment(const spAttachmentTimeline *self, const spSkeleton *skeleton, int frame) {
+	const char *attachmentName;
+	int i, stride = self->super.frames->size + 1;
+	for (i = 0; i < self->resolvedSkinsCount; ++i) {
+		if (self->resolvedSkins[i] == skeleton->skin)
+			return self->resolvedAttachments[i * stride + (frame < 0 ? stride - 1 : frame)];
+	}
+	attachmentName = frame < 0 ? skeleton->slots[self->slotIndex]->data->attachmentName : self->attachmentNames[frame];
+	return attachmentName == NULL ? NULL : spSkeleton_getAttachmentForSlotIndex(skeleton, self->slotIndex, attachmentName);
+}
+
 static void
-_spSetAttachment(spAttachmentTimeline *timeline, spSkeleton *skeleton, spSlot *slot, const char *attachmentName) {
-	spSlot_setAttachment(slot, attachmentName == NULL ? NULL : spSkeleton_getAttachmentForSlotIndex(skeleton, timeline->slotIndex, attachmentName));
+_spSetAttachment(spAttachmentTimeline *timeline, spSkeleton *skeleton, spSlot *slot, int frame) {
+	spSlot_setAttachment(slot, spAttachmentTimeline_getAttachment(timeline, skeleton, frame));
 }
 
 void _spAttachmentTimeline_apply(spTimeline *timeline, spSkeleton *skeleton, float lastTime, float time,
 								 spEvent **firedEvents, int *eventsCount, float alpha, spMixBlend blend,
 								 spMixDirection direction) {
-	const char *attachmentName;
 	spAttachmentTimeline *self = (spAttachmentTimeline *) timeline;
 	float *frames = self->super.frames->items;
 	spSlot *slot = skeleton->slots[self->slotIndex];
@@ -1540,26 +1601,25 @@ void _spAttachmentTimeline_apply(spTimeline *timeline, spSkeleton *skeleton, flo
 
 	if (direction == SP_MIX_DIRECTION_OUT) {
 		if (blend == SP_MIX_BLEND_SETUP) {
-			_spSetAttachment(self, skeleton, slot, slot->data->attachmentName);
+			_spSetAttachment(self, skeleton, slot, -1);
 		}
 		return;
 	}
 
 	if (time < frames[0]) {
 		if (blend == SP_MIX_BLEND_SETUP || blend == SP_MIX_BLEND_FIRST) {
-			_spSetAttachment(self, skeleton, slot, slot->data->attachmentName);
+			_spSetAttachment(self, skeleton, slot, -1);
 		}
 		return;
 	}
 
 	if (time < frames[0]) {
 		if (blend == SP_MIX_BLEND_SETUP || blend == SP_MIX_BLEND_FIRST)
-			_spSetAttachment(self, skeleton, slot, slot->data->attachmentName);
+			_spSetAttachment(self, skeleton, slot, -1);
 		return;
 	}
 
-	attachmentName = self->attachmentNames[search(self->super.frames, time)];
-	_spSetAttachment(self, skeleton, slot, attachmentName);
+	_spSetAttachment(self, skeleton, slot, search(self->super.frames, time));
 
 	UNUSED(lastTime);
 	UNUSED(firedEvents);
@@ -1573,6 +1633,7 @@ void _spAttachmentTimeline_dispose(spTimeline *timeline) {
 	for (i = 0; i < self->super.frames->size; ++i)
 		FREE(self->attachmentNames[i]);
 	FREE(self->attachmentNames);
+	_spAttachmentTimeline_clearResolved(self);
 }
 
 spAttachmentTimeline *spAttachmentTimeline_create(int framesCount, int slotIndex) {
@@ -1588,6 +1649,7 @@ spAttachmentTimeline *spAttachmentTimeline_create(int framesCount, int slotIndex
 
 void spAttachmentTimeline_setFrame(spAttachmentTimeline *self, int frame, float time, const char *attachmentName) {
 	self->super.frames->items[frame] = time;
+	_spAttachmentTimeline_clearResolved(self);
 
 	FREE(self->attachmentNames[frame]);
 	if (attachmentName)
@@ -2860,3 +2922,78 @@ spPhysicsConstraintResetTimeline *spPhysicsConstraintResetTimeline_create(int fr
 void spPhysicsConstraintResetTimeline_setFrame(spPhysicsConstraintResetTimeline *self, int frame, float time) {
 	self->super.frames->items[frame] = time;
 }
+
+/**/
+
+void _spTimeline_initVtable(spTimeline *self) {
+	_spTimelineVtable *vtable = &self->vtable;
+	vtable->dispose = _spCurveTimeline_dispose;
+	vtable->setBezier = _spCurveTimeline_setBezier;
+	switch (self->type) {
+		case SP_TIMELINE_ROTATE: vtable->apply = _spRotateTimeline_apply; break;
+		case SP_TIMELINE_TRANSLATE: vtable->apply = _spTranslateTimeline_apply; break;
+		case SP_TIMELINE_TRANSLATEX: vtable->apply = _spTranslateXTimeline_apply; break;
+		case SP_TIMELINE_TRANSLATEY: vtable->apply = _spTranslateYTimeline_apply; break;
+		case SP_TIMELINE_SCALE: vtable->apply = _spScaleTimeline_apply; break;
+		case SP_TIMELINE_SCALEX: vtable->apply = _spScaleXTimeline_apply; break;
+		case SP_TIMELINE_SCALEY: vtable->apply = _spScaleYTimeline_apply; break;
+		case SP_TIMELINE_SHEAR: vtable->apply = _spShearTimeline_apply; break;
+		case SP_TIMELINE_SHEARX: vtable->apply = _spShearXTimeline_apply; break;
+		case SP_TIMELINE_SHEARY: vtable->apply = _spShearYTimeline_apply; break;
+		case SP_TIMELINE_RGBA: vtable->apply = _spRGBATimeline_apply; break;
+		case SP_TIMELINE_RGB: vtable->apply = _spRGBTimeline_apply; break;
+		case SP_TIMELINE_ALPHA: vtable->apply = _spAlphaTimeline_apply; break;
+		case SP_TIMELINE_RGBA2: vtable->apply = _spRGBA2Timeline_apply; break;
+		case SP_TIMELINE_RGB2: vtable->apply = _spRGB2Timeline_apply; break;
+		case SP_TIMELINE_IKCONSTRAINT: vtable->apply = _spIkConstraintTimeline_apply; break;
+		case SP_TIMELINE_TRANSFORMCONSTRAINT: vtable->apply = _spTransformConstraintTimeline_apply; break;
+		case SP_TIMELINE_PATHCONSTRAINTPOSITION: vtable->apply = _spPathConstraintPositionTimeline_apply; break;
+		case SP_TIMELINE_PATHCONSTRAINTSPACING: vtable->apply = _spPathConstraintSpacingTimeline_apply; break;
+		case SP_TIMELINE_PATHCONSTRAINTMIX: vtable->apply = _spPathConstraintMixTimeline_apply; break;
+		case SP_TIMELINE_PHYSICSCONSTRAINT_INERTIA:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_STRENGTH:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_DAMPING:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_MASS:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_WIND:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_GRAVITY:
+		case SP_TIMELINE_PHYSICSCONSTRAINT_MIX:
+			vtable->apply = _spPhysicsConstraintTimeline_apply;
+			break;
+		case SP_TIMELINE_DEFORM:
+			vtable->dispose = _spDeformTimeline_dispose;
+			vtable->apply = _spDeformTimeline_apply;
+			vtable->setBezier = _spDeformTimeline_setBezier;
+			break;
+		/* The timelines without curves */
+		case SP_TIMELINE_ATTACHMENT:
+			vtable->dispose = _spAttachmentTimeline_dispose;
+			vtable->apply = _spAttachmentTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+		case SP_TIMELINE_SEQUENCE:
+			vtable->dispose = _spSequenceTimeline_dispose;
+			vtable->apply = _spSequenceTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+		case SP_TIMELINE_EVENT:
+			vtable->dispose = _spEventTimeline_dispose;
+			vtable->apply = _spEventTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+		case SP_TIMELINE_DRAWORDER:
+			vtable->dispose = _spDrawOrderTimeline_dispose;
+			vtable->apply = _spDrawOrderTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+		case SP_TIMELINE_INHERIT:
+			vtable->dispose = _spInheritTimeline_dispose;
+			vtable->apply = _spInheritTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+		case SP_TIMELINE_PHYSICSCONSTRAINT_RESET:
+			vtable->dispose = _spPhysicsConstraintResetTimeline_dispose;
+			vtable->apply = _spPhysicsConstraintResetTimeline_apply;
+			vtable->setBezier = 0;
+			break;
+	}
+}
@@ -81,6 +81,8 @@ void _spAnimationState_animationsChanged(spAnimationState *self);
 
 float *_spAnimationState_resizeTimelinesRotation(spTrackEntry *entry, int newSize);
 
+int *_spAnimationState_resizeTimelineFrameHints(spTrackEntry *entry, int newSize);
+
 void _spAnimationState_ensureCapacityPropertyIDs(spAnimationState *self, int capacity);
 
 int _spAnimationState_addPropertyID(spAnimationState *self, spPropertyId id);
@@ -92,7 +94,7 @@ _spEventQueue *_spEventQueue_create(_spAnimationState *state) {
 	self->state = state;
 	self->objectsCount = 0;
 	self->objectsCapacity = 16;
-	self->objects = CALLOC(_spEventQueueItem, self->objectsCapacity);
+	self->objects = CALLOC_HEAP(_spEventQueueItem, self->objectsCapacity); /* Defold: Grows after the state is created */
 	self->drainDisabled = 0;
 	return self;
 }
@@ -218,6 +220,7 @@ void _spAnimationState_disposeTrackEntry(spTrackEntry *entry) {
 	spIntArray_dispose(entry->timelineMode);
 	spTrackEntryArray_dispose(entry->timelineHoldMix);
 	FREE(entry->timelinesRotation);
+	FREE(entry->timelineFrameHints);
 	FREE(entry);
 }
 
@@ -244,8 +247,11 @@ spAnimationState *spAnimationState_create(spAnimationStateData *data) {
 	spAnimationState *self;
 
 	if (!SP_EMPTY_ANIMATION) {
+		/* Defold: Shared by all the states, so it never comes from an arena */
+		spArena *previous = _spSetArena(NULL);
 		SP_EMPTY_ANIMATION = (spAnimation *) 1; /* dirty trick so we can recursively call spAnimation_create */
 		SP_EMPTY_ANIMATION = spAnimation_create("<empty>", NULL, 0);
+		_spSetArena(previous);
 	}
 
 	internal = NEW(_spAnimationState);
@@ -257,7 +263,7 @@ spAnimationState *spAnimationState_create(spAnimationStateData *data) {
 	internal->queue = _spEventQueue_create(internal);
 	internal->events = CALLOC(spEvent *, 128);
 
-	internal->propertyIDs = CALLOC(spPropertyId, 128);
+	internal->propertyIDs = CALLOC_HEAP(spPropertyId, 128); /* Defold: Grows after the state is created */
 	internal->propertyIDsCapacity = 128;
 
 	return self;
@@ -386,6 +392,7 @@ int spAnimationState_apply(spAnimationState *self, spSkeleton *skeleton) {
 	const char *attachmentName = NULL;
 	spEvent **applyEvents = NULL;
 	float applyTime;
+	int *frameHints;
 
 	if (internal->animationsChanged) _spAnimationState_animationsChanged(self);
 
@@ -415,9 +422,11 @@ int spAnimationState_apply(spAnimationState *self, spSkeleton *skeleton) {
 			applyEvents = NULL;
 		}
 		timelines = current->animation->timelines->items;
+		frameHints = _spAnimationState_resizeTimelineFrameHints(current, timelineCount);
 		if ((i == 0 && alpha == 1) || blend == SP_MIX_BLEND_ADD) {
 			for (ii = 0; ii < timelineCount; ii++) {
 				timeline = timelines[ii];
+				_spTimeline_setFrameHint(frameHints + ii);
 				if (timeline->type == SP_TIMELINE_ATTACHMENT) {
 					_spAnimationState_applyAttachmentTimeline(self, timeline, skeleton, applyTime, blend, attachments);
 				} else {
@@ -435,6 +444,7 @@ int spAnimationState_apply(spAnimationState *self, spSkeleton *skeleton) {
 
 			for (ii = 0; ii < timelineCount; ii++) {
 				timeline = timelines[ii];
+				_spTimeline_setFrameHint(frameHints + ii);
 				timelineBlend = timelineMode->items[ii] == SUBSEQUENT ? blend : SP_MIX_BLEND_SETUP;
 				if (!shortestRotation && timeline->type == SP_TIMELINE_ROTATE)
 					_spAnimationState_applyRotateTimeline(self, timeline, skeleton, applyTime, alpha, timelineBlend,
@@ -451,6 +461,8 @@ int spAnimationState_apply(spAnimationState *self, spSkeleton *skeleton) {
 		current->nextAnimationLast = animationTime;
 		current->nextTrackLast = current->trackTime;
 	}
+	/* The hints belong to the track entries, so don't leave them in use. */
+	_spTimeline_setFrameHint(NULL);
 
 	setupState = self->unkeyedState + SETUP;
 	slots = skeleton->slots;
@@ -488,6 +500,7 @@ float _spAnimationState_applyMixingFrom(spAnimationState *self, spTrackEntry *to
 	int i;
 	spTrackEntry *holdMix;
 	float applyTime;
+	int *frameHints;
 
 	spTrackEntry *from = to->mixingFrom;
 	if (from->mixingFrom) _spAnimationState_applyMixingFrom(self, from, skeleton, blend);
@@ -517,9 +530,11 @@ float _spAnimationState_applyMixingFrom(spAnimationState *self, spTrackEntry *to
 		if (mix < from->eventThreshold) events = internal->events;
 	}
 
+	frameHints = _spAnimationState_resizeTimelineFrameHints(from, timelineCount);
 	if (blend == SP_MIX_BLEND_ADD) {
 		for (i = 0; i < timelineCount; i++) {
 			spTimeline *timeline = timelines[i];
+			_spTimeline_setFrameHint(frameHints + i);
 			spTimeline_apply(timeline, skeleton, animationLast, applyTime, events, &internal->eventsCount, alphaMix,
 							 blend, SP_MIX_DIRECTION_OUT);
 		}
@@ -536,6 +551,7 @@ float _spAnimationState_applyMixingFrom(spAnimationState *self, spTrackEntry *to
 		for (i = 0; i < timelineCount; i++) {
 			spMixDirection direction = SP_MIX_DIRECTION_OUT;
 			spTimeline *timeline = timelines[i];
+			_spTimeline_setFrameHint(frameHints + i);
 
 			switch (timelineMode->items[i]) {
 				case SUBSEQUENT:
@@ -587,10 +603,118 @@ float _spAnimationState_applyMixingFrom(spAnimationState *self, spTrackEntry *to
 	return mix;
 }
 
+/* Defold: Fires the events of a mixing from entry like _spAnimationState_applyMixingFrom, without posing the skeleton. */
+static float _spAnimationState_applyEventsMixingFrom(spAnimationState *self, spTrackEntry *to, spSkeleton *skeleton, spMixBlend blend) {
+	_spAnimationState *internal = SUB_CAST(_spAnimationState, self);
+	float mix, alphaHold, alphaMix, animationTime;
+	int /*boolean*/ drawOrder;
+	int i, timelineCount;
+	spTimeline **timelines;
+	spTrackEntry *holdMix;
+
+	spTrackEntry *from = to->mixingFrom;
+	if (from->mixingFrom) _spAnimationState_applyEventsMixingFrom(self, from, skeleton, blend);
+
+	if (to->mixDuration == 0) {
+		mix = 1;
+		if (blend == SP_MIX_BLEND_FIRST) blend = SP_MIX_BLEND_SETUP;
+	} else {
+		mix = to->mixTime / to->mixDuration;
+		if (mix > 1) mix = 1;
+		if (blend != SP_MIX_BLEND_FIRST) blend = from->mixBlend;
+	}
+
+	drawOrder = mix < from->mixDrawOrderThreshold;
+	timelineCount = from->animation->timelines->size;
+	timelines = from->animation->timelines->items;
+	alphaHold = from->alpha * to->interruptAlpha;
+	alphaMix = alphaHold * (1 - mix);
+	animationTime = spTrackEntry_getAnimationTime(from);
+
+	if (!from->reverse && mix < from->eventThreshold) {
+		for (i = 0; i < timelineCount; i++) {
+			if (timelines[i]->type == SP_TIMELINE_EVENT)
+				spTimeline_apply(timelines[i], skeleton, from->animationLast, animationTime, internal->events,
+								 &internal->eventsCount, alphaMix, blend, SP_MIX_DIRECTION_OUT);
+		}
+	}
+
+	/* The total alpha decides when the mix is finished (see _spAnimationState_updateMixingFrom). */
+	if (blend != SP_MIX_BLEND_ADD) {
+		from->totalAlpha = 0;
+		for (i = 0; i < timelineCount; i++) {
+			switch (from->timelineMode->items[i]) {
+				case SUBSEQUENT:
+					if (!drawOrder && timelines[i]->type == SP_TIMELINE_DRAWORDER) continue;
+					from->totalAlpha += alphaMix;
+					break;
+				case FIRST:
+					from->totalAlpha += alphaMix;
+					break;
+				case HOLD_SUBSEQUENT:
+				case HOLD_FIRST:
+					from->totalAlpha += alphaHold;
+					break;
+				default:
+					holdMix = from->timelineHoldMix->items[i];
+					from->totalAlpha += alphaHold * MAX(0, 1 - holdMix->mixTime / holdMix->mixDuration);
+					break;
+			}
+		}
+	}
+
+	if (to->mixDuration > 0) _spAnimationState_queueEvents(self, from, animationTime);
+	internal->eventsCount = 0;
+	from->nextAnimationLast = animationTime;
+	from->nextTrackLast = from->trackTime;
+	spTrackEntry_resetRotationDirections(from);
+
+	return mix;
+}
+
+/* Defold: Fires the same events as spAnimationState_apply, without posing the skeleton. For skeletons that aren't
+ * drawn, which are fully applied again before they're drawn. */
+void spAnimationState_applyEvents(spAnimationState *self, spSkeleton *skeleton) {
+	_spAnimationState *internal = SUB_CAST(_spAnimationState, self);
+	spTrackEntry *current;
+	spTimeline **timelines;
+	float animationTime;
+	int i, ii, n, timelineCount;
+
+	if (internal->animationsChanged) _spAnimationState_animationsChanged(self);
+
+	for (i = 0, n = self->tracksCount; i < n; i++) {
+		current = self->tracks[i];
+		if (!current || current->delay > 0) continue;
+
+		if (current->mixingFrom)
+			_spAnimationState_applyEventsMixingFrom(self, current, skeleton, i == 0 ? SP_MIX_BLEND_FIRST : current->mixBlend);
+
+		animationTime = spTrackEntry_getAnimationTime(current);
+		if (!current->reverse) {
+			timelineCount = current->animation->timelines->size;
+			timelines = current->animation->timelines->items;
+			for (ii = 0; ii < timelineCount; ii++) {
+				if (timelines[ii]->type == SP_TIMELINE_EVENT)
+					spTimeline_apply(timelines[ii], skeleton, current->animationLast, animationTime, internal->events,
+									 &internal->eventsCount, current->alpha, SP_MIX_BLEND_FIRST, SP_MIX_DIRECTION_IN);
+			}
+		}
+		_spAnimationState_queueEvents(self, current, animationTime);
+		internal->eventsCount = 0;
+		current->nextAnimationLast = animationTime;
+		current->nextTrackLast = current->trackTime;
+		/* The rotation directions follow the applied frames, and the next applied frame isn't continuous with the last one. */
+		spTrackEntry_resetRotationDirections(current);
+	}
+
+	_spEventQueue_drain(internal->queue);
+}
+
 static void
-_spAnimationState_setAttachment(spAnimationState *self, spSkeleton *skeleton, spSlot *slot, const char *attachmentName,
-								int /*bool*/ attachments) {
-	spSlot_setAttachment(slot, attachmentName == NULL ? NULL : spSkeleton_getAttachmentForSlotIndex(skeleton, slot->data->index, attachmentName));
+_spAnimationState_setAttachment(spAnimationState *self, spSkeleton *skeleton, spSlot *slot,
+								spAttachmentTimeline *timeline, int frame, int /*bool*/ attachments) {
+	spSlot_setAttachment(slot, spAttachmentTimeline_getAttachment(timeline, skeleton, frame));
 	if (attachments) slot->attachmentState = self->unkeyedState + CURRENT;
 }
 
@@ -616,10 +740,10 @@ void _spAnimationState_applyAttachmentTimeline(spAnimationState *self, spTimelin
 	frames = attachmentTimeline->super.frames->items;
 	if (time < frames[0]) {
 		if (blend == SP_MIX_BLEND_SETUP || blend == SP_MIX_BLEND_FIRST)
-			_spAnimationState_setAttachment(self, skeleton, slot, slot->data->attachmentName, attachments);
+			_spAnimationState_setAttachment(self, skeleton, slot, attachmentTimeline, -1, attachments);
 	} else {
-		_spAnimationState_setAttachment(self, skeleton, slot, attachmentTimeline->attachmentNames[binarySearch1(frames, attachmentTimeline->super.frames->size, time)],
-										attachments);
+		_spAnimationState_setAttachment(self, skeleton, slot, attachmentTimeline,
+										binarySearch1(frames, attachmentTimeline->super.frames->size, time), attachments);
 	}
 
 	/* If an attachment wasn't set (ie before the first frame or attachments is false), set the setup attachment later.*/
@@ -978,6 +1102,16 @@ void _spAnimationState_animationsChanged(spAnimationState *self) {
 	}
 }
 
+int *_spAnimationState_resizeTimelineFrameHints(spTrackEntry *entry, int newSize) {
+	if (entry->timelineFrameHintsCount != newSize) {
+		int *newTimelineFrameHints = CALLOC(int, newSize);
+		FREE(entry->timelineFrameHints);
+		entry->timelineFrameHints = newTimelineFrameHints;
+		entry->timelineFrameHintsCount = newSize;
+	}
+	return entry->timelineFrameHints;
+}
+
 float *_spAnimationState_resizeTimelinesRotation(spTrackEntry *entry, int newSize) {
 	if (entry->timelinesRotationCount != newSize) {
 		float *newTimelinesRotation = CALLOC(float, newSize);
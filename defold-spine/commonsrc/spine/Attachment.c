@@ -37,6 +37,29 @@ typedef struct _spAttachmentVtable {
 	spAttachment *(*copy)(spAttachment *self);
 } _spAttachmentVtable;
 
+void _spRegionAttachment_dispose(spAttachment *attachment);
+spAttachment *_spRegionAttachment_copy(spAttachment *attachment);
+void _spBoundingBoxAttachment_dispose(spAttachment *attachment);
+spAttachment *_spBoundingBoxAttachment_copy(spAttachment *attachment);
+void _spMeshAttachment_dispose(spAttachment *attachment);
+spAttachment *_spMeshAttachment_copy(spAttachment *attachment);
+void _spPathAttachment_dispose(spAttachment *attachment);
+spAttachment *_spPathAttachment_copy(spAttachment *attachment);
+void _spPointAttachment_dispose(spAttachment *attachment);
+spAttachment *_spPointAttachment_copy(spAttachment *attachment);
+void _spClippingAttachment_dispose(spAttachment *attachment);
+spAttachment *_spClippingAttachment_copy(spAttachment *attachment);
+
+/* Indexed by spAttachmentType. Linked meshes are mesh attachments */
+static const _spAttachmentVtable staticVtables[] = {
+		{_spRegionAttachment_dispose, _spRegionAttachment_copy},
+		{_spBoundingBoxAttachment_dispose, _spBoundingBoxAttachment_copy},
+		{_spMeshAttachment_dispose, _spMeshAttachment_copy},
+		{_spMeshAttachment_dispose, _spMeshAttachment_copy},
+		{_spPathAttachment_dispose, _spPathAttachment_copy},
+		{_spPointAttachment_dispose, _spPointAttachment_copy},
+		{_spClippingAttachment_dispose, _spClippingAttachment_copy}};
+
 void _spAttachment_init(spAttachment *self, const char *name, spAttachmentType type, /**/
 						void (*dispose)(spAttachment *self), spAttachment *(*copy)(spAttachment *self)) {
 
@@ -48,6 +71,10 @@ void _spAttachment_init(spAttachment *self, const char *name, spAttachmentType t
 	self->type = type;
 }
 
+void _spAttachment_initStaticVtable(spAttachment *self) {
+	self->vtable = &staticVtables[self->type];
+}
+
 void _spAttachment_deinit(spAttachment *self) {
 	if (self->attachmentLoader) spAttachmentLoader_disposeAttachment(self->attachmentLoader, self);
 	FREE(self->vtable);
@@ -90,8 +90,11 @@ void spAttachmentLoader_disposeAttachment(spAttachmentLoader *self, spAttachment
 void _spAttachmentLoader_setError(spAttachmentLoader *self, const char *error1, const char *error2) {
 	FREE(self->error1);
 	FREE(self->error2);
-	MALLOC_STR(self->error1, error1);
-	MALLOC_STR(self->error2, error2);
+	/* Defold: Outlive the skeleton data arena */
+	self->error1 = MALLOC_HEAP(char, strlen(error1) + 1);
+	strcpy(self->error1, error1);
+	self->error2 = MALLOC_HEAP(char, strlen(error2) + 1);
+	strcpy(self->error2, error2);
 }
 
 void _spAttachmentLoader_setUnknownTypeError(spAttachmentLoader *self, spAttachmentType type) {
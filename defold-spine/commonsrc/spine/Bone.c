@@ -30,6 +30,7 @@
 #include <spine/Bone.h>
 #include <spine/extension.h>
 #include <stdio.h>
+#include <string.h>
 
 static int yDown;
 
@@ -43,6 +44,12 @@ int spBone_isYDown(void) {
 
 spBone *spBone_create(spBoneData *data, spSkeleton *skeleton, spBone *parent) {
 	spBone *self = NEW(spBone);
+	spBone_init(self, data, skeleton, parent);
+	return self;
+}
+
+void spBone_init(spBone *self, spBoneData *data, spSkeleton *skeleton, spBone *parent) {
+	memset(self, 0, sizeof(spBone));
 	self->data = data;
 	self->skeleton = skeleton;
 	self->parent = parent;
@@ -51,7 +58,6 @@ spBone *spBone_create(spBoneData *data, spSkeleton *skeleton, spBone *parent) {
 	self->active = -1;
 	self->inherit = SP_INHERIT_NORMAL;
 	spBone_setToSetupPose(self);
-	return self;
 }
 
 void spBone_dispose(spBone *self) {
@@ -33,9 +33,14 @@
 #include <spine/extension.h>
 
 spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const spSkeleton *skeleton) {
-	int i;
-
 	spIkConstraint *self = NEW(spIkConstraint);
+	spIkConstraint_init(self, data, skeleton, MALLOC(spBone *, data->bonesCount));
+	return self;
+}
+
+void spIkConstraint_init(spIkConstraint *self, spIkConstraintData *data, const spSkeleton *skeleton, spBone **bones) {
+	int i;
+	memset(self, 0, sizeof(spIkConstraint));
 	self->data = data;
 	self->bendDirection = data->bendDirection;
 	self->compress = data->compress;
@@ -44,12 +49,10 @@ spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const spSkeleton
 	self->softness = data->softness;
 
 	self->bonesCount = self->data->bonesCount;
-	self->bones = MALLOC(spBone *, self->bonesCount);
+	self->bones = bones;
 	for (i = 0; i < self->bonesCount; ++i)
-		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
-	self->target = spSkeleton_findBone(skeleton, self->data->target->name);
-
-	return self;
+		self->bones[i] = skeleton->bones[self->data->bones[i]->index];
+	self->target = skeleton->bones[self->data->target->index];
 }
 
 void spIkConstraint_dispose(spIkConstraint *self) {
@@ -71,46 +71,98 @@ static int Json_strcasecmp(const char *s1, const char *s2) {
 	}
 }
 
+/* Defold: The nodes and strings of a document are allocated from a few large blocks instead of one allocation
+ * each. The root node is the first allocation of the first block, and Json_dispose() frees all the blocks. */
+typedef struct _JsonBlock {
+	struct _JsonBlock *next;
+	size_t size;
+	size_t capacity;
+} _JsonBlock;
+
+#define JSON_BLOCK_MIN_CAPACITY (4 * 1024)
+#define JSON_BLOCK_MAX_CAPACITY (1024 * 1024)
+
+typedef struct _JsonParser {
+	const char *end;
+	_JsonBlock *first;
+	_JsonBlock *current;
+} _JsonParser;
+
+static _JsonBlock *Json_newBlock(size_t capacity) {
+	_JsonBlock *block = (_JsonBlock *) MALLOC_HEAP(char, sizeof(_JsonBlock) + capacity);
+	if (!block) return 0;
+	block->next = 0;
+	block->size = 0;
+	block->capacity = capacity;
+	return block;
+}
+
+static void *Json_alloc(_JsonParser *parser, size_t size, size_t align) {
+	_JsonBlock *block = parser->current;
+	size_t offset = (block->size + align - 1) & ~(align - 1);
+	if (offset + size > block->capacity) {
+		size_t capacity = block->capacity * 2;
+		if (capacity > JSON_BLOCK_MAX_CAPACITY) capacity = JSON_BLOCK_MAX_CAPACITY;
+		if (capacity < size) capacity = size;
+		block = Json_newBlock(capacity);
+		if (!block) return 0;
+		/* The first block owns the list */
+		block->next = parser->first->next;
+		parser->first->next = block;
+		parser->current = block;
+		offset = 0;
+	}
+	block->size = offset + size;
+	return (char *) (block + 1) + offset;
+}
+
 /* Internal constructor. */
-static Json *Json_new(void) {
-	return (Json *) CALLOC(Json, 1);
+static Json *Json_new(_JsonParser *parser) {
+	Json *item = (Json *) Json_alloc(parser, sizeof(Json), sizeof(void *));
+	if (item) memset(item, 0, sizeof(Json));
+	return item;
 }
 
-/* Delete a Json structure. */
+/* Delete a Json structure. Defold: Only the root can be deleted, which deletes the whole document. */
 void Json_dispose(Json *c) {
-	Json *next;
-	while (c) {
-		next = c->next;
-		if (c->child) Json_dispose(c->child);
-		if (c->valueString) FREE(c->valueString);
-		if (c->name) FREE(c->name);
-		FREE(c);
-		c = next;
+	_JsonBlock *block;
+	if (!c) return;
+	block = ((_JsonBlock *) c) - 1;
+	while (block) {
+		_JsonBlock *next = block->next;
+		FREE(block);
+		block = next;
 	}
 }
 
+/* The input doesn't need to be null terminated. Reading at the end gives 0, as if it was. */
+static char peek(const char *in, const char *end) {
+	return in < end ? *in : 0;
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
-static const char *parse_number(Json *item, const char *num) {
+static const char *parse_number(Json *item, const char *num, _JsonParser *parser) {
+	const char *end = parser->end;
 	double result = 0.0;
 	int negative = 0;
-	char *ptr = (char *) num;
+	const char *ptr = num;
 
-	if (*ptr == '-') {
+	if (peek(ptr, end) == '-') {
 		negative = -1;
 		++ptr;
 	}
 
-	while (*ptr >= '0' && *ptr <= '9') {
+	while (peek(ptr, end) >= '0' && peek(ptr, end) <= '9') {
 		result = result * 10.0 + (*ptr - '0');
 		++ptr;
 	}
 
-	if (*ptr == '.') {
+	if (peek(ptr, end) == '.') {
 		double fraction = 0.0;
 		int n = 0;
 		++ptr;
 
-		while (*ptr >= '0' && *ptr <= '9') {
+		while (peek(ptr, end) >= '0' && peek(ptr, end) <= '9') {
 			fraction = (fraction * 10.0) + (*ptr - '0');
 			++ptr;
 			++n;
@@ -119,19 +171,19 @@ static const char *parse_number(Json *item, const char *num) {
 	}
 	if (negative) result = -result;
 
-	if (*ptr == 'e' || *ptr == 'E') {
+	if (peek(ptr, end) == 'e' || peek(ptr, end) == 'E') {
 		double exponent = 0;
 		int expNegative = 0;
 		++ptr;
 
-		if (*ptr == '-') {
+		if (peek(ptr, end) == '-') {
 			expNegative = -1;
 			++ptr;
-		} else if (*ptr == '+') {
+		} else if (peek(ptr, end) == '+') {
 			++ptr;
 		}
 
-		while (*ptr >= '0' && *ptr <= '9') {
+		while (peek(ptr, end) >= '0' && peek(ptr, end) <= '9') {
 			exponent = (exponent * 10.0) + (*ptr - '0');
 			++ptr;
 		}
@@ -155,34 +207,54 @@ static const char *parse_number(Json *item, const char *num) {
 	}
 }
 
+/* Reads the 4 hex digits of a \u escape. Returns 0 if they're missing. */
+static unsigned parse_hex4(const char *in, const char *end) {
+	unsigned value = 0;
+	int i;
+	for (i = 0; i < 4; ++i) {
+		char c = peek(in + i, end);
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+			value |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			value |= c - 'A' + 10;
+		else
+			return 0;
+	}
+	return value;
+}
+
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
 
-static const char *parse_string(Json *item, const char *str) {
+static const char *parse_string(Json *item, const char *str, _JsonParser *parser) {
+	const char *end = parser->end;
 	const char *ptr = str + 1;
 	char *ptr2;
 	char *out;
 	int len = 0;
 	unsigned uc, uc2;
-	if (*str != '\"') { /* TODO: don't need this check when called from parse_value, but do need from parse_object */
+	if (peek(str, end) != '\"') { /* TODO: don't need this check when called from parse_value, but do need from parse_object */
 		ep = str;
 		return 0;
 	} /* not a string! */
 
-	while (*ptr != '\"' && *ptr && ++len)
+	while (peek(ptr, end) != '\"' && peek(ptr, end) && ++len)
 		if (*ptr++ == '\\') ptr++; /* Skip escaped quotes. */
 
-	out = MALLOC(char, len + 1); /* The length needed for the string, roughly. */
+	out = (char *) Json_alloc(parser, len + 1, 1); /* The length needed for the string, roughly. */
 	if (!out) return 0;
 
 	ptr = str + 1;
 	ptr2 = out;
-	while (*ptr != '\"' && *ptr) {
+	while (peek(ptr, end) != '\"' && peek(ptr, end)) {
 		if (*ptr != '\\')
 			*ptr2++ = *ptr++;
 		else {
 			ptr++;
-			switch (*ptr) {
+			switch (peek(ptr, end)) {
 				case 'b':
 					*ptr2++ = '\b';
 					break;
@@ -199,7 +271,7 @@ static const char *parse_string(Json *item, const char *str) {
 					*ptr2++ = '\t';
 					break;
 				case 'u': /* transcode utf16 to utf8. */
-					sscanf(ptr + 1, "%4x", &uc);
+					uc = parse_hex4(ptr + 1, end);
 					ptr += 4; /* get the unicode char. */
 
 					if ((uc >= 0xDC00 && uc <= 0xDFFF) || uc == 0) break; /* check for invalid.	*/
@@ -207,8 +279,8 @@ static const char *parse_string(Json *item, const char *str) {
 					/* TODO provide an option to ignore surrogates, use unicode replacement character? */
 					if (uc >= 0xD800 && uc <= 0xDBFF) /* UTF16 surrogate pairs.	*/
 					{
-						if (ptr[1] != '\\' || ptr[2] != 'u') break; /* missing second-half of surrogate.	*/
-						sscanf(ptr + 3, "%4x", &uc2);
+						if (peek(ptr + 1, end) != '\\' || peek(ptr + 2, end) != 'u') break; /* missing second-half of surrogate.	*/
+						uc2 = parse_hex4(ptr + 3, end);
 						ptr += 6;
 						if (uc2 < 0xDC00 || uc2 > 0xDFFF) break; /* invalid second-half of surrogate.	*/
 						uc = 0x10000 + (((uc & 0x3FF) << 10) | (uc2 & 0x3FF));
@@ -242,43 +314,60 @@ static const char *parse_string(Json *item, const char *str) {
 					ptr2 += len;
 					break;
 				default:
-					*ptr2++ = *ptr;
+					*ptr2++ = peek(ptr, end);
 					break;
 			}
 			ptr++;
 		}
 	}
 	*ptr2 = 0;
-	if (*ptr == '\"') ptr++; /* TODO error handling if not \" or \0 ? */
+	if (peek(ptr, end) == '\"') ptr++; /* TODO error handling if not \" or \0 ? */
 	item->valueString = out;
 	item->type = Json_String;
-	return ptr;
+	return ptr < end ? ptr : end;
 }
 
 /* Predeclare these prototypes. */
-static const char *parse_value(Json *item, const char *value);
+static const char *parse_value(Json *item, const char *value, _JsonParser *parser);
 
-static const char *parse_array(Json *item, const char *value);
+static const char *parse_array(Json *item, const char *value, _JsonParser *parser);
 
-static const char *parse_object(Json *item, const char *value);
+static const char *parse_object(Json *item, const char *value, _JsonParser *parser);
 
 /* Utility to jump whitespace and cr/lf */
-static const char *skip(const char *in) {
+static const char *skip(const char *in, const char *end) {
 	if (!in) return 0; /* must propagate NULL since it's often called in skip(f(...)) form */
-	while (*in && (unsigned char) *in <= 32)
+	while (peek(in, end) && (unsigned char) *in <= 32)
 		in++;
 	return in;
 }
 
 /* Parse an object - create a new root, and populate. */
 Json *Json_create(const char *value) {
-	Json *c;
-	ep = 0;
 	if (!value) return 0; /* only place we check for NULL other than skip() */
-	c = Json_new();
-	if (!c) return 0; /* memory fail */
+	return Json_createWithLength(value, (int) strlen(value));
+}
 
-	value = parse_value(c, skip(value));
+/* Defold: The input doesn't need to be null terminated. */
+Json *Json_createWithLength(const char *value, int length) {
+	Json *c;
+	const char *end;
+	_JsonParser parser;
+	size_t capacity;
+	ep = 0;
+	if (!value) return 0;
+	end = value + length;
+
+	/* The nodes take several times the size of the text, try to fit them in one block */
+	capacity = (size_t) length * 8;
+	if (capacity < JSON_BLOCK_MIN_CAPACITY) capacity = JSON_BLOCK_MIN_CAPACITY;
+	if (capacity > JSON_BLOCK_MAX_CAPACITY) capacity = JSON_BLOCK_MAX_CAPACITY;
+	parser.end = end;
+	parser.first = parser.current = Json_newBlock(capacity);
+	if (!parser.first) return 0; /* memory fail */
+	c = Json_new(&parser);
+
+	value = parse_value(c, skip(value, end), &parser);
 	if (!value) {
 		Json_dispose(c);
 		return 0;
@@ -287,24 +376,30 @@ Json *Json_create(const char *value) {
 	return c;
 }
 
+/* Matches the rest of a literal, e.g. "ull" of "null". */
+static int match(const char *in, const char *end, const char *literal, int length) {
+	return end - in >= length && !strncmp(in, literal, length);
+}
+
 /* Parser core - when encountering text, process appropriately. */
-static const char *parse_value(Json *item, const char *value) {
+static const char *parse_value(Json *item, const char *value, _JsonParser *parser) {
+	const char *end = parser->end;
 	/* Referenced by Json_create(), parse_array(), and parse_object(). */
 	/* Always called with the result of skip(). */
 #if SPINE_JSON_DEBUG      /* Checked at entry to graph, Json_create, and after every parse_ call. */
 	if (!value) return 0; /* Fail on null. */
 #endif
 
-	switch (*value) {
+	switch (peek(value, end)) {
 		case 'n': {
-			if (!strncmp(value + 1, "ull", 3)) {
+			if (match(value + 1, end, "ull", 3)) {
 				item->type = Json_NULL;
 				return value + 4;
 			}
 			break;
 		}
 		case 'f': {
-			if (!strncmp(value + 1, "alse", 4)) {
+			if (match(value + 1, end, "alse", 4)) {
 				item->type = Json_False;
 				/* calloc prevents us needing item->type = Json_False or valueInt = 0 here */
 				return value + 5;
@@ -312,7 +407,7 @@ static const char *parse_value(Json *item, const char *value) {
 			break;
 		}
 		case 't': {
-			if (!strncmp(value + 1, "rue", 3)) {
+			if (match(value + 1, end, "rue", 3)) {
 				item->type = Json_True;
 				item->valueInt = 1;
 				return value + 4;
@@ -320,11 +415,11 @@ static const char *parse_value(Json *item, const char *value) {
 			break;
 		}
 		case '\"':
-			return parse_string(item, value);
+			return parse_string(item, value, parser);
 		case '[':
-			return parse_array(item, value);
+			return parse_array(item, value, parser);
 		case '{':
-			return parse_object(item, value);
+			return parse_object(item, value, parser);
 		case '-': /* fallthrough */
 		case '0': /* fallthrough */
 		case '1': /* fallthrough */
@@ -336,7 +431,7 @@ static const char *parse_value(Json *item, const char *value) {
 		case '7': /* fallthrough */
 		case '8': /* fallthrough */
 		case '9':
-			return parse_number(item, value);
+			return parse_number(item, value, parser);
 		default:
 			break;
 	}
@@ -346,7 +441,8 @@ static const char *parse_value(Json *item, const char *value) {
 }
 
 /* Build an array from input text. */
-static const char *parse_array(Json *item, const char *value) {
+static const char *parse_array(Json *item, const char *value, _JsonParser *parser) {
+	const char *end = parser->end;
 	Json *child;
 
 #if SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
@@ -357,35 +453,36 @@ static const char *parse_array(Json *item, const char *value) {
 #endif
 
 	item->type = Json_Array;
-	value = skip(value + 1);
-	if (*value == ']') return value + 1; /* empty array. */
+	value = skip(value + 1, end);
+	if (peek(value, end) == ']') return value + 1; /* empty array. */
 
-	item->child = child = Json_new();
-	if (!item->child) return 0;                    /* memory fail */
-	value = skip(parse_value(child, skip(value))); /* skip any spacing, get the value. */
+	item->child = child = Json_new(parser);
+	if (!item->child) return 0;                                   /* memory fail */
+	value = skip(parse_value(child, skip(value, end), parser), end); /* skip any spacing, get the value. */
 	if (!value) return 0;
 	item->size = 1;
 
-	while (*value == ',') {
-		Json *new_item = Json_new();
+	while (peek(value, end) == ',') {
+		Json *new_item = Json_new(parser);
 		if (!new_item) return 0; /* memory fail */
 		child->next = new_item;
 #if SPINE_JSON_HAVE_PREV
 		new_item->prev = child;
 #endif
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(child, skip(value + 1, end), parser), end);
 		if (!value) return 0; /* parse fail */
 		item->size++;
 	}
 
-	if (*value == ']') return value + 1; /* end of array */
+	if (peek(value, end) == ']') return value + 1; /* end of array */
 	ep = value;
 	return 0; /* malformed. */
 }
 
 /* Build an object from the text. */
-static const char *parse_object(Json *item, const char *value) {
+static const char *parse_object(Json *item, const char *value, _JsonParser *parser) {
+	const char *end = parser->end;
 	Json *child;
 
 #if SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
@@ -396,45 +493,45 @@ static const char *parse_object(Json *item, const char *value) {
 #endif
 
 	item->type = Json_Object;
-	value = skip(value + 1);
-	if (*value == '}') return value + 1; /* empty array. */
+	value = skip(value + 1, end);
+	if (peek(value, end) == '}') return value + 1; /* empty array. */
 
-	item->child = child = Json_new();
+	item->child = child = Json_new(parser);
 	if (!item->child) return 0;
-	value = skip(parse_string(child, skip(value)));
+	value = skip(parse_string(child, skip(value, end), parser), end);
 	if (!value) return 0;
 	child->name = child->valueString;
 	child->valueString = 0;
-	if (*value != ':') {
+	if (peek(value, end) != ':') {
 		ep = value;
 		return 0;
-	}                                                  /* fail! */
-	value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+	}                                                                 /* fail! */
+	value = skip(parse_value(child, skip(value + 1, end), parser), end); /* skip any spacing, get the value. */
 	if (!value) return 0;
 	item->size = 1;
 
-	while (*value == ',') {
-		Json *new_item = Json_new();
+	while (peek(value, end) == ',') {
+		Json *new_item = Json_new(parser);
 		if (!new_item) return 0; /* memory fail */
 		child->next = new_item;
 #if SPINE_JSON_HAVE_PREV
 		new_item->prev = child;
 #endif
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		value = skip(parse_string(child, skip(value + 1, end), parser), end);
 		if (!value) return 0;
 		child->name = child->valueString;
 		child->valueString = 0;
-		if (*value != ':') {
+		if (peek(value, end) != ':') {
 			ep = value;
 			return 0;
-		}                                                  /* fail! */
-		value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+		}                                                                 /* fail! */
+		value = skip(parse_value(child, skip(value + 1, end), parser), end); /* skip any spacing, get the value. */
 		if (!value) return 0;
 		item->size++;
 	}
 
-	if (*value == '}') return value + 1; /* end of array */
+	if (peek(value, end) == '}') return value + 1; /* end of array */
 	ep = value;
 	return 0; /* malformed. */
 }
@@ -64,7 +64,10 @@ typedef struct Json {
 /* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished. */
 Json *Json_create(const char *value);
 
-/* Delete a Json entity and all subentities. */
+/* Defold: Same as Json_create(), for input that isn't null terminated. Json_getError() then points into the input. */
+Json *Json_createWithLength(const char *value, int length);
+
+/* Delete a Json entity and all subentities. Defold: Must be the root returned by Json_create(), the nodes are allocated in blocks owned by it. */
 void Json_dispose(Json *json);
 
 /* Get item "string" from object. Case insensitive. */
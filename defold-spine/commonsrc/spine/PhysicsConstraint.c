@@ -33,6 +33,12 @@
 
 spPhysicsConstraint *spPhysicsConstraint_create(spPhysicsConstraintData *data, spSkeleton *skeleton) {
 	spPhysicsConstraint *self = NEW(spPhysicsConstraint);
+	spPhysicsConstraint_init(self, data, skeleton);
+	return self;
+}
+
+void spPhysicsConstraint_init(spPhysicsConstraint *self, spPhysicsConstraintData *data, spSkeleton *skeleton) {
+	memset(self, 0, sizeof(spPhysicsConstraint));
 	self->data = data;
 	self->skeleton = skeleton;
 	self->bone = skeleton->bones[data->bone->index];
@@ -61,7 +67,6 @@ spPhysicsConstraint *spPhysicsConstraint_create(spPhysicsConstraintData *data, s
 	self->active = 0;
 	self->remaining = 0;
 	self->lastTime = 0;
-	return self;
 }
 
 void spPhysicsConstraint_dispose(spPhysicsConstraint *self) {
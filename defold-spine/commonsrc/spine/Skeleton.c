@@ -53,9 +53,19 @@ typedef struct {
 	_spUpdate *updateCache;
 } _spSkeleton;
 
+/* Defold: Takes the next part of the instance block. Every part is a multiple of the pointer size, so each one stays
+ * aligned. */
+static void *_takeBlock(char **block, size_t size) {
+	void *result = *block;
+	*block += size;
+	return result;
+}
+
 spSkeleton *spSkeleton_create(spSkeletonData *data) {
 	int i;
 	int *childrenCounts;
+	int childrenTotal, darkColorsCount, constraintBonesCount;
+	char *block;
 
 	_spSkeleton *internal = NEW(_spSkeleton);
 	spSkeleton *self = SUPER(internal);
@@ -66,26 +76,66 @@ spSkeleton *spSkeleton_create(spSkeletonData *data) {
 	self->scaleY = 1;
 	self->time = 0;
 
-	self->bonesCount = self->data->bonesCount;
-	self->bones = MALLOC(spBone *, self->bonesCount);
-	childrenCounts = CALLOC(int, self->bonesCount);
+	self->bonesCount = data->bonesCount;
+	self->slotsCount = data->slotsCount;
+	self->ikConstraintsCount = data->ikConstraintsCount;
+	self->transformConstraintsCount = data->transformConstraintsCount;
+	self->pathConstraintsCount = data->pathConstraintsCount;
+	self->physicsConstraintsCount = data->physicsConstraintsCount;
 
+	childrenCounts = CALLOC(int, self->bonesCount);
+	childrenTotal = 0;
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBoneData *boneData = self->data->bones[i];
-		spBone *newBone;
-		if (!boneData->parent)
-			newBone = spBone_create(boneData, self, 0);
-		else {
-			spBone *parent = self->bones[boneData->parent->index];
-			newBone = spBone_create(boneData, self, parent);
+		spBoneData *boneData = data->bones[i];
+		if (boneData->parent) {
 			++childrenCounts[boneData->parent->index];
+			++childrenTotal;
+		}
+	}
+	darkColorsCount = 0;
+	for (i = 0; i < self->slotsCount; ++i)
+		if (data->slots[i]->darkColor) ++darkColorsCount;
+	constraintBonesCount = 0;
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		constraintBonesCount += data->ikConstraints[i]->bonesCount;
+	for (i = 0; i < self->transformConstraintsCount; ++i)
+		constraintBonesCount += data->transformConstraints[i]->bonesCount;
+	for (i = 0; i < self->pathConstraintsCount; ++i)
+		constraintBonesCount += data->pathConstraints[i]->bonesCount;
+
+	/* Defold: One block for the bones (in data order, so parents come before their children), the slots, the draw
+	 * order, the constraints, and their arrays. Released by FREE(self->bones). Only what is resized after creation
+	 * (the slot deform and the path constraint buffers) is allocated separately. */
+	block = (char *) MALLOC(char,
+							sizeof(spBone *) * (self->bonesCount + childrenTotal + constraintBonesCount) +
+							sizeof(spBone) * self->bonesCount +
+							sizeof(spSlot *) * self->slotsCount * 2 + sizeof(spSlot) * self->slotsCount +
+							sizeof(spIkConstraint *) * self->ikConstraintsCount +
+							sizeof(spIkConstraint) * self->ikConstraintsCount +
+							sizeof(spTransformConstraint *) * self->transformConstraintsCount +
+							sizeof(spTransformConstraint) * self->transformConstraintsCount +
+							sizeof(spPathConstraint *) * self->pathConstraintsCount +
+							sizeof(spPathConstraint) * self->pathConstraintsCount +
+							sizeof(spPhysicsConstraint *) * self->physicsConstraintsCount +
+							sizeof(spPhysicsConstraint) * self->physicsConstraintsCount +
+							sizeof(spColor) * darkColorsCount);
+
+	self->bones = (spBone **) _takeBlock(&block, sizeof(spBone *) * self->bonesCount);
+	{
+		spBone *bones = (spBone *) _takeBlock(&block, sizeof(spBone) * self->bonesCount);
+		for (i = 0; i < self->bonesCount; ++i) {
+			spBoneData *boneData = data->bones[i];
+			spBone *newBone = bones + i;
+			if (!boneData->parent)
+				spBone_init(newBone, boneData, self, 0);
+			else
+				spBone_init(newBone, boneData, self, self->bones[boneData->parent->index]);
+			self->bones[i] = newBone;
 		}
-		self->bones[i] = newBone;
 	}
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBoneData *boneData = self->data->bones[i];
 		spBone *bone = self->bones[i];
-		bone->children = MALLOC(spBone *, childrenCounts[boneData->index]);
+		bone->children = (spBone **) _takeBlock(&block, sizeof(spBone *) * childrenCounts[i]);
 	}
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBone *bone = self->bones[i];
@@ -95,44 +145,60 @@ spSkeleton *spSkeleton_create(spSkeletonData *data) {
 	}
 	self->root = (self->bonesCount > 0 ? self->bones[0] : NULL);
 
-	self->slotsCount = data->slotsCount;
-	self->slots = MALLOC(spSlot *, self->slotsCount);
-	for (i = 0; i < self->slotsCount; ++i) {
-		spSlotData *slotData = data->slots[i];
-		spBone *bone = self->bones[slotData->boneData->index];
-		self->slots[i] = spSlot_create(slotData, bone);
+	self->slots = (spSlot **) _takeBlock(&block, sizeof(spSlot *) * self->slotsCount);
+	self->drawOrder = (spSlot **) _takeBlock(&block, sizeof(spSlot *) * self->slotsCount);
+	{
+		spSlot *slots = (spSlot *) _takeBlock(&block, sizeof(spSlot) * self->slotsCount);
+		for (i = 0; i < self->slotsCount; ++i) {
+			spSlotData *slotData = data->slots[i];
+			spColor *darkColor = slotData->darkColor ? (spColor *) _takeBlock(&block, sizeof(spColor)) : 0;
+			spSlot_init(slots + i, slotData, self->bones[slotData->boneData->index], darkColor);
+			self->slots[i] = slots + i;
+		}
 	}
-
-	self->drawOrder = MALLOC(spSlot *, self->slotsCount);
 	memcpy(self->drawOrder, self->slots, sizeof(spSlot *) * self->slotsCount);
 
-	self->ikConstraintsCount = data->ikConstraintsCount;
-	self->ikConstraints = MALLOC(spIkConstraint *, self->ikConstraintsCount);
-	for (i = 0; i < self->data->ikConstraintsCount; ++i)
-		self->ikConstraints[i] = spIkConstraint_create(self->data->ikConstraints[i], self);
-
-	self->transformConstraintsCount = data->transformConstraintsCount;
-	self->transformConstraints = MALLOC(spTransformConstraint *, self->transformConstraintsCount);
-	for (i = 0; i < self->data->transformConstraintsCount; ++i)
-		self->transformConstraints[i] = spTransformConstraint_create(self->data->transformConstraints[i], self);
-
-	self->pathConstraintsCount = data->pathConstraintsCount;
-	self->pathConstraints = MALLOC(spPathConstraint *, self->pathConstraintsCount);
-	for (i = 0; i < self->data->pathConstraintsCount; i++)
-		self->pathConstraints[i] = spPathConstraint_create(self->data->pathConstraints[i], self);
-
-	self->physicsConstraintsCount = data->physicsConstraintsCount;
-	self->physicsConstraints = MALLOC(spPhysicsConstraint *, self->physicsConstraintsCount);
-	for (i = 0; i < self->data->physicsConstraintsCount; i++)
-		self->physicsConstraints[i] = spPhysicsConstraint_create(self->data->physicsConstraints[i], self);
-
+	self->ikConstraints = (spIkConstraint **) _takeBlock(&block, sizeof(spIkConstraint *) * self->ikConstraintsCount);
+	{
+		spIkConstraint *constraints = (spIkConstraint *) _takeBlock(&block, sizeof(spIkConstraint) * self->ikConstraintsCount);
+		for (i = 0; i < self->ikConstraintsCount; ++i) {
+			spIkConstraintData *constraintData = data->ikConstraints[i];
+			spBone **bones = (spBone **) _takeBlock(&block, sizeof(spBone *) * constraintData->bonesCount);
+			spIkConstraint_init(constraints + i, constraintData, self, bones);
+			self->ikConstraints[i] = constraints + i;
+		}
+	}
 
-	spColor_setFromFloats(&self->color, 1, 1, 1, 1);
+	self->transformConstraints = (spTransformConstraint **) _takeBlock(&block, sizeof(spTransformConstraint *) * self->transformConstraintsCount);
+	{
+		spTransformConstraint *constraints = (spTransformConstraint *) _takeBlock(&block, sizeof(spTransformConstraint) * self->transformConstraintsCount);
+		for (i = 0; i < self->transformConstraintsCount; ++i) {
+			spTransformConstraintData *constraintData = data->transformConstraints[i];
+			spBone **bones = (spBone **) _takeBlock(&block, sizeof(spBone *) * constraintData->bonesCount);
+			spTransformConstraint_init(constraints + i, constraintData, self, bones);
+			self->transformConstraints[i] = constraints + i;
+		}
+	}
 
-	self->scaleX = 1;
-	self->scaleY = 1;
+	self->pathConstraints = (spPathConstraint **) _takeBlock(&block, sizeof(spPathConstraint *) * self->pathConstraintsCount);
+	{
+		spPathConstraint *constraints = (spPathConstraint *) _takeBlock(&block, sizeof(spPathConstraint) * self->pathConstraintsCount);
+		for (i = 0; i < self->pathConstraintsCount; ++i) {
+			spPathConstraintData *constraintData = data->pathConstraints[i];
+			spBone **bones = (spBone **) _takeBlock(&block, sizeof(spBone *) * constraintData->bonesCount);
+			spPathConstraint_init(constraints + i, constraintData, self, bones);
+			self->pathConstraints[i] = constraints + i;
+		}
+	}
 
-	self->time = 0;
+	self->physicsConstraints = (spPhysicsConstraint **) _takeBlock(&block, sizeof(spPhysicsConstraint *) * self->physicsConstraintsCount);
+	{
+		spPhysicsConstraint *constraints = (spPhysicsConstraint *) _takeBlock(&block, sizeof(spPhysicsConstraint) * self->physicsConstraintsCount);
+		for (i = 0; i < self->physicsConstraintsCount; ++i) {
+			spPhysicsConstraint_init(constraints + i, data->physicsConstraints[i], self);
+			self->physicsConstraints[i] = constraints + i;
+		}
+	}
 
 	spSkeleton_updateCache(self);
 
@@ -147,31 +213,13 @@ void spSkeleton_dispose(spSkeleton *self) {
 
 	FREE(internal->updateCache);
 
-	for (i = 0; i < self->bonesCount; ++i)
-		spBone_dispose(self->bones[i]);
-	FREE(self->bones);
-
 	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_dispose(self->slots[i]);
-	FREE(self->slots);
-
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		spIkConstraint_dispose(self->ikConstraints[i]);
-	FREE(self->ikConstraints);
-
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		spTransformConstraint_dispose(self->transformConstraints[i]);
-	FREE(self->transformConstraints);
-
+		spSlot_deinit(self->slots[i]);
 	for (i = 0; i < self->pathConstraintsCount; i++)
-		spPathConstraint_dispose(self->pathConstraints[i]);
-	FREE(self->pathConstraints);
-
-	for (i = 0; i < self->physicsConstraintsCount; i++)
-		spPhysicsConstraint_dispose(self->physicsConstraints[i]);
-	FREE(self->physicsConstraints);
+		spPathConstraint_deinit(self->pathConstraints[i]);
 
-	FREE(self->drawOrder);
+	/* Defold: Everything else is in the same block */
+	FREE(self->bones);
 	FREE(self);
 }
 
@@ -369,7 +417,7 @@ void spSkeleton_updateCache(spSkeleton *self) {
 			self->bonesCount + self->ikConstraintsCount + self->transformConstraintsCount + self->pathConstraintsCount +
 			self->physicsConstraintsCount;
 	FREE(internal->updateCache);
-	internal->updateCache = MALLOC(_spUpdate, internal->updateCacheCapacity);
+	internal->updateCache = MALLOC_HEAP(_spUpdate, internal->updateCacheCapacity); /* Defold: Rebuilt after the skeleton is created */
 	internal->updateCacheCount = 0;
 
 	bones = self->bones;
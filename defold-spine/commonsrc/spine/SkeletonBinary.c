@@ -107,7 +107,9 @@ void _spSkeletonBinary_setError(spSkeletonBinary *self, const char *value1, cons
 	strcpy(message, value1);
 	length = (int) strlen(value1);
 	if (value2) strncat(message + length, value2, 255 - length);
-	MALLOC_STR(self->error, message);
+	/* Defold: Outlives the skeleton data arena */
+	self->error = MALLOC_HEAP(char, strlen(message) + 1);
+	strcpy(self->error, message);
 }
 
 static unsigned char readByte(_dataInput *input) {
@@ -325,7 +327,7 @@ static void _spSkeletonBinary_addLinkedMesh(spSkeletonBinary *self, spMeshAttach
 		internal->linkedMeshCapacity *= 2;
 		if (internal->linkedMeshCapacity < 8) internal->linkedMeshCapacity = 8;
 		/* TODO Why not realloc? */
-		linkedMeshes = MALLOC(_spLinkedMesh, internal->linkedMeshCapacity);
+		linkedMeshes = MALLOC_HEAP(_spLinkedMesh, internal->linkedMeshCapacity); /* Defold: Outlives the skeleton data arena */
 		memcpy(linkedMeshes, internal->linkedMeshes, sizeof(_spLinkedMesh) * internal->linkedMeshCount);
 		FREE(internal->linkedMeshes);
 		internal->linkedMeshes = linkedMeshes;
@@ -1311,8 +1313,27 @@ spSkeletonData *spSkeletonBinary_readSkeletonDataFile(spSkeletonBinary *self, co
 	return skeletonData;
 }
 
+static spSkeletonData *_spSkeletonBinary_readSkeletonData(spSkeletonBinary *self, const unsigned char *binary,
+														  const int length);
+
+/* Defold: The skeleton data is allocated from its own arena, which is released at once by spSkeletonData_dispose() */
 spSkeletonData *spSkeletonBinary_readSkeletonData(spSkeletonBinary *self, const unsigned char *binary,
 												  const int length) {
+	/* The skeleton data takes several times the size of the binary data */
+	size_t blockSize = (size_t) length * 8;
+	spArena *arena = _spArena_create(blockSize < 4096 ? 4096 : blockSize);
+	spArena *previous = _spSetArena(arena);
+	spSkeletonData *skeletonData = _spSkeletonBinary_readSkeletonData(self, binary, length);
+	_spSetArena(previous);
+	if (skeletonData)
+		skeletonData->arena = arena;
+	else
+		_spArena_dispose(arena);
+	return skeletonData;
+}
+
+static spSkeletonData *_spSkeletonBinary_readSkeletonData(spSkeletonBinary *self, const unsigned char *binary,
+														  const int length) {
 	int i, n, ii, nonessential;
 	char buffer[32];
 	int lowHash, highHash;
@@ -1649,5 +1670,6 @@ spSkeletonData *spSkeletonBinary_readSkeletonData(spSkeletonBinary *self, const
 	}
 
 	FREE(input);
+	spSkeletonData_resolveAttachmentTimelines(skeletonData);
 	return skeletonData;
 }
@@ -37,6 +37,9 @@ spSkeletonData *spSkeletonData_create(void) {
 
 void spSkeletonData_dispose(spSkeletonData *self) {
 	int i;
+	/* Defold: Freeing the memory from the arena does nothing, it's released with the arena at the end */
+	spArena *arena = self->arena;
+	spArena *previous = arena ? _spSetArena(arena) : NULL;
 
 	for (i = 0; i < self->stringsCount; ++i)
 		FREE(self->strings[i]);
@@ -84,6 +87,11 @@ void spSkeletonData_dispose(spSkeletonData *self) {
 	FREE(self->audioPath);
 
 	FREE(self);
+
+	if (arena) {
+		_spSetArena(previous);
+		_spArena_dispose(arena);
+	}
 }
 
 spBoneData *spSkeletonData_findBone(const spSkeletonData *self, const char *boneName) {
@@ -149,3 +157,14 @@ spPhysicsConstraintData *spSkeletonData_findPhysicsConstraint(const spSkeletonDa
 		if (strcmp(self->physicsConstraints[i]->name, constraintName) == 0) return self->physicsConstraints[i];
 	return 0;
 }
+
+void spSkeletonData_resolveAttachmentTimelines(spSkeletonData *self) {
+	int i, ii;
+	for (i = 0; i < self->animationsCount; ++i) {
+		spTimelineArray *timelines = self->animations[i]->timelines;
+		for (ii = 0; ii < timelines->size; ++ii) {
+			if (timelines->items[ii]->type == SP_TIMELINE_ATTACHMENT)
+				spAttachmentTimeline_resolve(SUB_CAST(spAttachmentTimeline, timelines->items[ii]), self);
+		}
+	}
+}
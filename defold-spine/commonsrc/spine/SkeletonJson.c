@@ -81,7 +81,9 @@ void _spSkeletonJson_setError(spSkeletonJson *self, Json *root, const char *valu
 	strcpy(message, value1);
 	length = (int) strlen(value1);
 	if (value2) strncat(message + length, value2, 255 - length);
-	MALLOC_STR(self->error, message);
+	/* Defold: Outlives the skeleton data arena */
+	self->error = MALLOC_HEAP(char, strlen(message) + 1);
+	strcpy(self->error, message);
 	if (root) Json_dispose(root);
 }
 
@@ -206,7 +208,7 @@ static void _spSkeletonJson_addLinkedMesh(spSkeletonJson *self, spMeshAttachment
 		_spLinkedMesh *linkedMeshes;
 		internal->linkedMeshCapacity *= 2;
 		if (internal->linkedMeshCapacity < 8) internal->linkedMeshCapacity = 8;
-		linkedMeshes = MALLOC(_spLinkedMesh, internal->linkedMeshCapacity);
+		linkedMeshes = MALLOC_HEAP(_spLinkedMesh, internal->linkedMeshCapacity); /* Defold: Outlives the skeleton data arena */
 		memcpy(linkedMeshes, internal->linkedMeshes, sizeof(_spLinkedMesh) * internal->linkedMeshCount);
 		FREE(internal->linkedMeshes);
 		internal->linkedMeshes = linkedMeshes;
@@ -1024,7 +1026,7 @@ spSkeletonData *spSkeletonJson_readSkeletonDataFile(spSkeletonJson *self, const
 		_spSkeletonJson_setError(self, 0, "Unable to read skeleton file: ", path);
 		return NULL;
 	}
-	skeletonData = spSkeletonJson_readSkeletonData(self, json);
+	skeletonData = spSkeletonJson_readSkeletonDataWithLength(self, json, length);
 	FREE(json);
 	return skeletonData;
 }
@@ -1042,6 +1044,27 @@ static int string_starts_with(const char *str, const char *needle) {
 }
 
 spSkeletonData *spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char *json) {
+	return spSkeletonJson_readSkeletonDataWithLength(self, json, (int) strlen(json));
+}
+
+static spSkeletonData *_spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char *json, int length);
+
+/* Defold: The skeleton data is allocated from its own arena, which is released at once by spSkeletonData_dispose() */
+spSkeletonData *spSkeletonJson_readSkeletonDataWithLength(spSkeletonJson *self, const char *json, int length) {
+	/* The skeleton data takes a few times the size of the text */
+	size_t blockSize = (size_t) length * 3;
+	spArena *arena = _spArena_create(blockSize < 4096 ? 4096 : blockSize);
+	spArena *previous = _spSetArena(arena);
+	spSkeletonData *skeletonData = _spSkeletonJson_readSkeletonData(self, json, length);
+	_spSetArena(previous);
+	if (skeletonData)
+		skeletonData->arena = arena;
+	else
+		_spArena_dispose(arena);
+	return skeletonData;
+}
+
+static spSkeletonData *_spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char *json, int length) {
 	int i, ii;
 	spSkeletonData *skeletonData;
 	Json *root, *skeleton, *bones, *boneMap, *ik, *transform, *pathJson, *physics, *slots, *skins, *animations, *events;
@@ -1051,9 +1074,14 @@ spSkeletonData *spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char
 	self->error = 0;
 	internal->linkedMeshCount = 0;
 
-	root = Json_create(json);
+	root = Json_createWithLength(json, length);
 	if (!root) {
-		_spSkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", Json_getError());
+		/* The input isn't null terminated, so only the start of the error location is shown */
+		const char *error = Json_getError();
+		char errorText[33];
+		int errorLength = error ? (int) (json + length - error) : 0;
+		snprintf(errorText, sizeof(errorText), "%.*s", errorLength < 32 ? errorLength : 32, error ? error : "");
+		_spSkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", errorText);
 		return NULL;
 	}
 
@@ -1798,5 +1826,6 @@ spSkeletonData *spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char
 	}
 
 	Json_dispose(root);
+	spSkeletonData_resolveAttachmentTimelines(skeletonData);
 	return skeletonData;
 }
@@ -32,16 +32,25 @@
 
 spSlot *spSlot_create(spSlotData *data, spBone *bone) {
 	spSlot *self = NEW(spSlot);
+	spSlot_init(self, data, bone, data->darkColor == 0 ? 0 : spColor_create());
+	return self;
+}
+
+void spSlot_init(spSlot *self, spSlotData *data, spBone *bone, spColor *darkColor) {
+	memset(self, 0, sizeof(spSlot));
 	self->data = data;
 	self->bone = bone;
 	spColor_setFromFloats(&self->color, 1, 1, 1, 1);
-	self->darkColor = data->darkColor == 0 ? 0 : spColor_create();
+	self->darkColor = darkColor;
 	spSlot_setToSetupPose(self);
-	return self;
 }
 
-void spSlot_dispose(spSlot *self) {
+void spSlot_deinit(spSlot *self) {
 	FREE(self->deform);
+}
+
+void spSlot_dispose(spSlot *self) {
+	spSlot_deinit(self);
 	FREE(self->darkColor);
 	FREE(self);
 }
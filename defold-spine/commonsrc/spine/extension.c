@@ -44,13 +44,159 @@ static void (*freeFunc)(void *ptr) = free;
 
 static float (*randomFunc)(void) = _spInternalRandom;
 
-void *_spMalloc(size_t size, const char *file, int line) {
+/* Defold: Arenas, see extension.h */
+typedef struct _spArenaBlock {
+	struct _spArenaBlock *next;
+	char *data;
+	size_t size;
+	size_t capacity;
+} _spArenaBlock;
+
+struct spArena {
+	_spArenaBlock *current;
+	_spArenaBlock *overflow; /* The blocks added after the first one */
+	_spArenaBlock first;
+	size_t blockSize;
+	size_t totalSize;
+};
+
+/* Each allocation starts with its size, so that it can be reallocated */
+typedef union _spArenaHeader {
+	size_t size;
+	double align;
+} _spArenaHeader;
+
+#define ARENA_ALIGNMENT sizeof(_spArenaHeader)
+#define ARENA_ALIGN(SIZE) (((SIZE) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+static _SP_THREAD_LOCAL spArena *currentArena = NULL;
+
+static void _spArenaBlock_init(_spArenaBlock *block, char *memory, size_t capacity) {
+	block->next = NULL;
+	block->data = (char *) ARENA_ALIGN((size_t) memory);
+	block->size = 0;
+	block->capacity = capacity;
+}
+
+spArena *_spArena_create(size_t blockSize) {
+	spArena *self;
+	blockSize = ARENA_ALIGN(blockSize);
+	self = (spArena *) mallocFunc(sizeof(spArena) + blockSize + ARENA_ALIGNMENT);
+	if (!self) return NULL;
+	_spArenaBlock_init(&self->first, (char *) (self + 1), blockSize);
+	self->current = &self->first;
+	self->overflow = NULL;
+	self->blockSize = blockSize;
+	self->totalSize = 0;
+	return self;
+}
+
+void _spArena_reset(spArena *self) {
+	_spArenaBlock *block = self->overflow;
+	while (block) {
+		_spArenaBlock *next = block->next;
+		freeFunc(block);
+		block = next;
+	}
+	self->first.size = 0;
+	self->current = &self->first;
+	self->overflow = NULL;
+	self->totalSize = 0;
+}
+
+void _spArena_dispose(spArena *self) {
+	if (!self) return;
+	if (currentArena == self) currentArena = NULL;
+	_spArena_reset(self);
+	freeFunc(self);
+}
+
+size_t _spArena_getSize(const spArena *self) {
+	return self->totalSize;
+}
+
+size_t _spArena_getBlockSize(const spArena *self) {
+	return self->first.capacity;
+}
+
+spArena *_spSetArena(spArena *arena) {
+	spArena *previous = currentArena;
+	currentArena = arena;
+	return previous;
+}
+
+spArena *_spGetArena(void) {
+	return currentArena;
+}
+
+static void *_spArena_alloc(spArena *self, size_t size) {
+	_spArenaBlock *block = self->current;
+	size_t needed = sizeof(_spArenaHeader) + ARENA_ALIGN(size);
+	_spArenaHeader *header;
+	if (block->capacity - block->size < needed) {
+		size_t capacity = needed > self->blockSize ? needed : self->blockSize;
+		block = (_spArenaBlock *) mallocFunc(sizeof(_spArenaBlock) + capacity + ARENA_ALIGNMENT);
+		if (!block) return NULL;
+		_spArenaBlock_init(block, (char *) (block + 1), capacity);
+		block->next = self->overflow;
+		self->overflow = block;
+		self->current = block;
+	}
+	header = (_spArenaHeader *) (block->data + block->size);
+	header->size = size;
+	block->size += needed;
+	self->totalSize += needed;
+	return header + 1;
+}
+
+/* Allocations come after their header, and a zero sized allocation can end at the end of the used block */
+static int _spArena_owns(const spArena *self, const void *ptr) {
+	const _spArenaBlock *block = &self->first;
+	const char *p = (const char *) ptr;
+	if (p > block->data && p <= block->data + block->size) return 1;
+	for (block = self->overflow; block; block = block->next)
+		if (p > block->data && p <= block->data + block->size) return 1;
+	return 0;
+}
+
+static void *_spArena_realloc(spArena *self, void *ptr, size_t size) {
+	_spArenaHeader *header = ((_spArenaHeader *) ptr) - 1;
+	_spArenaBlock *block = self->current;
+	void *result;
+	if (size <= header->size) return ptr;
+	/* The last allocation can grow in place */
+	if (block->data + block->size == (char *) ptr + ARENA_ALIGN(header->size) &&
+		block->capacity - block->size >= ARENA_ALIGN(size) - ARENA_ALIGN(header->size)) {
+		block->size += ARENA_ALIGN(size) - ARENA_ALIGN(header->size);
+		self->totalSize += ARENA_ALIGN(size) - ARENA_ALIGN(header->size);
+		header->size = size;
+		return ptr;
+	}
+	result = _spArena_alloc(self, size);
+	if (result) memcpy(result, ptr, header->size);
+	return result;
+}
+
+void *_spMallocHeap(size_t size, const char *file, int line) {
 	if (debugMallocFunc)
 		return debugMallocFunc(size, file, line);
 
 	return mallocFunc(size);
 }
 
+void *_spCallocHeap(size_t num, size_t size, const char *file, int line) {
+	void *ptr = _spMallocHeap(num * size, file, line);
+	if (ptr) memset(ptr, 0, num * size);
+	return ptr;
+}
+
+void *_spMalloc(size_t size, const char *file, int line) {
+	if (currentArena)
+		return _spArena_alloc(currentArena, size);
+
+	return _spMallocHeap(size, file, line);
+}
+
 void *_spCalloc(size_t num, size_t size, const char *file, int line) {
 	void *ptr = _spMalloc(num * size, file, line);
 	if (ptr) memset(ptr, 0, num * size);
@@ -58,10 +204,15 @@ void *_spCalloc(size_t num, size_t size, const char *file, int line) {
 }
 
 void *_spRealloc(void *ptr, size_t size) {
+	if (currentArena) {
+		if (!ptr) return _spArena_alloc(currentArena, size);
+		if (_spArena_owns(currentArena, ptr)) return _spArena_realloc(currentArena, ptr, size);
+	}
 	return reallocFunc(ptr, size);
 }
 
 void _spFree(void *ptr) {
+	if (currentArena && ptr && _spArena_owns(currentArena, ptr)) return;
 	freeFunc(ptr);
 }
 
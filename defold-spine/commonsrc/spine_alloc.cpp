@@ -0,0 +1,122 @@
+#include <common/spine_alloc.h>
+
+#include <stdlib.h>
+#include <dmsdk/dlib/atomic.h>
+
+extern "C" {
+#include <spine/extension.h>
+}
+
+namespace dmSpine
+{
+    static int32_atomic_t g_AllocationCount = 0;
+    static int32_atomic_t g_FreeCount = 0;
+
+#if !defined(DM_RELEASE)
+    static void* CountingMalloc(size_t size)
+    {
+        dmAtomicIncrement32(&g_AllocationCount);
+        return malloc(size);
+    }
+
+    static void* CountingRealloc(void* ptr, size_t size)
+    {
+        dmAtomicIncrement32(&g_AllocationCount);
+        return realloc(ptr, size);
+    }
+
+    static void CountingFree(void* ptr)
+    {
+        if (ptr)
+            dmAtomicIncrement32(&g_FreeCount);
+        free(ptr);
+    }
+#endif
+
+    void InstallAllocationCounter()
+    {
+#if !defined(DM_RELEASE)
+        _spSetMalloc(CountingMalloc);
+        _spSetRealloc(CountingRealloc);
+        _spSetFree(CountingFree);
+#endif
+    }
+
+    void UninstallAllocationCounter()
+    {
+#if !defined(DM_RELEASE)
+        _spSetMalloc(malloc);
+        _spSetRealloc(realloc);
+        _spSetFree(free);
+#endif
+    }
+
+    uint32_t GetAllocationCount()
+    {
+        return (uint32_t)dmAtomicGet32(&g_AllocationCount);
+    }
+
+    uint32_t GetFreeCount()
+    {
+        return (uint32_t)dmAtomicGet32(&g_FreeCount);
+    }
+
+    static const uint32_t INSTANCE_ARENA_MIN_SIZE = 2048;
+    static const uint32_t INSTANCE_ARENA_MAX_FREE = 32;
+
+    spArena* BeginInstanceAllocations(InstanceArenaPool* pool)
+    {
+        spArena* arena = 0;
+        while (!arena && !pool->m_Free.Empty())
+        {
+            arena = pool->m_Free.Back();
+            pool->m_Free.Pop();
+            // Too small for the instances we've seen since it was pooled
+            if (_spArena_getBlockSize(arena) < pool->m_ArenaSize)
+            {
+                _spArena_dispose(arena);
+                arena = 0;
+            }
+        }
+        if (!arena)
+            arena = _spArena_create(pool->m_ArenaSize > INSTANCE_ARENA_MIN_SIZE ? pool->m_ArenaSize : INSTANCE_ARENA_MIN_SIZE);
+        _spSetArena(arena);
+        return arena;
+    }
+
+    void EndInstanceAllocations(InstanceArenaPool* pool, spArena* arena)
+    {
+        _spSetArena(0);
+        if (arena && _spArena_getSize(arena) > pool->m_ArenaSize)
+            pool->m_ArenaSize = (uint32_t)_spArena_getSize(arena);
+    }
+
+    void BeginInstanceDispose(spArena* arena)
+    {
+        _spSetArena(arena);
+    }
+
+    void EndInstanceDispose(InstanceArenaPool* pool, spArena* arena)
+    {
+        _spSetArena(0);
+        if (!arena)
+            return;
+        if (pool->m_Free.Size() >= INSTANCE_ARENA_MAX_FREE)
+        {
+            _spArena_dispose(arena);
+            return;
+        }
+        _spArena_reset(arena);
+        if (pool->m_Free.Full())
+            pool->m_Free.OffsetCapacity(8);
+        pool->m_Free.Push(arena);
+    }
+
+    void DestroyInstanceArenaPool(InstanceArenaPool* pool)
+    {
+        for (uint32_t i = 0; i < pool->m_Free.Size(); ++i)
+            _spArena_dispose(pool->m_Free[i]);
+        pool->m_Free.SetCapacity(0);
+        pool->m_ArenaSize = 0;
+    }
+}
@@ -0,0 +1,9 @@
+#include <common/spine_layout.h>
+
+namespace dmSpine
+{
+    uint32_t GetSpineLayoutHash()
+    {
+        return CalcSpineLayoutHash();
+    }
+}
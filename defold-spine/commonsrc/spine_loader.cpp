@@ -4,6 +4,7 @@ extern "C" {
 #include <spine/AttachmentLoader.h>
 #include <spine/Attachment.h>
 #include <spine/SkeletonJson.h>
+#include <spine/SkeletonBinary.h>
 }
 
 #include <dmsdk/dlib/hash.h>
@@ -233,75 +234,80 @@ namespace dmSpine
         return true;
     }
 
-    static spAttachment* spDefoldAtlasAttachmentLoader_createAttachment(spAttachmentLoader* loader, spSkin* skin, spAttachmentType type,
-        const char* name, const char* path, spSequence *sequence)
+    // Used in the plugin, when loading a spine scene without the atlas available.
+    // The attachments keep a pointer to it, so it mustn't live on the stack.
+    // A unit size makes the region attachments keep their size from the json (a zero size gives nan positions)
+    static spAtlasRegion* GetDefaultRegion()
     {
-        spDefoldAtlasAttachmentLoader* self = SUB_CAST(spDefoldAtlasAttachmentLoader, loader);
+        static spAtlasRegion default_region;
+        spTextureRegion* textureRegion = &default_region.super;
+        textureRegion->u = textureRegion->v = textureRegion->degrees = 0;
+        textureRegion->u2 = textureRegion->v2 = 1;
+        textureRegion->offsetX = textureRegion->offsetY = 0;
+        textureRegion->width = textureRegion->height = 1;
+        textureRegion->originalWidth = textureRegion->originalHeight = 1;
+        return &default_region;
+    }
+
+    // Sets the region (or the sequence regions) of a region or mesh attachment
+    static bool SetAttachmentRegion(spDefoldAtlasAttachmentLoader* self, spAttachment* attachment, const char* path, spSequence* sequence)
+    {
+        spAttachmentLoader* loader = SUPER(self);
         bool is_atlas_available = self->name_to_index != 0;
+        spAtlasRegion* default_region = is_atlas_available ? 0 : GetDefaultRegion();
+
+        if (sequence) {
+            if (!loadSequence(self->name_to_index, self->regions, path, sequence, default_region)) {
+                _spAttachmentLoader_setError(loader, "Couldn't load sequence for attachment: ", path);
+                return false;
+            }
+            return true;
+        }
 
-        // used in the plugin, when loading a spine scene without the atlas available
-        spAtlasRegion default_region;
-        if (!is_atlas_available)
+        spAtlasRegion* region = default_region;
+        if (is_atlas_available)
         {
-            spTextureRegion* textureRegion = &default_region.super;
-            textureRegion->u = textureRegion->v = textureRegion->u2 = textureRegion->v2 = textureRegion->degrees = 0;
-            textureRegion->offsetX = textureRegion->offsetY = 0;
-            textureRegion->width = textureRegion->height = 0;
-            textureRegion->originalWidth = textureRegion->originalHeight = 0;
+            region = FindAtlasRegion(self->name_to_index, self->regions, path);
+            if (!region) {
+                _spAttachmentLoader_setError(loader, "Region not found: ", path);
+                return false;
+            }
+        }
+
+        if (attachment->type == SP_ATTACHMENT_REGION) {
+            spRegionAttachment* region_attachment = (spRegionAttachment*)attachment;
+            region_attachment->rendererObject = is_atlas_available ? region : 0;
+            region_attachment->region = SUPER(region);
+        } else {
+            spMeshAttachment* mesh_attachment = (spMeshAttachment*)attachment;
+            mesh_attachment->rendererObject = is_atlas_available ? region : 0;
+            mesh_attachment->region = SUPER(region);
         }
+        return true;
+    }
+
+    static spAttachment* spDefoldAtlasAttachmentLoader_createAttachment(spAttachmentLoader* loader, spSkin* skin, spAttachmentType type,
+        const char* name, const char* path, spSequence *sequence)
+    {
+        spDefoldAtlasAttachmentLoader* self = SUB_CAST(spDefoldAtlasAttachmentLoader, loader);
 
         switch (type) {
             case SP_ATTACHMENT_REGION: {
                 spRegionAttachment* attachment = spRegionAttachment_create(name);
-                if (sequence) {
-                    if (!loadSequence(self->name_to_index, self->regions, path, sequence, &default_region)) {
-                        spAttachment_dispose(SUPER(attachment));
-                        _spAttachmentLoader_setError(loader, "Couldn't load sequence for region attachment: ", path);
-                        return 0;
-                    }
-                } else {
-                    spAtlasRegion* region;
-                    if (is_atlas_available)
-                    {
-                        region = FindAtlasRegion(self->name_to_index, self->regions, path);
-                        if (!region) {
-                            spAttachment_dispose(SUPER(attachment));
-                            _spAttachmentLoader_setError(loader, "Region not found: ", path);
-                            return 0;
-                        }
-                    } else {
-                        region = &default_region;
-                    }
-                    attachment->rendererObject = is_atlas_available ? region : 0;
-                    attachment->region = SUPER(region);
-                    spRegionAttachment_updateRegion(attachment);
+                if (!SetAttachmentRegion(self, SUPER(attachment), path, sequence)) {
+                    spAttachment_dispose(SUPER(attachment));
+                    return 0;
                 }
+                if (!sequence)
+                    spRegionAttachment_updateRegion(attachment);
                 return SUPER(attachment);
             }
             case SP_ATTACHMENT_MESH:
             case SP_ATTACHMENT_LINKED_MESH: {
                 spMeshAttachment* attachment = spMeshAttachment_create(name);
-                if (sequence) {
-                    if (!loadSequence(self->name_to_index, self->regions, path, sequence, &default_region)) {
-                        spAttachment_dispose(SUPER(SUPER(attachment)));
-                        _spAttachmentLoader_setError(loader, "Couldn't load sequence for mesh attachment: ", path);
-                        return 0;
-                    }
-                } else {
-                    spAtlasRegion* region;
-                    if (is_atlas_available)
-                    {
-                        region = FindAtlasRegion(self->name_to_index, self->regions, path);
-                        if (!region) {
-                            spAttachment_dispose(SUPER(SUPER(attachment)));
-                            _spAttachmentLoader_setError(loader, "Region not found: ", path);
-                            return 0;
-                        }
-                    } else {
-                        region = &default_region;
-                    }
-                    attachment->rendererObject = is_atlas_available ? region : 0;
-                    attachment->region = SUPER(region);
+                if (!SetAttachmentRegion(self, SUPER(SUPER(attachment)), path, sequence)) {
+                    spAttachment_dispose(SUPER(SUPER(attachment)));
+                    return 0;
                 }
                 return SUPER(SUPER(attachment));
             }
@@ -321,6 +327,33 @@ namespace dmSpine
         UNUSED(skin);
     }
 
+    bool BindAttachmentRegion(spDefoldAtlasAttachmentLoader* loader, spAttachment* attachment)
+    {
+        switch (attachment->type) {
+            case SP_ATTACHMENT_REGION: {
+                spRegionAttachment* region_attachment = (spRegionAttachment*)attachment;
+                const char* path = region_attachment->path ? region_attachment->path : attachment->name;
+                if (!SetAttachmentRegion(loader, attachment, path, region_attachment->sequence))
+                    return false;
+                if (region_attachment->region)
+                    spRegionAttachment_updateRegion(region_attachment);
+                return true;
+            }
+            case SP_ATTACHMENT_MESH:
+            case SP_ATTACHMENT_LINKED_MESH: {
+                spMeshAttachment* mesh_attachment = (spMeshAttachment*)attachment;
+                const char* path = mesh_attachment->path ? mesh_attachment->path : attachment->name;
+                if (!SetAttachmentRegion(loader, attachment, path, mesh_attachment->sequence))
+                    return false;
+                if (mesh_attachment->region)
+                    spMeshAttachment_updateRegion(mesh_attachment);
+                return true;
+            }
+            default:
+                return true;
+        }
+    }
+
     spDefoldAtlasAttachmentLoader* CreateAttachmentLoader(dmGameSystemDDF::TextureSet* texture_set_ddf, spAtlasRegion* regions)
     {
         spDefoldAtlasAttachmentLoader* self = NEW(spDefoldAtlasAttachmentLoader);
@@ -359,7 +392,7 @@ namespace dmSpine
         spAttachmentLoader_dispose((spAttachmentLoader*)loader);
     }
 
-    spSkeletonData* ReadSkeletonJsonData(spAttachmentLoader* loader, const char* path, void* json_data)
+    spSkeletonData* ReadSkeletonJsonData(spAttachmentLoader* loader, const char* path, const void* json_data, uint32_t json_size)
     {
         spSkeletonJson* skeleton_json = spSkeletonJson_createWithLoader(loader);
         if (!skeleton_json) {
@@ -369,7 +402,7 @@ namespace dmSpine
 
         //DEBUGLOG("%s: %p   json: %p", __FUNCTION__, skeleton_json, json_data);
 
-        spSkeletonData* skeletonData = spSkeletonJson_readSkeletonData(skeleton_json, (const char *)json_data);
+        spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataWithLength(skeleton_json, (const char *)json_data, (int)json_size);
         if (!skeletonData)
         {
             loader->error1 = strdup(skeleton_json->error ? skeleton_json->error : "unknown error");
@@ -381,4 +414,43 @@ namespace dmSpine
         return skeletonData;
     }
 
+    spSkeletonData* ReadSkeletonBinaryData(spAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size)
+    {
+        spSkeletonBinary* skeleton_binary = spSkeletonBinary_createWithLoader(loader);
+        if (!skeleton_binary) {
+            dmLogError("Failed to create spine skeleton for %s", path);
+            return 0;
+        }
+
+        spSkeletonData* skeletonData = spSkeletonBinary_readSkeletonData(skeleton_binary, (const unsigned char*)data, (int)data_size);
+        if (!skeletonData)
+        {
+            loader->error1 = strdup(skeleton_binary->error ? skeleton_binary->error : "unknown error");
+            spSkeletonBinary_dispose(skeleton_binary);
+            dmLogError("Failed to read spine skeleton for %s: %s", path, loader->error1);
+            return 0;
+        }
+        spSkeletonBinary_dispose(skeleton_binary);
+        return skeletonData;
+    }
+
+    static bool EndsWith(const char* str, const char* suffix)
+    {
+        size_t str_len = strlen(str);
+        size_t suffix_len = strlen(suffix);
+        return str_len >= suffix_len && strcmp(str + str_len - suffix_len, suffix) == 0;
+    }
+
+    bool IsSkeletonBinaryPath(const char* path)
+    {
+        return path && (EndsWith(path, ".skel") || EndsWith(path, ".skelc"));
+    }
+
+    spSkeletonData* ReadSkeletonData(spAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size)
+    {
+        if (IsSkeletonBinaryPath(path))
+            return ReadSkeletonBinaryData(loader, path, data, data_size);
+        return ReadSkeletonJsonData(loader, path, data, data_size);
+    }
+
 } // namespace
@@ -10,17 +10,26 @@
 
 #include <float.h>                      // using FLT_MAX
 #include <dmsdk/dlib/math.h>
+#include <dmsdk/dlib/profile.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SPINE_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SPINE_SIMD_NEON
+#endif
 
 namespace dmSpine
 {
     static const uint32_t ATTACHMENT_REGION_NUM_FLOATS = 4*2;
     static const uint16_t QUAD_INDICES[]               = {0, 1, 2, 2, 3, 0};
 
-static inline void addVertex(dmSpine::SpineVertex* vertex, float x, float y, float u, float v, float r, float g, float b, float a, float page_index)
+static inline void addVertex(dmSpine::SpineVertex* vertex, const float* p, float u, float v, float r, float g, float b, float a, float page_index)
 {
-   vertex->x = x;
-   vertex->y = y;
-   vertex->z = 0;
+   vertex->x = p[0];
+   vertex->y = p[1];
+   vertex->z = p[2];
    vertex->u = u;
    vertex->v = v;
    vertex->r = r;
@@ -30,6 +39,29 @@ static inline void addVertex(dmSpine::SpineVertex* vertex, float x, float y, flo
    vertex->page_index = page_index;
 }
 
+static inline uint16_t ToUnorm16(float f)
+{
+    return (uint16_t)(dmMath::Clamp(f, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+static inline uint8_t ToUnorm8(float f)
+{
+    return (uint8_t)(dmMath::Clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+static inline void addVertex(dmSpine::SpineVertexCompact* vertex, const float* p, float u, float v, float r, float g, float b, float a, float page_index)
+{
+   vertex->x = p[0];
+   vertex->y = p[1];
+   vertex->z = p[2];
+   vertex->u = ToUnorm16(u);
+   vertex->v = ToUnorm16(v);
+   vertex->r = ToUnorm8(r);
+   vertex->g = ToUnorm8(g);
+   vertex->b = ToUnorm8(b);
+   vertex->a = ToUnorm8(a);
+}
+
 template <typename T>
 static uint32_t EnsureArrayFitsNumber(dmArray<T>& array, uint32_t num_to_add)
 {
@@ -42,6 +74,19 @@ static uint32_t EnsureArrayFitsNumber(dmArray<T>& array, uint32_t num_to_add)
     return prev_size;
 }
 
+// Grows the array geometrically, so that repeated calls (e.g. once per slot) don't reallocate every time
+template <typename T>
+static uint32_t GrowArrayFitsNumber(dmArray<T>& array, uint32_t num_to_add)
+{
+    if (array.Remaining() < num_to_add)
+    {
+        array.OffsetCapacity(dmMath::Max(num_to_add - array.Remaining(), array.Capacity() / 2));
+    }
+    uint32_t prev_size = array.Size();
+    array.SetSize(prev_size+num_to_add);
+    return prev_size;
+}
+
 template <typename T>
 static void EnsureArraySize(dmArray<T>& array, uint32_t size)
 {
@@ -52,10 +97,11 @@ static void EnsureArraySize(dmArray<T>& array, uint32_t size)
     array.SetSize(size);
 }
 
-void GetSkeletonBounds(const spSkeleton* skeleton, SpineModelBounds& bounds)
+void GetSkeletonBounds(const spSkeleton* skeleton, SpineScratch* scratch_buffers, SpineModelBounds& bounds)
 {
-    dmArray<float> scratch; // scratch buffer
-    EnsureArrayFitsNumber(scratch, ATTACHMENT_REGION_NUM_FLOATS); // this is enough for "SP_ATTACHMENT_REGION"
+    SpineScratch temporary_scratch;
+    dmArray<float>& scratch = (scratch_buffers ? scratch_buffers : &temporary_scratch)->m_VertexFloats;
+    EnsureArraySize(scratch, ATTACHMENT_REGION_NUM_FLOATS); // this is enough for "SP_ATTACHMENT_REGION"
 
     // a "negative" bounding rectangle for starters
     bounds.minX = FLT_MAX;
@@ -102,7 +148,7 @@ void GetSkeletonBounds(const spSkeleton* skeleton, SpineModelBounds& bounds)
 
             num_world_vertices = mesh->super.worldVerticesLength / 2;
 
-            EnsureArrayFitsNumber(scratch, num_world_vertices*2); // increase capacity if needed
+            EnsureArraySize(scratch, num_world_vertices*2); // increase capacity if needed
 
             // Computed the world vertices positions for the vertices that make up
             // the mesh attachment. This assumes the world transform of the
@@ -207,12 +253,13 @@ static void CalcAndAddVertexBufferAttachmentByClipper(dmArray<float>& scratch, s
     *out_vertices = dmMath::Max(*out_vertices, vertex_count);
 }
 
-uint32_t CalcVertexBufferSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, uint32_t* out_vertices)
+uint32_t CalcVertexBufferSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, uint32_t* out_vertices)
 {
     // This scratch buffer is used to calculate number of verties if the skeleton has a clipper attachment
     // We don't know the number of vertices and indices unless we do the actual clipping, so we need somewhere
     // to store the intermediate position floats until clipping is done.
-    dmArray<float> scratch_attachment;
+    SpineScratch temporary_scratch;
+    dmArray<float>& scratch_attachment = (scratch ? scratch : &temporary_scratch)->m_VertexFloats;
     uint32_t vertex_count       = 0;
     uint32_t max_triangle_count = 8;
 
@@ -271,8 +318,7 @@ uint32_t CalcDrawDescCount(const spSkeleton* skeleton)
     {
         spSlot* slot = skeleton->drawOrder[s];
         spAttachment* attachment = slot->attachment;
-        spAttachmentType type = attachment->type;
-        if (attachment && (type == SP_ATTACHMENT_REGION || type == SP_ATTACHMENT_MESH))
+        if (attachment && (attachment->type == SP_ATTACHMENT_REGION || attachment->type == SP_ATTACHMENT_MESH))
         {
             count++;
         }
@@ -280,16 +326,404 @@ uint32_t CalcDrawDescCount(const spSkeleton* skeleton)
     return count;
 }
 
-uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, const dmVMath::Matrix4& world, dmArray<SpineDrawDesc>* draw_descs_out)
+void CalcIndexedVertexDataSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, SpineVertexDataSize* out_size)
 {
-    dmArray<float> scratch_vertex_floats;
-    int vindex                  = vertex_buffer.Size();
-    int vindex_start            = vindex;
-    uint32_t max_triangle_count = 0;
-    uint32_t estimated_vcount   = CalcVertexBufferSize(skeleton, skeleton_clipper, &max_triangle_count);
+    SpineScratch temporary_scratch;
+    dmArray<float>& scratch_vertex_floats = (scratch ? scratch : &temporary_scratch)->m_VertexFloats;
 
-    EnsureArrayFitsNumber(scratch_vertex_floats, max_triangle_count);
-    EnsureArrayFitsNumber(vertex_buffer, estimated_vcount);
+    SpineVertexDataSize size = {};
+    // Same visibility rules as in GenerateVertexDataInternal, so the sizes match its output exactly
+    for (int s = 0; s < skeleton->slotsCount; ++s)
+    {
+        spSlot* slot = skeleton->drawOrder[s];
+        spAttachment* attachment = slot->attachment;
+        if (!attachment || slot->color.a == 0 || !slot->bone->active)
+        {
+            spSkeletonClipping_clipEnd(skeleton_clipper, slot);
+            continue;
+        }
+
+        uint32_t vertex_count  = 0;
+        uint32_t indices_count = 0;
+        uint16_t* indices      = 0;
+        float* uvs             = 0;
+        bool is_clipping       = spSkeletonClipping_isClipping(skeleton_clipper);
+        spAttachmentType type  = attachment->type;
+        if (type == SP_ATTACHMENT_REGION)
+        {
+            spRegionAttachment* region = (spRegionAttachment*)attachment;
+            if (region->color.a == 0)
+            {
+                spSkeletonClipping_clipEnd(skeleton_clipper, slot);
+                continue;
+            }
+            if (is_clipping)
+            {
+                EnsureArraySize(scratch_vertex_floats, ATTACHMENT_REGION_NUM_FLOATS);
+                spRegionAttachment_computeWorldVertices(region, slot, scratch_vertex_floats.Begin(), 0, 2);
+            }
+            vertex_count  = 4;
+            uvs           = region->uvs;
+            indices       = (uint16_t*) QUAD_INDICES;
+            indices_count = 6;
+        }
+        else if (type == SP_ATTACHMENT_MESH)
+        {
+            spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+            if (mesh->color.a == 0)
+            {
+                spSkeletonClipping_clipEnd(skeleton_clipper, slot);
+                continue;
+            }
+            if (is_clipping)
+            {
+                EnsureArraySize(scratch_vertex_floats, mesh->super.worldVerticesLength);
+                spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, mesh->super.worldVerticesLength, scratch_vertex_floats.Begin(), 0, 2);
+            }
+            vertex_count  = SUPER(mesh)->worldVerticesLength / 2;
+            uvs           = mesh->uvs;
+            indices       = mesh->triangles;
+            indices_count = mesh->trianglesCount;
+        }
+        else if (type == SP_ATTACHMENT_CLIPPING)
+        {
+            spSkeletonClipping_clipStart(skeleton_clipper, slot, (spClippingAttachment*) attachment);
+            continue;
+        }
+        else
+        {
+            continue;
+        }
+
+        // Only the clipped attachments need their positions, everything else is known up front
+        if (is_clipping)
+        {
+            spSkeletonClipping_clipTriangles(skeleton_clipper, scratch_vertex_floats.Begin(), vertex_count << 1, indices, indices_count, uvs, 2);
+            vertex_count  = skeleton_clipper->clippedVertices->size >> 1;
+            indices_count = skeleton_clipper->clippedTriangles->size;
+        }
+
+        size.m_VertexCount += vertex_count;
+        size.m_IndexCount  += indices_count;
+        size.m_DrawDescCount++;
+        spSkeletonClipping_clipEnd(skeleton_clipper, slot);
+    }
+    spSkeletonClipping_clipEnd2(skeleton_clipper);
+    *out_size = size;
+}
+
+// Small 4-wide float helpers, used by the world vertex kernels below
+#if defined(SPINE_SIMD_SSE2)
+    typedef __m128 SimdFloat4;
+    static inline SimdFloat4 SimdLoad(const float* p)                               { return _mm_loadu_ps(p); }
+    static inline SimdFloat4 SimdSplat(float f)                                     { return _mm_set1_ps(f); }
+    static inline SimdFloat4 SimdZero()                                             { return _mm_setzero_ps(); }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)   { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { _mm_storeu_ps(p, v); }
+    static inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b)                    { return _mm_min_ps(a, b); }
+    static inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b)                    { return _mm_max_ps(a, b); }
+#elif defined(SPINE_SIMD_NEON)
+    typedef float32x4_t SimdFloat4;
+    static inline SimdFloat4 SimdLoad(const float* p)                               { return vld1q_f32(p); }
+    static inline SimdFloat4 SimdSplat(float f)                                     { return vdupq_n_f32(f); }
+    static inline SimdFloat4 SimdZero()                                             { return vdupq_n_f32(0.0f); }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)   { return vmlaq_f32(c, a, b); }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { vst1q_f32(p, v); }
+    static inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b)                    { return vminq_f32(a, b); }
+    static inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b)                    { return vmaxq_f32(a, b); }
+#else
+    struct SimdFloat4 { float v[4]; };
+    static inline SimdFloat4 SimdLoad(const float* p)                               { SimdFloat4 r = {{p[0], p[1], p[2], p[3]}}; return r; }
+    static inline SimdFloat4 SimdSplat(float f)                                     { SimdFloat4 r = {{f, f, f, f}}; return r; }
+    static inline SimdFloat4 SimdZero()                                             { return SimdSplat(0.0f); }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)
+    {
+        SimdFloat4 r = {{a.v[0]*b.v[0] + c.v[0], a.v[1]*b.v[1] + c.v[1], a.v[2]*b.v[2] + c.v[2], a.v[3]*b.v[3] + c.v[3]}};
+        return r;
+    }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3]; }
+    static inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b)
+    {
+        SimdFloat4 r = {{dmMath::Min(a.v[0], b.v[0]), dmMath::Min(a.v[1], b.v[1]), dmMath::Min(a.v[2], b.v[2]), dmMath::Min(a.v[3], b.v[3])}};
+        return r;
+    }
+    static inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b)
+    {
+        SimdFloat4 r = {{dmMath::Max(a.v[0], b.v[0]), dmMath::Max(a.v[1], b.v[1]), dmMath::Max(a.v[2], b.v[2]), dmMath::Max(a.v[3], b.v[3])}};
+        return r;
+    }
+#endif
+
+// The x axis, y axis and translation columns of the component world transform
+struct WorldColumns
+{
+    SimdFloat4 m_X;
+    SimdFloat4 m_Y;
+    SimdFloat4 m_T;
+};
+
+static void GetWorldColumns(const dmVMath::Matrix4& world, WorldColumns* out)
+{
+    float cols[3][4];
+    for (int i = 0; i < 3; ++i)
+    {
+        cols[0][i] = world.getElem(0, i);
+        cols[1][i] = world.getElem(1, i);
+        cols[2][i] = world.getElem(3, i);
+    }
+    cols[0][3] = cols[1][3] = cols[2][3] = 0.0f;
+    out->m_X = SimdLoad(cols[0]);
+    out->m_Y = SimdLoad(cols[1]);
+    out->m_T = SimdLoad(cols[2]);
+}
+
+static inline void SetWorldTransform(SpineBoneTransform* out, const WorldColumns& world, float a, float b, float c, float d, float x, float y)
+{
+    SimdStore(out->m_Cols[0], SimdMulAdd(world.m_Y, SimdSplat(c), SimdMulAdd(world.m_X, SimdSplat(a), SimdZero())));
+    SimdStore(out->m_Cols[1], SimdMulAdd(world.m_Y, SimdSplat(d), SimdMulAdd(world.m_X, SimdSplat(b), SimdZero())));
+    SimdStore(out->m_Cols[2], SimdMulAdd(world.m_Y, SimdSplat(y), SimdMulAdd(world.m_X, SimdSplat(x), world.m_T)));
+}
+
+// Only done for the bones of the region and unweighted mesh attachments, which are usually far fewer than all the bones
+static inline void SetWorldBoneTransform(SpineBoneTransform* out, const WorldColumns& world, const spBone* bone)
+{
+    SetWorldTransform(out, world, bone->a, bone->b, bone->c, bone->d, bone->worldX, bone->worldY);
+}
+
+// Transforms a skeleton space (x, y) into world space (x, y, z, pad)
+static inline void TransformToWorld(const WorldColumns& world, float x, float y, float* out)
+{
+    SimdStore(out, SimdMulAdd(world.m_Y, SimdSplat(y), SimdMulAdd(world.m_X, SimdSplat(x), world.m_T)));
+}
+
+// Transforms 'count' (x, y) pairs into world space (x, y, z) with a stride of 4 floats.
+// The output must have room for 4 * count floats.
+static void TransformVertices(const SpineBoneTransform& transform, const float* vertices, uint32_t count, float* out)
+{
+    const SimdFloat4 col0 = SimdLoad(transform.m_Cols[0]);
+    const SimdFloat4 col1 = SimdLoad(transform.m_Cols[1]);
+    const SimdFloat4 col2 = SimdLoad(transform.m_Cols[2]);
+    for (uint32_t i = 0; i < count; ++i, vertices += 2, out += 4)
+    {
+        SimdStore(out, SimdMulAdd(col1, SimdSplat(vertices[1]), SimdMulAdd(col0, SimdSplat(vertices[0]), col2)));
+    }
+}
+
+// Same as spRegionAttachment_computeWorldVertices, with the world transform applied
+static void ComputeRegionWorldVertices(spRegionAttachment* region, spSlot* slot, const WorldColumns& world, float* out)
+{
+    if (region->sequence)
+    {
+        spSequence_apply(region->sequence, slot, SUPER(region));
+    }
+
+    // Output order is br, bl, ul, ur (see spVertexIndex in RegionAttachment.c)
+    const float* offsets = region->offset;
+    float vertices[ATTACHMENT_REGION_NUM_FLOATS] = { offsets[6], offsets[7], offsets[0], offsets[1], offsets[2], offsets[3], offsets[4], offsets[5] };
+    SpineBoneTransform transform;
+    SetWorldBoneTransform(&transform, world, slot->bone);
+    TransformVertices(transform, vertices, 4, out);
+}
+
+// Same as spVertexAttachment_computeWorldVertices, with the world transform applied
+static void ComputeMeshWorldVertices(spMeshAttachment* mesh, spSlot* slot, const WorldColumns& world, float* out)
+{
+    if (mesh->sequence)
+    {
+        spSequence_apply(mesh->sequence, slot, SUPER(SUPER(mesh)));
+    }
+
+    const spVertexAttachment* attachment = SUPER(mesh);
+    const uint32_t vertex_count = attachment->worldVerticesLength / 2;
+    const float* vertices       = attachment->vertices;
+    const float* deform         = slot->deformCount > 0 ? slot->deform : 0;
+    const int* bones            = attachment->bones;
+
+    if (!bones)
+    {
+        SpineBoneTransform transform;
+        SetWorldBoneTransform(&transform, world, slot->bone);
+        TransformVertices(transform, deform ? deform : vertices, vertex_count, out);
+        return;
+    }
+
+    // Weighted vertices: 'bones' is a list of [count, bone index...] per vertex,
+    // and 'vertices' holds an (x, y, weight) triple for each bone influence.
+    // The weighted sum is done in skeleton space (two lanes wouldn't gain anything from the 4-wide helpers),
+    // and the world transform once per vertex.
+    spBone** skeleton_bones = slot->bone->skeleton->bones;
+    int v = 0;
+    int b = 0;
+    if (!deform)
+    {
+        for (uint32_t i = 0; i < vertex_count; ++i, out += 4)
+        {
+            float wx = 0.0f;
+            float wy = 0.0f;
+            int n = bones[v++];
+            n += v;
+            for (; v < n; v++, b += 3)
+            {
+                const spBone* bone = skeleton_bones[bones[v]];
+                float vx = vertices[b], vy = vertices[b + 1], weight = vertices[b + 2];
+                wx += (vx * bone->a + vy * bone->b + bone->worldX) * weight;
+                wy += (vx * bone->c + vy * bone->d + bone->worldY) * weight;
+            }
+            TransformToWorld(world, wx, wy, out);
+        }
+        return;
+    }
+
+    int f = 0;
+    for (uint32_t i = 0; i < vertex_count; ++i, out += 4)
+    {
+        float wx = 0.0f;
+        float wy = 0.0f;
+        int n = bones[v++];
+        n += v;
+        for (; v < n; v++, b += 3, f += 2)
+        {
+            const spBone* bone = skeleton_bones[bones[v]];
+            float vx = vertices[b] + deform[f], vy = vertices[b + 1] + deform[f + 1], weight = vertices[b + 2];
+            wx += (vx * bone->a + vy * bone->b + bone->worldX) * weight;
+            wy += (vx * bone->c + vy * bone->d + bone->worldY) * weight;
+        }
+        TransformToWorld(world, wx, wy, out);
+    }
+}
+
+void UpdateWorldVertexCache(SpineWorldVertexCache& cache, const spSkeleton* skeleton, const dmVMath::Matrix4& world)
+{
+    WorldColumns world_columns;
+    GetWorldColumns(world, &world_columns);
+
+    EnsureArraySize(cache.m_Slots, (uint32_t)skeleton->slotsCount);
+    cache.m_Positions.SetSize(0);
+    cache.m_VertexCount = 0;
+    cache.m_IndexCount  = 0;
+
+    for (int s = 0; s < skeleton->slotsCount; ++s)
+    {
+        spSlot* slot = skeleton->slots[s];
+        SpineVertexCacheSlot& entry = cache.m_Slots[slot->data->index];
+        entry.m_Attachment  = 0;
+        entry.m_VertexStart = 0;
+
+        // Same visibility rules as in GenerateVertexDataInternal
+        spAttachment* attachment = slot->attachment;
+        if (!attachment || slot->color.a == 0 || !slot->bone->active)
+        {
+            continue;
+        }
+
+        uint32_t vertex_count = 0;
+        uint32_t index_count  = 0;
+        if (attachment->type == SP_ATTACHMENT_REGION)
+        {
+            spRegionAttachment* region = (spRegionAttachment*)attachment;
+            if (region->color.a == 0)
+            {
+                continue;
+            }
+            vertex_count = 4;
+            index_count  = 6;
+            uint32_t start = GrowArrayFitsNumber(cache.m_Positions, vertex_count * 4);
+            ComputeRegionWorldVertices(region, slot, world_columns, cache.m_Positions.Begin() + start);
+        }
+        else if (attachment->type == SP_ATTACHMENT_MESH)
+        {
+            spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+            if (mesh->color.a == 0)
+            {
+                continue;
+            }
+            vertex_count = SUPER(mesh)->worldVerticesLength / 2;
+            index_count  = mesh->trianglesCount;
+            uint32_t start = GrowArrayFitsNumber(cache.m_Positions, vertex_count * 4);
+            ComputeMeshWorldVertices(mesh, slot, world_columns, cache.m_Positions.Begin() + start);
+        }
+        else
+        {
+            continue;
+        }
+
+        entry.m_Attachment  = attachment;
+        entry.m_VertexStart = cache.m_VertexCount;
+        cache.m_VertexCount += vertex_count;
+        cache.m_IndexCount  += index_count;
+    }
+
+    float bounds_min[4];
+    float bounds_max[4];
+    if (cache.m_VertexCount > 0)
+    {
+        SimdFloat4 vmin = SimdSplat(FLT_MAX);
+        SimdFloat4 vmax = SimdSplat(-FLT_MAX);
+        const float* p = cache.m_Positions.Begin();
+        for (uint32_t i = 0; i < cache.m_VertexCount; ++i, p += 4)
+        {
+            SimdFloat4 v = SimdLoad(p);
+            vmin = SimdMin(vmin, v);
+            vmax = SimdMax(vmax, v);
+        }
+        SimdStore(bounds_min, vmin);
+        SimdStore(bounds_max, vmax);
+    }
+    else
+    {
+        // Nothing visible, use an empty box at the origin of the component
+        SimdStore(bounds_min, world_columns.m_T);
+        SimdStore(bounds_max, world_columns.m_T);
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        cache.m_Min[i] = bounds_min[i];
+        cache.m_Max[i] = bounds_max[i];
+    }
+}
+
+static const float* GetCachedPositions(const SpineWorldVertexCache* cache, const spSlot* slot, const spAttachment* attachment)
+{
+    if (!cache)
+    {
+        return 0;
+    }
+    uint32_t index = (uint32_t)slot->data->index;
+    if (index >= cache->m_Slots.Size())
+    {
+        return 0;
+    }
+    // The attachment may have changed since the cache was updated
+    const SpineVertexCacheSlot& entry = cache->m_Slots[index];
+    if (entry.m_Attachment != attachment)
+    {
+        return 0;
+    }
+    return cache->m_Positions.Begin() + entry.m_VertexStart * 4;
+}
+
+// If the index buffer is set, each unique vertex is written once, and referenced by the indices.
+// Otherwise, the vertices are output as a list of triangles
+template <typename VERTEX>
+static uint32_t GenerateVertexDataInternal(dmArray<VERTEX>& vertex_buffer, dmArray<uint32_t>* index_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, const SpineWorldVertexCache* cache, dmArray<SpineDrawDesc>* draw_descs_out, SpineVertexStats* stats)
+{
+    // We don't know the final vertex count until we've done the clipping, so instead of
+    // doing a separate counting pass (which would clip everything twice), we grow the buffer as we go
+    SpineScratch temporary_scratch;
+    if (!scratch)
+    {
+        scratch = &temporary_scratch;
+    }
+    dmArray<float>& scratch_vertex_floats           = scratch->m_VertexFloats;
+    dmArray<float>& scratch_world_positions         = scratch->m_WorldPositions;
+    uint32_t vindex_start       = vertex_buffer.Size();
+
+    WorldColumns world_columns;
+    GetWorldColumns(world, &world_columns);
+
+    SpineBoneTransform world_transform; // Used for the (already skeleton space) clipped vertices
+    SetWorldTransform(&world_transform, world_columns, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
 
     // For each slot in the draw order array of the skeleton
     for (int s = 0; s < skeleton->slotsCount; ++s)
@@ -313,7 +747,6 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
             continue;
         }
 
-        uint32_t batch_vindex_start = vindex;
         const spColor* skeleton_color = &skeleton->color;
         // Calculate the tinting color based on the skeleton's color
         // and the slot's color. Each color channel is given in the
@@ -330,7 +763,8 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
         uint32_t vertex_count  = 0;
         uint32_t indices_count = 0;
         float* uvs             = 0;
-        float* vertices        = 0;
+        bool is_clipping       = spSkeletonClipping_isClipping(skeleton_clipper);
+        const float* positions = is_clipping ? 0 : GetCachedPositions(cache, slot, attachment);
         spAttachmentType type = attachment->type;
         // Fill the vertices array depending on the type of attachment
         //Texture* texture = 0;
@@ -349,14 +783,23 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
             // the rectangular region attachment. This assumes the world transform of the
             // bone to which the slot (and hence attachment) is attached has been calculated
             // before rendering via spSkeleton_updateWorldTransform
-            spRegionAttachment_computeWorldVertices(regionAttachment, slot, scratch_vertex_floats.Begin(), 0, 2);
+            if (is_clipping)
+            {
+                EnsureArraySize(scratch_vertex_floats, ATTACHMENT_REGION_NUM_FLOATS);
+                spRegionAttachment_computeWorldVertices(regionAttachment, slot, scratch_vertex_floats.Begin(), 0, 2);
+            }
+            else if (!positions)
+            {
+                EnsureArraySize(scratch_world_positions, 4 * 4);
+                ComputeRegionWorldVertices(regionAttachment, slot, world_columns, scratch_world_positions.Begin());
+                positions = scratch_world_positions.Begin();
+            }
 
             vertex_count  = 4;
             uvs           = regionAttachment->uvs;
             indices       = (uint16_t*) QUAD_INDICES;
             indices_count = 6;
             color         = attachment_color;
-            vertices      = scratch_vertex_floats.Begin();
         }
         else if (type == SP_ATTACHMENT_MESH)
         {
@@ -369,15 +812,25 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
                 spSkeletonClipping_clipEnd(skeleton_clipper, slot);
                 continue;
             }
-            
-            spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, mesh->super.worldVerticesLength, scratch_vertex_floats.Begin(), 0, 2);
 
-            vertex_count  = SUPER(mesh)->worldVerticesLength / 2;
+            vertex_count = SUPER(mesh)->worldVerticesLength / 2;
+            if (is_clipping)
+            {
+                EnsureArraySize(scratch_vertex_floats, mesh->super.worldVerticesLength);
+                spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, mesh->super.worldVerticesLength, scratch_vertex_floats.Begin(), 0, 2);
+            }
+            else if (!positions)
+            {
+                EnsureArraySize(scratch_world_positions, vertex_count * 4);
+                ComputeMeshWorldVertices(mesh, slot, world_columns, scratch_world_positions.Begin());
+                positions = scratch_world_positions.Begin();
+            }
+
+            // Read after computing the vertices, since a sequence may update the uvs
             uvs           = mesh->uvs;
             indices       = mesh->triangles;
             indices_count = mesh->trianglesCount;
             color         = attachment_color;
-            vertices      = scratch_vertex_floats.Begin();
         }
         else if (type == SP_ATTACHMENT_CLIPPING)
         {
@@ -392,15 +845,25 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
             continue;
         }
 
-        if (spSkeletonClipping_isClipping(skeleton_clipper))
+        if (is_clipping)
         {
-            spSkeletonClipping_clipTriangles(skeleton_clipper, vertices, vertex_count << 1, indices, indices_count, uvs, 2);
+            DM_PROFILE("Clipping");
+            spSkeletonClipping_clipTriangles(skeleton_clipper, scratch_vertex_floats.Begin(), vertex_count << 1, indices, indices_count, uvs, 2);
 
-            vertices      = skeleton_clipper->clippedVertices->items;
             vertex_count  = skeleton_clipper->clippedVertices->size >> 1;
             uvs           = skeleton_clipper->clippedUVs->items;
             indices       = skeleton_clipper->clippedTriangles->items;
             indices_count = skeleton_clipper->clippedTriangles->size;
+
+            EnsureArraySize(scratch_world_positions, vertex_count * 4);
+            TransformVertices(world_transform, skeleton_clipper->clippedVertices->items, vertex_count, scratch_world_positions.Begin());
+            positions = scratch_world_positions.Begin();
+
+            if (stats)
+            {
+                stats->m_ClipPasses++;
+                stats->m_ClippedTriangles += indices_count / 3;
+            }
         }
 
         const float colorR = tintR * color->r;
@@ -408,18 +871,53 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
         const float colorB = tintB * color->b;
         const float colorA = tintA * color->a;
 
-        for (int i = 0; i < indices_count; ++i)
+        uint32_t batch_vindex_start = 0;
+        uint32_t batch_vertex_count = 0;
+        uint32_t batch_iindex_start = 0;
+        uint32_t batch_index_count  = 0;
+        if (index_buffer)
+        {
+            batch_vertex_count = vertex_count;
+            batch_vindex_start = GrowArrayFitsNumber(vertex_buffer, vertex_count);
+            VERTEX* vertex = vertex_buffer.Begin() + batch_vindex_start;
+            for (uint32_t i = 0; i < vertex_count; ++i)
+            {
+                uint32_t index = i << 1;
+                addVertex(vertex++, positions + (i << 2), uvs[index], uvs[index + 1], colorR, colorG, colorB, colorA, page_index);
+            }
+
+            batch_index_count  = indices_count;
+            batch_iindex_start = GrowArrayFitsNumber(*index_buffer, indices_count);
+            uint32_t* index = index_buffer->Begin() + batch_iindex_start;
+            for (uint32_t i = 0; i < indices_count; ++i)
+            {
+                *index++ = batch_vindex_start + indices[i];
+            }
+        }
+        else
         {
-            int index = indices[i] << 1;
-            addVertex(&vertex_buffer[vindex++], vertices[index], vertices[index + 1], uvs[index], uvs[index + 1], colorR, colorG, colorB, colorA, page_index);
+            batch_vertex_count = indices_count;
+            batch_vindex_start = GrowArrayFitsNumber(vertex_buffer, indices_count);
+            VERTEX* vertex = vertex_buffer.Begin() + batch_vindex_start;
+            for (uint32_t i = 0; i < indices_count; ++i)
+            {
+                int index = indices[i] << 1;
+                addVertex(vertex++, positions + (indices[i] << 2), uvs[index], uvs[index + 1], colorR, colorG, colorB, colorA, page_index);
+            }
         }
 
         if (draw_descs_out)
         {
             SpineDrawDesc desc = {};
             desc.m_VertexStart = batch_vindex_start;
+            desc.m_VertexCount = batch_vertex_count;
+            desc.m_IndexStart  = batch_iindex_start;
+            desc.m_IndexCount  = batch_index_count;
             desc.m_BlendMode   = (uint32_t) slot->data->blendMode;
-            desc.m_VertexCount = vindex - batch_vindex_start;
+            if (draw_descs_out->Full())
+            {
+                draw_descs_out->OffsetCapacity(dmMath::Max(16U, draw_descs_out->Capacity() / 2));
+            }
             draw_descs_out->Push(desc);
         }
         spSkeletonClipping_clipEnd(skeleton_clipper, slot);
@@ -427,31 +925,32 @@ uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleto
 
     spSkeletonClipping_clipEnd2(skeleton_clipper);
 
-    const dmVMath::Matrix4& w = world;
-
-    uint32_t vcount = vertex_buffer.Size() - vindex_start;
-    if (vcount)
+    uint32_t vertex_count = vertex_buffer.Size() - vindex_start;
+    if (stats)
     {
-        SpineVertex* vb = &vertex_buffer[vindex_start];
-        for (uint32_t i = 0; i < vcount; ++i)
-        {
-            SpineVertex* vertex = &vb[i];
-            const dmVMath::Vector4 p = w * dmVMath::Point3(vertex->x, vertex->y, vertex->z);
-            vertex->x = p.getX();
-            vertex->y = p.getY();
-            vertex->z = p.getZ();
-        }
-
-        assert(vcount == estimated_vcount);
+        stats->m_Vertices += vertex_count;
     }
+    return vertex_count;
+}
 
-    return vcount;
+uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, dmArray<SpineDrawDesc>* draw_descs_out, SpineVertexStats* stats)
+{
+    return GenerateVertexDataInternal(vertex_buffer, 0, skeleton, skeleton_clipper, scratch, world, 0, draw_descs_out, stats);
+}
+
+uint32_t GenerateIndexedVertexData(dmArray<SpineVertex>& vertex_buffer, dmArray<uint32_t>& index_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, const SpineWorldVertexCache* cache, dmArray<SpineDrawDesc>* draw_descs_out, SpineVertexStats* stats)
+{
+    return GenerateVertexDataInternal(vertex_buffer, &index_buffer, skeleton, skeleton_clipper, scratch, world, cache, draw_descs_out, stats);
+}
+
+uint32_t GenerateIndexedVertexData(dmArray<SpineVertexCompact>& vertex_buffer, dmArray<uint32_t>& index_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, const SpineWorldVertexCache* cache, dmArray<SpineDrawDesc>* draw_descs_out, SpineVertexStats* stats)
+{
+    return GenerateVertexDataInternal(vertex_buffer, &index_buffer, skeleton, skeleton_clipper, scratch, world, cache, draw_descs_out, stats);
 }
 
 void MergeDrawDescs(const dmArray<SpineDrawDesc>& src, dmArray<SpineDrawDesc>& dst)
 {
-    dst.SetCapacity(src.Size());
-    dst.SetSize(src.Size());
+    EnsureArraySize(dst, src.Size());
 
     if (src.Size() == 0)
     {
@@ -468,6 +967,7 @@ void MergeDrawDescs(const dmArray<SpineDrawDesc>& src, dmArray<SpineDrawDesc>& d
         if (current_draw_desc->m_BlendMode == src[i].m_BlendMode)
         {
             current_draw_desc->m_VertexCount += src[i].m_VertexCount;
+            current_draw_desc->m_IndexCount += src[i].m_IndexCount;
         }
         else
         {
@@ -54,6 +54,7 @@
 (def spine-material-path "/defold-spine/assets/spine.material")
 
 (def spine-json-ext "spinejson")
+(def spine-binary-ext "skel") ; Binary exports, used in the same way as the .spinejson files
 (def spine-scene-ext "spinescene")
 (def spine-model-ext "spinemodel")
 
@@ -74,6 +75,7 @@
 (def spine-plugin-pointer-cls (workspace/load-class! "com.dynamo.bob.pipeline.Spine$SpinePointer"))
 (def spine-plugin-aabb-cls (workspace/load-class! "com.dynamo.bob.pipeline.Spine$AABB"))
 (def spine-plugin-blendmode-cls (workspace/load-class! "com.dynamo.spine.proto.Spine$SpineModelDesc$BlendMode"))
+(def spine-plugin-offscreenupdate-cls (workspace/load-class! "com.dynamo.spine.proto.Spine$SpineModelDesc$OffscreenUpdate"))
 (def spine-plugin-spinescene-cls (workspace/load-class! "com.dynamo.spine.proto.Spine$SpineSceneDesc"))
 (def spine-plugin-spinemodel-cls (workspace/load-class! "com.dynamo.spine.proto.Spine$SpineModelDesc"))
 
@@ -150,8 +152,9 @@
 
 (defn- is-spine-scene-json-name? [resource prop-name]
   (let [path (resource/resource->proj-path resource)]
-    (when (not (str/ends-with? path spine-json-ext))
-      (format "%s file '%s' doesn't end with '.%s'" prop-name path spine-json-ext))))
+    (when (not (or (str/ends-with? path (str "." spine-json-ext))
+                   (str/ends-with? path (str "." spine-binary-ext))))
+      (format "%s file '%s' doesn't end with '.%s' or '.%s'" prop-name path spine-json-ext spine-binary-ext))))
 
 (defn- validate-scene-spine-json [_node-id spine-json]
   (or (prop-resource-error :fatal _node-id :spine-json spine-json "Spine Json")
@@ -181,10 +184,11 @@
 ;;         (get spine-scene "bones")))
 
 
-(g/defnk produce-spine-scene-pb [_node-id spine-json atlas]
+(g/defnk produce-spine-scene-pb [_node-id spine-json atlas sample-rate]
   (protobuf/make-map-without-defaults spine-plugin-spinescene-cls
     :spine-json (resource/resource->proj-path spine-json)
-    :atlas (resource/resource->proj-path atlas)))
+    :atlas (resource/resource->proj-path atlas)
+    :sample-rate sample-rate))
 
 ;; (defn- transform-positions [^Matrix4d transform mesh]
 ;;   (let [p (Point3d.)]
@@ -571,7 +575,7 @@
       :else
       (g/->error node-id :resource :fatal resource (format "Couldn't read %s file %s: %s" spine-json-ext path msg)))))
 
-; Loads the .spinejson file
+; Loads the .spinejson or .skel file
 (defn- load-spine-json
   ([node-id resource]
    (load-spine-json nil node-id resource))
@@ -637,10 +641,6 @@
     (catch Exception error
       (handle-read-error error _node-id spine-json-resource))))
 
-(defn- sanitize-spine-scene [spine-scene-desc]
-  {:pre [(map? spine-scene-desc)]}                          ; Spine$SpineSceneDesc in map format.
-  (dissoc spine-scene-desc :sample-rate))                   ; Deprecated field.
-
 (defn- load-spine-scene [project self resource spine-scene-desc]
   {:pre [(map? spine-scene-desc)]}                          ; Spine$SpineSceneDesc in map format.
   (let [resolve-resource #(workspace/resolve-resource resource %)
@@ -650,7 +650,8 @@
       (g/set-property self :material default-material-resource)
       (gu/set-properties-from-pb-map self spine-plugin-spinescene-cls spine-scene-desc
         spine-json (resolve-resource :spine-json)
-        atlas (resolve-resource :atlas)))))
+        atlas (resolve-resource :atlas)
+        sample-rate :sample-rate))))
 
 ;; (defn- make-spine-skeleton-scene [_node-id aabb gpu-texture scene-structure]
 ;;   (let [scene {:node-id _node-id :aabb aabb}]
@@ -671,9 +672,11 @@
                                  (make-spine-outline-scene _node-id aabb)])
     {:node-id _node-id :aabb aabb}))
 
-(g/defnk produce-spine-scene-save-value [spine-json-resource atlas-resource]
-  {:spine-json (resource/resource->proj-path spine-json-resource)
-   :atlas (resource/resource->proj-path atlas-resource)})
+(g/defnk produce-spine-scene-save-value [spine-json-resource atlas-resource sample-rate]
+  (protobuf/make-map-without-defaults spine-plugin-spinescene-cls
+    :spine-json (resource/resource->proj-path spine-json-resource)
+    :atlas (resource/resource->proj-path atlas-resource)
+    :sample-rate sample-rate))
 
 
 (g/defnk produce-spine-scene-own-build-errors [_node-id atlas spine-json texture-set-pb spine-json-content]
@@ -725,7 +728,7 @@
                                             [:bones :bones]
                                             [:node-outline :source-outline]
                                             [:build-targets :dep-build-targets])))
-            (dynamic edit-type (g/constantly {:type resource/Resource :ext spine-json-ext}))
+            (dynamic edit-type (g/constantly {:type resource/Resource :ext [spine-json-ext spine-binary-ext]}))
             (dynamic error (g/fnk [_node-id spine-json]
                              (validate-scene-spine-json _node-id spine-json))))
 
@@ -741,6 +744,8 @@
             (dynamic error (g/fnk [_node-id atlas]
                              (validate-scene-atlas _node-id atlas))))
 
+  (property sample-rate g/Num (default (float 30.0)))
+
   ; This property isn't visible, but here to allow us to preview the .spinescene
   (property material resource/Resource
             (value (gu/passthrough material-resource))
@@ -794,7 +799,7 @@
 
 ;;//////////////////////////////////////////////////////////////////////////////////////////////
 
-(g/defnk produce-model-pb [spine-scene-resource blend-mode default-animation skin material-resource create-go-bones playback-rate offset]
+(g/defnk produce-model-pb [spine-scene-resource blend-mode default-animation skin material-resource create-go-bones playback-rate offset offscreen-update baked]
   (protobuf/make-map-without-defaults spine-plugin-spinemodel-cls
     :spine-scene (resource/resource->proj-path spine-scene-resource)
     :default-animation default-animation
@@ -803,7 +808,9 @@
     :blend-mode blend-mode
     :create-go-bones create-go-bones
     :playback-rate playback-rate
-    :offset offset))
+    :offset offset
+    :offscreen-update offscreen-update
+    :baked baked))
 
 (defn ->skin-choicebox [spine-skins]
   (properties/->choicebox (cons "" (remove (partial = "default") spine-skins))))
@@ -875,7 +882,9 @@
         material (resolve-resource (:material :or spine-material-path))
         create-go-bones :create-go-bones
         playback-rate :playback-rate
-        offset :offset))))
+        offset :offset
+        offscreen-update :offscreen-update
+        baked :baked))))
 
 (defn- step-animation
   [state dt spine-data-handle animation skin]
@@ -942,6 +951,9 @@
                                               :min 0.0
                                               :max 1.0
                                               :precision 0.01})))
+  (property offscreen-update g/Any (default :offscreen-update-full)
+            (dynamic edit-type (g/constantly (properties/->pb-choicebox spine-plugin-offscreenupdate-cls))))
+  (property baked g/Bool (default false))
 
   (input spine-json-resource resource/Resource)
   (input atlas-resource resource/Resource)
@@ -1016,7 +1028,6 @@
       :label "Spine Scene"
       :node-type SpineSceneNode
       :ddf-type spine-plugin-spinescene-cls
-      :sanitize-fn sanitize-spine-scene
       :load-fn load-spine-scene
       :icon spine-scene-icon
       :view-types [:scene :text]
@@ -1040,6 +1051,12 @@
       :textual? true
       :load-fn load-spine-json
       :icon spine-json-icon
+      :view-types [:default])
+    (workspace/register-resource-type workspace
+      :ext spine-binary-ext
+      :node-type SpineSceneJson
+      :load-fn load-spine-json
+      :icon spine-json-icon
       :view-types [:default])))
 
 ; The plugin
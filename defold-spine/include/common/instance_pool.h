@@ -0,0 +1,49 @@
+#ifndef DM_SPINE_INSTANCE_POOL_H
+#define DM_SPINE_INSTANCE_POOL_H
+
+#include <stdint.h>
+#include <dmsdk/dlib/array.h>
+
+#include <common/spine_alloc.h>
+
+struct spSkeleton;
+struct spSkeletonData;
+struct spAnimationState;
+struct spAnimationStateData;
+
+namespace dmSpine
+{
+    // The spine objects of a spine model, allocated together from one arena
+    struct SpineInstance
+    {
+        spArena*            m_Arena;
+        spSkeleton*         m_Skeleton;
+        spAnimationState*   m_AnimationState;
+    };
+
+    // The instances of a spine scene that were released by destroyed spine models, reset to the state of new instances
+    struct SpineInstancePool
+    {
+        dmArray<SpineInstance>  m_Free;
+        InstanceArenaPool       m_Arenas;
+        uint32_t                m_MaxFreeCount;     // spine.instance_pool_size. 0 disables the pooling
+        uint32_t                m_PrewarmCount;     // spine.instance_pool_prewarm
+    };
+
+    // Sets the pool size and the number of instances created by PrewarmInstancePool()
+    void SetInstancePoolSize(SpineInstancePool* pool, uint32_t max_free_count, uint32_t prewarm_count);
+
+    // Takes an instance from the pool, or creates a new one. The skeleton or the animation state is 0 if it couldn't be created.
+    void AcquireInstance(SpineInstancePool* pool, spSkeletonData* skeleton_data, spAnimationStateData* state_data, SpineInstance* out);
+    // Resets the instance and returns it to the pool, or disposes it if the pool is full or if the instance was
+    // created from other skeleton data (e.g. after a reload)
+    void ReleaseInstance(SpineInstancePool* pool, spSkeletonData* skeleton_data, SpineInstance* instance);
+
+    // Creates the prewarmed instances, when the spine scene is loaded
+    void PrewarmInstancePool(SpineInstancePool* pool, spSkeletonData* skeleton_data, spAnimationStateData* state_data);
+    // Disposes the pooled instances, e.g. before the skeleton data is reloaded
+    void FlushInstancePool(SpineInstancePool* pool);
+    void DestroyInstancePool(SpineInstancePool* pool);
+}
+
+#endif // DM_SPINE_INSTANCE_POOL_H
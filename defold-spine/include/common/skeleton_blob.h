@@ -0,0 +1,34 @@
+#ifndef DM_SPINE_SKELETON_BLOB_H
+#define DM_SPINE_SKELETON_BLOB_H
+
+#include <stdint.h>
+
+struct spSkeletonData;
+
+namespace dmSpine
+{
+    struct spDefoldAtlasAttachmentLoader;
+
+    // A precompiled skeleton ("skeleton blob") holds the whole spSkeletonData object graph, written at build time from the
+    // loaded .spinejson/.skel data, and loaded with a single allocation and one pass over the objects, instead of being parsed.
+    // The format doesn't depend on the struct layout of the platform that wrote it (see skeleton_blob.cpp), so bob can
+    // precompile it for all targets. A blob written by another version of the extension is rejected, and the skeleton is then parsed
+    // from the json instead, which is bundled next to it.
+
+    // Returns a buffer allocated with malloc(), or 0 if the skeleton data couldn't be written
+    void*           WriteSkeletonBlob(spSkeletonData* skeleton_data, uint32_t* out_size);
+
+    bool            IsSkeletonBlob(const void* data, uint32_t data_size);
+
+    // Returns true if the blob was written with the same format version, so that it can be loaded
+    bool            IsSkeletonBlobCompatible(const void* data, uint32_t data_size);
+
+    // Creates the skeleton data from the blob, and binds the atlas regions of the attachments.
+    // The data doesn't need to be aligned, and isn't used after the call.
+    spSkeletonData* LoadSkeletonBlob(spDefoldAtlasAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size);
+
+    // Frees the skeleton data returned by LoadSkeletonBlob()
+    void            DisposeSkeletonBlob(spSkeletonData* skeleton_data);
+}
+
+#endif // DM_SPINE_SKELETON_BLOB_H
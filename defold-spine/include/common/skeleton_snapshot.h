@@ -0,0 +1,14 @@
+#ifndef DM_SPINE_SKELETON_SNAPSHOT_H
+#define DM_SPINE_SKELETON_SNAPSHOT_H
+
+struct spSkeleton;
+
+namespace dmSpine
+{
+    // Copies the state that the vertex generation reads (the bone world transforms, the slot attachments, colors
+    // and deforms, and the draw order) to a skeleton created from the same skeleton data. The attachments are
+    // shared, so the snapshot is only valid as long as the skins of the source skeleton are.
+    void CopySkeletonPose(spSkeleton* snapshot, const spSkeleton* skeleton);
+}
+
+#endif // DM_SPINE_SKELETON_SNAPSHOT_H
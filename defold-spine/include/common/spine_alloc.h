@@ -0,0 +1,40 @@
+#ifndef DM_SPINE_ALLOC_H
+#define DM_SPINE_ALLOC_H
+
+#include <stdint.h>
+#include <dmsdk/dlib/array.h>
+
+struct spArena;
+
+namespace dmSpine
+{
+    // Routes the allocations of the spine runtime through counting wrappers (see _spSetMalloc).
+    // Does nothing in release builds, where the counts stay at 0.
+    void        InstallAllocationCounter();
+    void        UninstallAllocationCounter();
+
+    // The number of allocations (malloc, calloc and realloc) and frees made by the spine runtime since it was installed.
+    // Sample them once per frame to find allocations in the steady state.
+    uint32_t    GetAllocationCount();
+    uint32_t    GetFreeCount();
+
+    // A pool of arenas (see spArena in spine/extension.h) for the skeleton instances of a spine scene. Each instance gets
+    // one arena for its spSkeleton and spAnimationState, sized after the largest instance so far.
+    struct InstanceArenaPool
+    {
+        dmArray<spArena*>   m_Free;
+        uint32_t            m_ArenaSize;
+    };
+
+    // The spine objects created between these calls (on this thread) are allocated from the returned arena
+    spArena*    BeginInstanceAllocations(InstanceArenaPool* pool);
+    void        EndInstanceAllocations(InstanceArenaPool* pool, spArena* arena);
+
+    // The spine objects allocated from the arena are disposed between these calls. The arena then goes back to the pool.
+    void        BeginInstanceDispose(spArena* arena);
+    void        EndInstanceDispose(InstanceArenaPool* pool, spArena* arena);
+
+    void        DestroyInstanceArenaPool(InstanceArenaPool* pool);
+}
+
+#endif // DM_SPINE_ALLOC_H
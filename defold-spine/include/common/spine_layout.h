@@ -0,0 +1,51 @@
+#ifndef DM_SPINE_LAYOUT_H
+#define DM_SPINE_LAYOUT_H
+
+#include <stdint.h>
+#include <stddef.h> // offsetof
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <common/instance_pool.h>
+#include <common/spine_alloc.h>
+#include <common/vertices.h>
+
+namespace dmSpine
+{
+    // A hash of the layouts of the structs that are shared between the runtime library (libspinec, built from commonsrc)
+    // and the code that links to it. It's static, so that each side computes it with the headers it was compiled with.
+    static inline uint32_t CalcSpineLayoutHash()
+    {
+        const uint32_t values[] = {
+            (uint32_t)sizeof(void*),
+            (uint32_t)sizeof(spSkeleton), (uint32_t)sizeof(spBone), (uint32_t)sizeof(spSlot), (uint32_t)sizeof(spSkin),
+            (uint32_t)sizeof(spIkConstraint), (uint32_t)sizeof(spTransformConstraint), (uint32_t)sizeof(spPathConstraint),
+            (uint32_t)sizeof(spPhysicsConstraint), (uint32_t)sizeof(spAnimationState), (uint32_t)sizeof(spAnimationStateData),
+            (uint32_t)sizeof(spTrackEntry), (uint32_t)sizeof(spEvent), (uint32_t)sizeof(spSkeletonClipping),
+            (uint32_t)sizeof(spSkeletonData), (uint32_t)sizeof(spBoneData), (uint32_t)sizeof(spSlotData), (uint32_t)sizeof(spEventData),
+            (uint32_t)sizeof(spAnimation), (uint32_t)sizeof(spTimeline), (uint32_t)sizeof(spAttachmentTimeline),
+            (uint32_t)sizeof(spTimelineArray), (uint32_t)sizeof(spAttachment), (uint32_t)sizeof(spRegionAttachment),
+            (uint32_t)sizeof(spMeshAttachment),
+            (uint32_t)sizeof(SpineInstance), (uint32_t)sizeof(SpineInstancePool), (uint32_t)sizeof(InstanceArenaPool),
+            (uint32_t)sizeof(SpineVertex), (uint32_t)sizeof(SpineDrawDesc), (uint32_t)sizeof(SpineModelBounds),
+            (uint32_t)sizeof(SpineWorldVertexCache), (uint32_t)sizeof(SpineScratch), (uint32_t)sizeof(SpineVertexDataSize),
+            (uint32_t)offsetof(spSkeleton, drawOrder), (uint32_t)offsetof(spTrackEntry, animation),
+            (uint32_t)offsetof(spAttachmentTimeline, resolvedAttachments),
+        };
+
+        // FNV-1a
+        uint32_t hash = 2166136261U;
+        const uint8_t* p = (const uint8_t*)values;
+        for (uint32_t i = 0; i < sizeof(values); ++i)
+        {
+            hash = (hash ^ p[i]) * 16777619U;
+        }
+        return hash;
+    }
+
+    // The CalcSpineLayoutHash() of the runtime library. If it differs from the caller's, the library was built from
+    // other sources, and must be rebuilt (see utils/build_libs.sh)
+    uint32_t GetSpineLayoutHash();
+}
+
+#endif // DM_SPINE_LAYOUT_H
@@ -1,6 +1,8 @@
 #ifndef DM_SPINE_ATTACHMENT_LOADER_H
 #define DM_SPINE_ATTACHMENT_LOADER_H
 
+#include <stdint.h>
+
 extern "C" {
 #include <spine/AttachmentLoader.h>
 }
@@ -40,7 +42,18 @@ namespace dmSpine
 
     void Dispose(spDefoldAtlasAttachmentLoader* loader);
 
-    spSkeletonData* ReadSkeletonJsonData(spAttachmentLoader* loader, const char* path, void* json_data);
+    // Sets the atlas region(s) of a region or mesh attachment from its path, and updates its uvs.
+    // Used for attachments that weren't created by the loader (see skeleton_blob.h)
+    bool BindAttachmentRegion(spDefoldAtlasAttachmentLoader* loader, spAttachment* attachment);
+
+    spSkeletonData* ReadSkeletonJsonData(spAttachmentLoader* loader, const char* path, const void* json_data, uint32_t json_size);
+    spSkeletonData* ReadSkeletonBinaryData(spAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size);
+
+    // True for the binary exports (.skel) and their compiled version (.skelc)
+    bool IsSkeletonBinaryPath(const char* path);
+
+    // Reads either format, depending on the path. The data doesn't need to be null terminated
+    spSkeletonData* ReadSkeletonData(spAttachmentLoader* loader, const char* path, const void* data, uint32_t data_size);
 
 } // namespace
 
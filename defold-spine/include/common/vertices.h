@@ -7,6 +7,7 @@
 
 struct spSkeleton;
 struct spSkeletonClipping;
+struct spAttachment;
 
 namespace dmSpine
 {
@@ -19,6 +20,15 @@ struct SpineVertex
     float page_index;
 };
 
+// A compact alternative to SpineVertex (20 vs 40 bytes). The texcoords and colors are normalized
+// integers, so they're read as floats in the shader. There is no page index (it's always 0).
+struct SpineVertexCompact
+{
+    float    x, y, z;
+    uint16_t u, v;
+    uint8_t  r, g, b, a;
+};
+
 struct SpineModelBounds
 {
     float minX;
@@ -31,13 +41,78 @@ struct SpineDrawDesc
 {
     uint32_t m_VertexStart;
     uint32_t m_VertexCount;
-    uint32_t m_BlendMode; // spBlendMode
+    uint32_t m_IndexStart;  // Only used with indexed vertex data
+    uint32_t m_IndexCount;  // Only used with indexed vertex data
+    uint32_t m_BlendMode;   // spBlendMode
+};
+
+struct SpineVertexCacheSlot
+{
+    const spAttachment* m_Attachment;   // The attachment the vertices were computed for
+    uint32_t            m_VertexStart;  // First vertex in SpineWorldVertexCache::m_Positions
+};
+
+// World space positions of the visible region and mesh attachments, computed once per frame.
+// It is shared by the bounds calculation, the buffer size estimate and the vertex generation,
+// and is owned by the component so that the memory is reused across frames.
+struct SpineWorldVertexCache
+{
+    dmArray<float>                  m_Positions;    // (x, y, z, pad) per vertex
+    dmArray<SpineVertexCacheSlot>   m_Slots;        // Indexed by the slot data index
+    float                           m_Min[3];       // World space bounds of all cached vertices
+    float                           m_Max[3];
+    uint32_t                        m_VertexCount;  // Unique vertices before clipping
+    uint32_t                        m_IndexCount;   // Indices before clipping
+};
+
+// A 2D bone affine transform with the component world transform baked in.
+// Maps a skeleton space (x, y) to a world space (x, y, z): x * m_Cols[0] + y * m_Cols[1] + m_Cols[2]
+// The w component of each column is padding
+struct SpineBoneTransform
+{
+    float m_Cols[3][4];
+};
+
+// Temporary buffers used while generating the vertices. Owned by the caller (e.g. once per world) so that
+// the memory is reused across frames. The arrays grow as needed, and never shrink.
+struct SpineScratch
+{
+    dmArray<float>              m_VertexFloats;     // skeleton space (x, y) pairs, used as input to the clipper
+    dmArray<float>              m_WorldPositions;   // world space (x, y, z, pad) per vertex
+};
+
+// The output size of GenerateIndexedVertexData
+struct SpineVertexDataSize
+{
+    uint32_t m_VertexCount;
+    uint32_t m_IndexCount;
+    uint32_t m_DrawDescCount;
+};
+
+struct SpineVertexStats
+{
+    uint32_t m_ClipPasses;          // Number of spSkeletonClipping_clipTriangles calls
+    uint32_t m_ClippedTriangles;    // Number of triangles output by the clipping
+    uint32_t m_Vertices;            // Number of vertices generated
 };
 
-uint32_t CalcVertexBufferSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, uint32_t* out_max_triangle_count);
+// The scratch buffers may be 0, in which case temporary ones are allocated for the call
+uint32_t CalcVertexBufferSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, uint32_t* out_max_triangle_count);
 uint32_t CalcDrawDescCount(const spSkeleton* skeleton);
-uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, const dmVMath::Matrix4& world, dmArray<SpineDrawDesc>* draw_descs);
-void GetSkeletonBounds(const spSkeleton* skeleton, SpineModelBounds& bounds);
+// Unlike CalcVertexBufferSize, the sizes are exact, so the output can be generated into ranges reserved up front.
+// Only the attachments inside a clipping attachment are clipped to count them
+void CalcIndexedVertexDataSize(const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, SpineVertexDataSize* out_size);
+// Generates the vertices in a single pass, growing the vertex buffer (and draw descs) on demand.
+// The stats are accumulated (i.e. not reset), and may be 0
+uint32_t GenerateVertexData(dmArray<SpineVertex>& vertex_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, dmArray<SpineDrawDesc>* draw_descs, SpineVertexStats* stats);
+// Same as GenerateVertexData, but writes each unique vertex only once. The indices are absolute offsets into the vertex buffer.
+// If the cache is set, the positions are read from it instead of being recomputed (it must have been updated with the same world transform)
+uint32_t GenerateIndexedVertexData(dmArray<SpineVertex>& vertex_buffer, dmArray<uint32_t>& index_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, const SpineWorldVertexCache* cache, dmArray<SpineDrawDesc>* draw_descs, SpineVertexStats* stats);
+uint32_t GenerateIndexedVertexData(dmArray<SpineVertexCompact>& vertex_buffer, dmArray<uint32_t>& index_buffer, const spSkeleton* skeleton, spSkeletonClipping* skeleton_clipper, SpineScratch* scratch, const dmVMath::Matrix4& world, const SpineWorldVertexCache* cache, dmArray<SpineDrawDesc>* draw_descs, SpineVertexStats* stats);
+// Call after spSkeleton_updateWorldTransform
+void UpdateWorldVertexCache(SpineWorldVertexCache& cache, const spSkeleton* skeleton, const dmVMath::Matrix4& world);
+void GetSkeletonBounds(const spSkeleton* skeleton, SpineScratch* scratch, SpineModelBounds& bounds);
+// The destination keeps its capacity, so it can be reused across calls without reallocating
 void MergeDrawDescs(const dmArray<SpineDrawDesc>& src, dmArray<SpineDrawDesc>& dst);
 
 } // dmSpine
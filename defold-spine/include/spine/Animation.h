@@ -44,6 +44,8 @@ extern "C" {
 
 typedef struct spTimeline spTimeline;
 struct spSkeleton;
+struct spSkeletonData;
+struct spSkin;
 typedef uint64_t spPropertyId;
 
 _SP_ARRAY_DECLARE_TYPE(spPropertyIdArray, spPropertyId)
@@ -402,6 +404,12 @@ typedef struct spAttachmentTimeline {
 	spTimeline super;
 	int slotIndex;
 	char **attachmentNames;
+
+	/* The attachments per frame (followed by the setup attachment) for each of the resolved skins. The first skin is 0,
+	 * i.e. only the default skin is used. */
+	int resolvedSkinsCount;
+	struct spSkin **resolvedSkins;
+	spAttachment **resolvedAttachments;
 } spAttachmentTimeline;
 
 SP_API spAttachmentTimeline *spAttachmentTimeline_create(int framesCount, int SlotIndex);
@@ -410,6 +418,15 @@ SP_API spAttachmentTimeline *spAttachmentTimeline_create(int framesCount, int Sl
 SP_API void
 spAttachmentTimeline_setFrame(spAttachmentTimeline *self, int frameIndex, float time, const char *attachmentName);
 
+/* Looks up the attachments of all frames in each of the skeleton data skins, so they don't have to be found by name
+ * when the timeline is applied. Must be called again if the frames or the skeleton data skins are changed. */
+SP_API void spAttachmentTimeline_resolve(spAttachmentTimeline *self, struct spSkeletonData *skeletonData);
+
+/* @param frame The frame index, or -1 for the setup attachment of the slot.
+ * Falls back to finding the attachment by name for skins that weren't resolved (e.g. skins created at runtime). */
+SP_API spAttachment *
+spAttachmentTimeline_getAttachment(const spAttachmentTimeline *self, const struct spSkeleton *skeleton, int frame);
+
 /**/
 
 typedef struct spDeformTimeline {
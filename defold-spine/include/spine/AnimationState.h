@@ -78,6 +78,8 @@ struct spTrackEntry {
 	spTrackEntryArray *timelineHoldMix;
 	float *timelinesRotation;
 	int timelinesRotationCount;
+	int *timelineFrameHints;
+	int timelineFrameHintsCount;
 	void *rendererObject;
 	void *userData;
 };
@@ -107,6 +109,9 @@ SP_API void spAnimationState_update(spAnimationState *self, float delta);
 
 SP_API int /**bool**/ spAnimationState_apply(spAnimationState *self, struct spSkeleton *skeleton);
 
+/* Defold: Fires the same events as spAnimationState_apply, without posing the skeleton. */
+SP_API void spAnimationState_applyEvents(spAnimationState *self, struct spSkeleton *skeleton);
+
 SP_API void spAnimationState_clearTracks(spAnimationState *self);
 
 SP_API void spAnimationState_clearTrack(spAnimationState *self, int trackIndex);
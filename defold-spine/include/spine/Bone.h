@@ -66,6 +66,9 @@ SP_API int/*bool*/spBone_isYDown(void);
 /* @param parent May be 0. */
 SP_API spBone *spBone_create(spBoneData *data, struct spSkeleton *skeleton, spBone *parent);
 
+/* Defold: Same as spBone_create(), for a bone in memory owned by the skeleton. Such bones must not be disposed. */
+SP_API void spBone_init(spBone *self, spBoneData *data, struct spSkeleton *skeleton, spBone *parent);
+
 SP_API void spBone_dispose(spBone *self);
 
 SP_API void spBone_setToSetupPose(spBone *self);
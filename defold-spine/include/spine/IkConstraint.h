@@ -58,6 +58,10 @@ typedef struct spIkConstraint {
 
 SP_API spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const struct spSkeleton *skeleton);
 
+/* Defold: Same as spIkConstraint_create(), for a constraint in memory owned by the skeleton, which must not be disposed.
+ * The bones array has room for data->bonesCount bones. The skeleton bones must be created first. */
+SP_API void spIkConstraint_init(spIkConstraint *self, spIkConstraintData *data, const struct spSkeleton *skeleton, spBone **bones);
+
 SP_API void spIkConstraint_dispose(spIkConstraint *self);
 
 SP_API void spIkConstraint_update(spIkConstraint *self);
@@ -74,6 +74,12 @@ typedef struct spPathConstraint {
 
 SP_API spPathConstraint *spPathConstraint_create(spPathConstraintData *data, const struct spSkeleton *skeleton);
 
+/* Defold: Same as spPathConstraint_create(), see spIkConstraint_init(). The skeleton slots must be created first.
+ * Such constraints are released with spPathConstraint_deinit(), which frees the buffers resized by the updates. */
+SP_API void spPathConstraint_init(spPathConstraint *self, spPathConstraintData *data, const struct spSkeleton *skeleton, spBone **bones);
+
+SP_API void spPathConstraint_deinit(spPathConstraint *self);
+
 SP_API void spPathConstraint_dispose(spPathConstraint *self);
 
 SP_API void spPathConstraint_update(spPathConstraint *self);
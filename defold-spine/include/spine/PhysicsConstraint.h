@@ -78,6 +78,9 @@ typedef struct spPhysicsConstraint {
 SP_API spPhysicsConstraint *
 spPhysicsConstraint_create(spPhysicsConstraintData *data, struct spSkeleton *skeleton);
 
+/* Defold: Same as spPhysicsConstraint_create(), for a constraint in memory owned by the skeleton, which must not be disposed */
+SP_API void spPhysicsConstraint_init(spPhysicsConstraint *self, spPhysicsConstraintData *data, struct spSkeleton *skeleton);
+
 SP_API void spPhysicsConstraint_dispose(spPhysicsConstraint *self);
 
 SP_API void spPhysicsConstraint_reset(spPhysicsConstraint *self);
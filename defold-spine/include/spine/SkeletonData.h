@@ -84,6 +84,9 @@ typedef struct spSkeletonData {
 
     int physicsConstraintsCount;
     spPhysicsConstraintData **physicsConstraints;
+
+	/* Defold: Owns the memory of the skeleton data when it was read from json or binary data, see spArena */
+	struct spArena *arena;
 } spSkeletonData;
 
 SP_API spSkeletonData *spSkeletonData_create(void);
@@ -109,6 +112,9 @@ SP_API spPathConstraintData *spSkeletonData_findPathConstraint(const spSkeletonD
 
 SP_API spPhysicsConstraintData *spSkeletonData_findPhysicsConstraint(const spSkeletonData *self, const char *constraintName);
 
+/* Resolves the attachment timelines of all animations against the skins. Called by the loaders. */
+SP_API void spSkeletonData_resolveAttachmentTimelines(spSkeletonData *self);
+
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +57,9 @@ SP_API void spSkeletonJson_dispose(spSkeletonJson *self);
 
 SP_API spSkeletonData *spSkeletonJson_readSkeletonData(spSkeletonJson *self, const char *json);
 
+/* Defold: The json doesn't need to be null terminated. */
+SP_API spSkeletonData *spSkeletonJson_readSkeletonDataWithLength(spSkeletonJson *self, const char *json, int length);
+
 SP_API spSkeletonData *spSkeletonJson_readSkeletonDataFile(spSkeletonJson *self, const char *path);
 
 #ifdef __cplusplus
@@ -56,6 +56,12 @@ typedef struct spSlot {
 
 SP_API spSlot *spSlot_create(spSlotData *data, spBone *bone);
 
+/* Defold: Same as spSlot_create(), for a slot in memory owned by the skeleton. Such slots are released with
+ * spSlot_deinit() instead of spSlot_dispose(), and the dark color (if any) is owned by the caller too. */
+SP_API void spSlot_init(spSlot *self, spSlotData *data, spBone *bone, spColor *darkColor);
+
+SP_API void spSlot_deinit(spSlot *self);
+
 SP_API void spSlot_dispose(spSlot *self);
 
 /* @param attachment May be 0 to clear the attachment for the slot. */
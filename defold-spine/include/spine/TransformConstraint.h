@@ -52,6 +52,9 @@ typedef struct spTransformConstraint {
 SP_API spTransformConstraint *
 spTransformConstraint_create(spTransformConstraintData *data, const struct spSkeleton *skeleton);
 
+/* Defold: Same as spTransformConstraint_create(), see spIkConstraint_init() */
+SP_API void spTransformConstraint_init(spTransformConstraint *self, spTransformConstraintData *data, const struct spSkeleton *skeleton, spBone **bones);
+
 SP_API void spTransformConstraint_dispose(spTransformConstraint *self);
 
 SP_API void spTransformConstraint_update(spTransformConstraint *self);
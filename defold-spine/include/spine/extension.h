@@ -72,6 +72,10 @@
 #define REALLOC(PTR, TYPE, COUNT) ((TYPE*)_spRealloc(PTR, sizeof(TYPE) * (COUNT)))
 #define NEW(TYPE) CALLOC(TYPE,1)
 
+/* Defold: For memory that is resized after its owner is created, which must never come from an arena (see spArena). */
+#define MALLOC_HEAP(TYPE, COUNT) ((TYPE*)_spMallocHeap(sizeof(TYPE) * (COUNT), __FILE__, __LINE__))
+#define CALLOC_HEAP(TYPE, COUNT) ((TYPE*)_spCallocHeap(COUNT, sizeof(TYPE), __FILE__, __LINE__))
+
 /* Gets the direct super class. Type safe. */
 #define SUPER(VALUE) (&VALUE->super)
 
@@ -190,6 +194,46 @@ SP_API void _spSetRandom(float (*_random)(void));
 
 char *_spReadFile(const char *path, int *length);
 
+#if defined(_MSC_VER)
+#define _SP_THREAD_LOCAL __declspec(thread)
+#else
+#define _SP_THREAD_LOCAL __thread
+#endif
+
+/* Defold: Arenas. While an arena is the current one on a thread, all spine allocations on that thread come from it,
+ * and freeing memory owned by it does nothing. The memory is released all at once with _spArena_dispose(), or reused
+ * after _spArena_reset(). Memory owned by an arena must only be freed while the arena is current, so anything that is
+ * resized after its owner is created uses MALLOC_HEAP/CALLOC_HEAP. */
+typedef struct spArena spArena;
+
+SP_API spArena *_spArena_create(size_t blockSize);
+
+SP_API void _spArena_dispose(spArena *self);
+
+/* Frees all but the first block */
+SP_API void _spArena_reset(spArena *self);
+
+/* The number of bytes allocated from the arena since it was created or reset, including the allocation headers */
+SP_API size_t _spArena_getSize(const spArena *self);
+
+/* The size of the first block, which is allocated together with the arena */
+SP_API size_t _spArena_getBlockSize(const spArena *self);
+
+/* Sets the current arena of this thread, or NULL for none. Returns the previous one. */
+SP_API spArena *_spSetArena(spArena *arena);
+
+/* The current arena of this thread, or NULL. The arenas are only set while creating or disposing an instance on the
+ * main thread, so the jobs on the worker threads (and the main thread's share of them) must never see one. */
+SP_API spArena *_spGetArena(void);
+
+void *_spMallocHeap(size_t size, const char *file, int line);
+
+void *_spCallocHeap(size_t num, size_t size, const char *file, int line);
+
+/* Sets a (thread local) frame index hint used by the timeline frame searches, or NULL for none.
+ * Used by the animation state to speed up the searches when the playback time is monotonic. */
+void _spTimeline_setFrameHint(int *hint);
+
 
 /*
  * Math utilities
@@ -270,6 +314,12 @@ void _spVertexAttachment_init(spVertexAttachment *self);
 
 void _spVertexAttachment_deinit(spVertexAttachment *self);
 
+/* Defold: Restores the function pointers of timelines and attachments that were copied from precompiled skeleton
+ * data, from their type. The attachments share a static vtable, so they must not be disposed. */
+void _spTimeline_initVtable(spTimeline *self);
+
+void _spAttachment_initStaticVtable(spAttachment *self);
+
 #ifdef __cplusplus
 }
 #endif
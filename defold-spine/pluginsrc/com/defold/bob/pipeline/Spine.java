@@ -53,6 +53,8 @@ public class Spine {
     public static native Pointer SPINE_LoadFromPath(String path, String atlas_path);
     public static native Pointer SPINE_LoadFromBuffer(Buffer buffer, int bufferSize, String path, Buffer atlas_buffer, int atlas_bufferSize, String atlas_path);
     public static native void SPINE_Destroy(SpinePointer spine);
+    public static native Pointer SPINE_CompileSkeletonBlob(Buffer buffer, int bufferSize, String path, IntByReference outSize);
+    public static native void SPINE_FreeSkeletonBlob(Pointer blob);
 
     // TODO: Create a jna Structure for this
     // Structures in JNA
@@ -402,13 +404,26 @@ public class Spine {
         return new SpinePointer(p);
     }
 
+    // Precompiles the skeleton data for the platform of the loaded plugin library (see skeleton_blob.h)
+    public static byte[] SPINE_CompileSkeleton(byte[] json_buffer, String path) throws SpineException {
+        Buffer b = ByteBuffer.wrap(json_buffer);
+        IntByReference size = new IntByReference();
+        Pointer p = SPINE_CompileSkeletonBlob(b, b.capacity(), path, size);
+        if (p == null) {
+            throw new SpineException(String.format("Failed to precompile spine scene '%s': %s", path, SPINE_GetLastError()));
+        }
+        byte[] blob = p.getByteArray(0, size.getValue());
+        SPINE_FreeSkeletonBlob(p);
+        return blob;
+    }
+
     // public static void SPINE_GetVertices(SpinePointer spine, float[] buffer){
     //     Buffer b = FloatBuffer.wrap(buffer);
     //     SPINE_GetVertices(spine, b, b.capacity()*4);
     // }
 
     private static void Usage() {
-        System.out.printf("Usage: pluginSpineExt.jar <.spinejson> <.texturesetc>\n");
+        System.out.printf("Usage: pluginSpineExt.jar <.spinejson|.skel> <.texturesetc>\n");
         System.out.printf("\n");
     }
 
@@ -443,7 +458,7 @@ public class Spine {
             return;
         }
 
-        String path = args[0];       // .spinejson
+        String path = args[0];       // .spinejson or .skel
         String atlas_path = args[1]; // .texturesetc
         Pointer spine_file = SPINE_LoadFromPath(path, atlas_path);
 
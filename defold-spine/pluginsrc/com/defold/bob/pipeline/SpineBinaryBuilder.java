@@ -0,0 +1,8 @@
+package com.dynamo.bob.pipeline;
+
+import com.dynamo.bob.BuilderParams;
+import com.dynamo.bob.CopyBuilder;
+
+// Binary Spine exports (.skel). They are validated when building the .spinescene that references them
+@BuilderParams(name="SpineBinaryFile", inExts=".skel", outExt=".skelc")
+public class SpineBinaryBuilder extends CopyBuilder {}
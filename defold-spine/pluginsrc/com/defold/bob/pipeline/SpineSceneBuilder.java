@@ -9,6 +9,7 @@ import com.dynamo.bob.fs.IResource;
 import com.dynamo.bob.pipeline.BuilderUtil;
 import com.dynamo.spine.proto.Spine.SpineSceneDesc;
 import com.dynamo.bob.pipeline.Spine;
+import com.google.protobuf.ByteString;
 
 import java.io.IOException;
 import java.nio.Buffer;
@@ -17,6 +18,32 @@ import java.nio.Buffer;
 @BuilderParams(name="SpineScene", inExts=".spinescene", outExt=".spinescenec")
 public class SpineSceneBuilder extends ProtoBuilder<SpineSceneDesc.Builder> {
 
+    // The precompiled skeleton doesn't depend on the struct layout of the target (see skeleton_blob.h).
+    // The json is bundled either way, and the runtime falls back to it if the extension version doesn't match.
+    private boolean precompileSkeletons() {
+        return this.project.getProjectProperties().getBooleanValue("spine", "precompile_skeletons", false);
+    }
+
+    private void precompileSkeleton(Task task, SpineSceneDesc.Builder builder) throws CompileExceptionError {
+        IResource spinejsonc = null;
+        for (IResource input: task.getInputs()) {
+            String path = input.getPath();
+            if (path.endsWith("spinejsonc") || path.endsWith("skelc")) {
+                spinejsonc = input;
+            }
+        }
+        if (spinejsonc == null) {
+            return;
+        }
+        try {
+            byte[] blob = Spine.SPINE_CompileSkeleton(spinejsonc.getContent(), spinejsonc.getPath());
+            builder.setSkeletonData(ByteString.copyFrom(blob));
+        }
+        catch (Spine.SpineException | IOException e) {
+            throw new CompileExceptionError(task.getInputs().get(0), -1, e.getMessage());
+        }
+    }
+
     @Override
     protected SpineSceneDesc.Builder transform(Task task, IResource resource, SpineSceneDesc.Builder builder) throws CompileExceptionError {
 
@@ -25,7 +52,12 @@ public class SpineSceneBuilder extends ProtoBuilder<SpineSceneDesc.Builder> {
         if (!path.equals("")) {
             BuilderUtil.checkResource(this.project, resource, "spine_json", path);
         }
-        builder.setSpineJson(BuilderUtil.replaceExt(path, ".spinejson", ".spinejsonc"));
+        // Either a .spinejson or a binary .skel file
+        if (path.endsWith(".skel")) {
+            builder.setSpineJson(BuilderUtil.replaceExt(path, ".skel", ".skelc"));
+        } else {
+            builder.setSpineJson(BuilderUtil.replaceExt(path, ".spinejson", ".spinejsonc"));
+        }
 
 
         path = builder.getAtlas();
@@ -34,6 +66,10 @@ public class SpineSceneBuilder extends ProtoBuilder<SpineSceneDesc.Builder> {
         }
         builder.setAtlas(BuilderUtil.replaceExt(path, ".atlas", ".a.texturesetc"));
 
+        if (precompileSkeletons()) {
+            precompileSkeleton(task, builder);
+        }
+
         return builder;
     }
 
@@ -48,7 +84,7 @@ public class SpineSceneBuilder extends ProtoBuilder<SpineSceneDesc.Builder> {
             if (path.endsWith("texturesetc")) {
                 testurec = input;
             }
-            else if (path.endsWith("spinejsonc")) {
+            else if (path.endsWith("spinejsonc") || path.endsWith("skelc")) {
                 spinejsonc = input;
             }
         }
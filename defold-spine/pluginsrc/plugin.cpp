@@ -13,8 +13,10 @@
 // }
 // #endif
 
+#include <float.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <dmsdk/sdk.h>
 #include <dmsdk/dlib/array.h>
@@ -27,6 +29,9 @@
 #include <dmsdk/gamesys/resources/res_textureset.h>
 #include <gamesys/texture_set_ddf.h>
 
+#include <common/instance_pool.h>
+#include <common/skeleton_blob.h>
+#include <common/skeleton_snapshot.h>
 #include <common/spine_loader.h>
 #include <common/vertices.h>
 #include "renderobject.h"
@@ -36,6 +41,9 @@
 #include <spine/SkeletonData.h>
 #include <spine/Skeleton.h>
 #include <spine/SkeletonClipping.h>
+#include <spine/MeshAttachment.h>
+#include <spine/RegionAttachment.h>
+#include <spine/extension.h>
 
 static const dmhash_t UNIFORM_TINT = dmHashString64("tint");
 
@@ -57,6 +65,7 @@ struct SpineFile
     // Base data
     spAtlasRegion*                          m_AtlasRegions;
     spSkeletonData*                         m_SkeletonData;
+    bool                                    m_Precompiled;      // Set if the skeleton data was loaded from a precompiled skeleton
     spAnimationStateData*                   m_AnimationStateData;
     dmSpine::spDefoldAtlasAttachmentLoader* m_AttachmentLoader;
     dmArray<const char*>                    m_AnimationNames;
@@ -64,12 +73,23 @@ struct SpineFile
     // Instance data
     spSkeleton*                             m_SkeletonInstance;
     spAnimationState*                       m_AnimationStateInstance;
+    spArena*                                m_InstanceArena;    // Holds the skeleton and animation state instances, like in the engine
+    dmSpine::SpineInstancePool              m_InstancePool;     // Holds the instance while it's reused (see SPINE_ReuseInstance)
     dmArray<SpineBone>                      m_Bones;
+    spSkeleton*                             m_PipelineSkeleton; // The pose snapshot of SPINE_SnapshotPose()
     // Render data
     dmArray<dmSpine::SpineVertex>           m_VertexBuffer;
     dmArray<dmSpinePlugin::RenderObject>    m_RenderObjects;
+    // Reused across the updates
+    spSkeletonClipping*                     m_SkeletonClipper;
+    dmSpine::SpineScratch                   m_Scratch;
+    dmArray<dmSpine::SpineDrawDesc>         m_DrawDescs;
+    dmArray<dmSpine::SpineDrawDesc>         m_MergedDrawDescs;
     dmhash_t                                m_CurrentSkin;
     dmhash_t                                m_CurrentAnimation;
+    // Used by SPINE_ComputeWorldVertices
+    dmSpine::SpineWorldVertexCache          m_WorldVertexCache;
+    dmArray<float>                          m_ScalarWorldVertices;
 
     const char*                             m_Error;
 
@@ -77,10 +97,15 @@ struct SpineFile
     : m_Path(0)
     , m_AtlasRegions(0)
     , m_SkeletonData(0)
+    , m_Precompiled(false)
     , m_AnimationStateData(0)
     , m_AttachmentLoader(0)
     , m_SkeletonInstance(0)
     , m_AnimationStateInstance(0)
+    , m_InstanceArena(0)
+    , m_InstancePool()
+    , m_PipelineSkeleton(0)
+    , m_SkeletonClipper(0)
     , m_CurrentSkin(0)
     , m_CurrentAnimation(0)
     , m_Error(0)
@@ -92,9 +117,40 @@ char g_LastSpineError[1024] = {0};
 
 typedef SpineFile* HSpineFile;
 
-static void UpdateRenderData(SpineFile* file);
+static void UpdateRenderData(SpineFile* file, spSkeleton* skeleton);
 static void UpdateVertices(SpineFile* file, float dt);
 
+// Takes the instance from the pool, or creates it, and sets it up the way CompSpineModelCreate does
+static void AcquireInstance(SpineFile* file)
+{
+    dmSpine::SpineInstance instance;
+    dmSpine::AcquireInstance(&file->m_InstancePool, file->m_SkeletonData, file->m_AnimationStateData, &instance);
+    file->m_InstanceArena = instance.m_Arena;
+    file->m_SkeletonInstance = instance.m_Skeleton;
+    file->m_AnimationStateInstance = instance.m_AnimationState;
+    if (!file->m_SkeletonInstance || !file->m_AnimationStateInstance)
+        return;
+
+    // The bones of a pooled instance were put back in the setup pose by the pool
+    spSkeleton_setSkin(file->m_SkeletonInstance, file->m_SkeletonData->defaultSkin);
+    spSkeleton_setSlotsToSetupPose(file->m_SkeletonInstance);
+    spSkeleton_updateWorldTransform(file->m_SkeletonInstance, SP_PHYSICS_POSE);
+    file->m_CurrentSkin = 0;
+    file->m_CurrentAnimation = 0;
+}
+
+static void ReleaseInstance(SpineFile* file)
+{
+    dmSpine::SpineInstance instance;
+    instance.m_Arena = file->m_InstanceArena;
+    instance.m_Skeleton = file->m_SkeletonInstance;
+    instance.m_AnimationState = file->m_AnimationStateInstance;
+    dmSpine::ReleaseInstance(&file->m_InstancePool, file->m_SkeletonData, &instance);
+    file->m_InstanceArena = 0;
+    file->m_SkeletonInstance = 0;
+    file->m_AnimationStateInstance = 0;
+}
+
 // Need to free() the buffer
 static uint8_t* ReadFile(const char* path, size_t* file_size) {
     FILE* f = fopen(path, "rb");
@@ -258,7 +314,15 @@ extern "C" DM_DLLEXPORT void* SPINE_LoadFromBuffer(void* json, size_t json_size,
 
     // Create the spine resource
     spAttachmentLoader* attachment_loader = (spAttachmentLoader*)file->m_AttachmentLoader;
-    file->m_SkeletonData = dmSpine::ReadSkeletonJsonData(attachment_loader, path, json);
+    if (dmSpine::IsSkeletonBlob(json, (uint32_t)json_size))
+    {
+        file->m_SkeletonData = dmSpine::LoadSkeletonBlob(file->m_AttachmentLoader, path, json, (uint32_t)json_size);
+        file->m_Precompiled = true;
+    }
+    else
+    {
+        file->m_SkeletonData = dmSpine::ReadSkeletonData(attachment_loader, path, json, (uint32_t)json_size);
+    }
     if (!file->m_SkeletonData)
     {
         if (attachment_loader->error1 || attachment_loader->error2)
@@ -271,16 +335,15 @@ extern "C" DM_DLLEXPORT void* SPINE_LoadFromBuffer(void* json, size_t json_size,
 
     file->m_AnimationStateData = spAnimationStateData_create(file->m_SkeletonData);
 
-    file->m_SkeletonInstance = spSkeleton_create(file->m_SkeletonData);
+    // A pool of one instance, for SPINE_ReuseInstance
+    dmSpine::SetInstancePoolSize(&file->m_InstancePool, 1, 0);
+    AcquireInstance(file);
     if (!file->m_SkeletonInstance)
     {
         dmLogError("Failed to create skeleton instance");
         SPINE_Destroy(file);
         return 0;
     }
-    spSkeleton_setSkin(file->m_SkeletonInstance, file->m_SkeletonData->defaultSkin);
-
-    file->m_AnimationStateInstance = spAnimationState_create(file->m_AnimationStateData);
     if (!file->m_AnimationStateInstance)
     {
         dmLogError("Failed to create animation state instance");
@@ -288,8 +351,7 @@ extern "C" DM_DLLEXPORT void* SPINE_LoadFromBuffer(void* json, size_t json_size,
         return 0;
     }
 
-    spSkeleton_setToSetupPose(file->m_SkeletonInstance);
-    spSkeleton_updateWorldTransform(file->m_SkeletonInstance, SP_PHYSICS_POSE);
+    file->m_SkeletonClipper = spSkeletonClipping_create();
 
     file->m_Path = strdup(path);
 
@@ -307,9 +369,6 @@ extern "C" DM_DLLEXPORT void* SPINE_LoadFromBuffer(void* json, size_t json_size,
         file->m_SkinNames[i] = strdup(file->m_SkeletonData->skins[i]->name);
     }
 
-    file->m_CurrentSkin = 0;
-    file->m_CurrentAnimation = 0;
-
     UpdateVertices(file, 0.0f);
     SetupBones(file);
 
@@ -345,14 +404,18 @@ extern "C" DM_DLLEXPORT void SPINE_Destroy(void* _file) {
         return;
     }
 
-    if (file->m_AnimationStateInstance)
-        spAnimationState_dispose(file->m_AnimationStateInstance);
-    if (file->m_SkeletonInstance)
-        spSkeleton_dispose(file->m_SkeletonInstance);
+    if (file->m_SkeletonClipper)
+        spSkeletonClipping_dispose(file->m_SkeletonClipper);
+    if (file->m_PipelineSkeleton)
+        spSkeleton_dispose(file->m_PipelineSkeleton);
+    ReleaseInstance(file);
+    dmSpine::DestroyInstancePool(&file->m_InstancePool);
 
     if (file->m_AnimationStateData)
         spAnimationStateData_dispose(file->m_AnimationStateData);
-    if (file->m_SkeletonData)
+    if (file->m_Precompiled)
+        dmSpine::DisposeSkeletonBlob(file->m_SkeletonData);
+    else if (file->m_SkeletonData)
         spSkeletonData_dispose(file->m_SkeletonData);
     dmSpine::Dispose(file->m_AttachmentLoader);
 
@@ -361,6 +424,79 @@ extern "C" DM_DLLEXPORT void SPINE_Destroy(void* _file) {
     delete file;
 }
 
+// Used by bob to precompile the skeleton data of a spine scene (see skeleton_blob.h)
+// A precompiled skeleton is loaded and written again, which must give the same data (see utils/benchmark)
+// The returned buffer is freed with SPINE_FreeSkeletonBlob()
+extern "C" DM_DLLEXPORT void* SPINE_CompileSkeletonBlob(void* json, size_t json_size, const char* path, int* out_size)
+{
+    dmSpine::spDefoldAtlasAttachmentLoader* loader = dmSpine::CreateAttachmentLoader();
+    spAttachmentLoader* attachment_loader = (spAttachmentLoader*)loader;
+    bool precompiled = dmSpine::IsSkeletonBlob(json, (uint32_t)json_size);
+    spSkeletonData* skeleton_data = precompiled ? dmSpine::LoadSkeletonBlob(loader, path, json, (uint32_t)json_size)
+                                                : dmSpine::ReadSkeletonData(attachment_loader, path, json, (uint32_t)json_size);
+    if (!skeleton_data)
+    {
+        if (attachment_loader->error1 || attachment_loader->error2)
+            SPINE_SetLastError(attachment_loader);
+        dmLogError("Failed to load Spine skeleton from json file %s", path);
+        dmSpine::Dispose(loader);
+        return 0;
+    }
+
+    uint32_t size = 0;
+    void* blob = dmSpine::WriteSkeletonBlob(skeleton_data, &size);
+    if (precompiled)
+        dmSpine::DisposeSkeletonBlob(skeleton_data);
+    else
+        spSkeletonData_dispose(skeleton_data);
+    dmSpine::Dispose(loader);
+
+    *out_size = blob ? (int)size : 0;
+    return blob;
+}
+
+extern "C" DM_DLLEXPORT void SPINE_FreeSkeletonBlob(void* blob)
+{
+    free(blob);
+}
+
+// Loads a spine scene that bob precompiled, without an atlas (see utils/benchmark). Like the runtime (res_spine_scene.cpp),
+// the skeleton is loaded from the json instead if the precompiled skeleton was written with another format version
+extern "C" DM_DLLEXPORT void* SPINE_LoadPrecompiledFromBuffer(void* blob, size_t blob_size, void* json, size_t json_size, const char* path)
+{
+    if (dmSpine::IsSkeletonBlobCompatible(blob, (uint32_t)blob_size))
+    {
+        return SPINE_LoadFromBuffer(blob, blob_size, path, 0, 0, 0);
+    }
+    return SPINE_LoadFromBuffer(json, json_size, path, 0, 0, 0);
+}
+
+// Returns 1 if the skeleton data was loaded from a precompiled skeleton
+extern "C" DM_DLLEXPORT int SPINE_IsPrecompiled(void* _file)
+{
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN(file);
+    return file->m_Precompiled ? 1 : 0;
+}
+
+// Parses the skeleton data and throws it away, without an atlas (see utils/benchmark)
+extern "C" DM_DLLEXPORT int SPINE_ParseSkeleton(void* json, size_t json_size, const char* path)
+{
+    dmSpine::spDefoldAtlasAttachmentLoader* loader = dmSpine::CreateAttachmentLoader();
+    spAttachmentLoader* attachment_loader = (spAttachmentLoader*)loader;
+    spSkeletonData* skeleton_data = dmSpine::ReadSkeletonData(attachment_loader, path, json, (uint32_t)json_size);
+    if (!skeleton_data)
+    {
+        if (attachment_loader->error1 || attachment_loader->error2)
+            SPINE_SetLastError(attachment_loader);
+        dmSpine::Dispose(loader);
+        return 0;
+    }
+    spSkeletonData_dispose(skeleton_data);
+    dmSpine::Dispose(loader);
+    return 1;
+}
+
 extern "C" DM_DLLEXPORT int32_t SPINE_GetNumAnimations(void* _file) {
     SpineFile* file = TO_SPINE_FILE(_file);
     CHECK_FILE_RETURN(file);
@@ -470,6 +606,13 @@ extern "C" DM_DLLEXPORT void SPINE_UpdateVertices(void* _file, float dt) {
     UpdateVertices(file, dt);
 }
 
+static void UpdateAnimation(SpineFile* file, float dt)
+{
+    spAnimationState_update(file->m_AnimationStateInstance, dt);
+    spAnimationState_apply(file->m_AnimationStateInstance, file->m_SkeletonInstance);
+    spSkeleton_update(file->m_SkeletonInstance, dt);
+}
+
 static void UpdateVertices(SpineFile* file, float dt)
 {
     if (!file || !file->m_AnimationStateInstance) {
@@ -479,12 +622,47 @@ static void UpdateVertices(SpineFile* file, float dt)
         return;
     }
 
-    spAnimationState_update(file->m_AnimationStateInstance, dt);
-    spAnimationState_apply(file->m_AnimationStateInstance, file->m_SkeletonInstance);
-    spSkeleton_update(file->m_SkeletonInstance, dt);
+    UpdateAnimation(file, dt);
+    spSkeleton_updateWorldTransform(file->m_SkeletonInstance, SP_PHYSICS_UPDATE);
+
+    UpdateRenderData(file, file->m_SkeletonInstance); // Update the draw call list
+}
+
+// The separate steps of SPINE_UpdateVertices, so that they can be measured individually (see utils/benchmark)
+extern "C" DM_DLLEXPORT void SPINE_UpdateAnimation(void* _file, float dt) {
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
+    UpdateAnimation(file, dt);
+}
+
+extern "C" DM_DLLEXPORT void SPINE_UpdateWorldTransform(void* _file) {
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
     spSkeleton_updateWorldTransform(file->m_SkeletonInstance, SP_PHYSICS_UPDATE);
+}
+
+extern "C" DM_DLLEXPORT void SPINE_UpdateRenderData(void* _file) {
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
+    UpdateRenderData(file, file->m_SkeletonInstance);
+}
 
-    UpdateRenderData(file); // Update the draw call list
+// The pipelined vertex generation of the runtime (spine.pipelined_vertex_generation): The pose is copied to a
+// snapshot, and the vertices are generated from the snapshot while the instance is updated again.
+// SPINE_UpdateRenderDataFromSnapshot() may run on another thread than the other calls on the same file.
+extern "C" DM_DLLEXPORT void SPINE_SnapshotPose(void* _file) {
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
+    if (!file->m_PipelineSkeleton)
+        file->m_PipelineSkeleton = spSkeleton_create(file->m_SkeletonData);
+    dmSpine::CopySkeletonPose(file->m_PipelineSkeleton, file->m_SkeletonInstance);
+}
+
+extern "C" DM_DLLEXPORT void SPINE_UpdateRenderDataFromSnapshot(void* _file) {
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
+    if (file->m_PipelineSkeleton)
+        UpdateRenderData(file, file->m_PipelineSkeleton);
 }
 
 extern "C" DM_DLLEXPORT dmSpine::SpineVertex* SPINE_GetVertexBufferData(void* _file, int* pcount)
@@ -536,6 +714,17 @@ extern "C" DM_DLLEXPORT void SPINE_SetSkin(void* _file, const char* skin)
     spSkeleton_setSlotsToSetupPose(file->m_SkeletonInstance);
 }
 
+// Releases the instance to the instance pool and takes it back, as when a spine model is destroyed and another one
+// is created. Used by the benchmark to test that a reused instance plays like a new one.
+extern "C" DM_DLLEXPORT void SPINE_ReuseInstance(void* _file)
+{
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN_VOID(file);
+    ReleaseInstance(file);
+    AcquireInstance(file);
+    UpdateVertices(file, 0.0f);
+}
+
 extern "C" DM_DLLEXPORT void SPINE_SetAnimation(void* _file, const char* animation)
 {
     SpineFile* file = TO_SPINE_FILE(_file);
@@ -668,7 +857,7 @@ static T* AdjustArraySize(dmArray<T>& array, uint32_t count)
     return p;
 }
 
-static void UpdateRenderData(SpineFile* file)
+static void UpdateRenderData(SpineFile* file, spSkeleton* skeleton)
 {
     if (!file || !file->m_AnimationStateInstance)
         return;
@@ -678,18 +867,18 @@ static void UpdateRenderData(SpineFile* file)
     file->m_RenderObjects.SetSize(0);
     file->m_VertexBuffer.SetSize(0);
 
-    spSkeletonClipping* clipper = spSkeletonClipping_create();
-
-    uint32_t ro_count = dmSpine::CalcDrawDescCount(file->m_SkeletonInstance);
+    uint32_t ro_count = dmSpine::CalcDrawDescCount(skeleton);
     AdjustArraySize(file->m_RenderObjects, ro_count);
 
-    dmArray<dmSpine::SpineDrawDesc> draw_descs;
-    draw_descs.SetCapacity(ro_count);
+    dmArray<dmSpine::SpineDrawDesc>& draw_descs = file->m_DrawDescs;
+    draw_descs.SetSize(0);
+    if (draw_descs.Capacity() < ro_count)
+        draw_descs.SetCapacity(ro_count);
 
     dmVMath::Matrix4 transform = dmVMath::Matrix4::identity();
-    dmSpine::GenerateVertexData(file->m_VertexBuffer, file->m_SkeletonInstance, clipper, transform, &draw_descs);
+    dmSpine::GenerateVertexData(file->m_VertexBuffer, skeleton, file->m_SkeletonClipper, &file->m_Scratch, transform, &draw_descs, 0);
 
-    dmArray<dmSpine::SpineDrawDesc> merged_draw_descs;
+    dmArray<dmSpine::SpineDrawDesc>& merged_draw_descs = file->m_MergedDrawDescs;
     MergeDrawDescs(draw_descs, merged_draw_descs);
 
     file->m_RenderObjects.SetSize(merged_draw_descs.Size());
@@ -711,6 +900,101 @@ static void UpdateRenderData(SpineFile* file)
 
         ro.m_WorldTransform = transform;
     }
+}
+
+// The world positions the way they were computed before the kernels of UpdateWorldVertexCache: the skeleton space
+// vertices from spine-c, and then a Matrix4 transform per vertex. Same order, visibility rules and bounds as the cache.
+static void ComputeScalarWorldVertices(SpineFile* file, const dmVMath::Matrix4& world, float* bounds)
+{
+    spSkeleton* skeleton = file->m_SkeletonInstance;
+    dmArray<float>& vertices = file->m_Scratch.m_VertexFloats;
+    dmArray<float>& out = file->m_ScalarWorldVertices;
+    out.SetSize(0);
 
-    spSkeletonClipping_dispose(clipper);
+    for (int s = 0; s < skeleton->slotsCount; ++s)
+    {
+        spSlot* slot = skeleton->slots[s];
+        spAttachment* attachment = slot->attachment;
+        if (!attachment || slot->color.a == 0 || !slot->bone->active)
+            continue;
+
+        uint32_t vertex_count = 0;
+        if (attachment->type == SP_ATTACHMENT_REGION)
+        {
+            spRegionAttachment* region = (spRegionAttachment*)attachment;
+            if (region->color.a == 0)
+                continue;
+            vertex_count = 4;
+            vertices.SetSize(0);
+            AdjustArraySize(vertices, vertex_count * 2);
+            spRegionAttachment_computeWorldVertices(region, slot, vertices.Begin(), 0, 2);
+        }
+        else if (attachment->type == SP_ATTACHMENT_MESH)
+        {
+            spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+            if (mesh->color.a == 0)
+                continue;
+            vertex_count = SUPER(mesh)->worldVerticesLength / 2;
+            vertices.SetSize(0);
+            AdjustArraySize(vertices, vertex_count * 2);
+            spVertexAttachment_computeWorldVertices(SUPER(mesh), slot, 0, SUPER(mesh)->worldVerticesLength, vertices.Begin(), 0, 2);
+        }
+        else
+        {
+            continue;
+        }
+
+        float* p = AdjustArraySize(out, vertex_count * 4);
+        for (uint32_t i = 0; i < vertex_count; ++i, p += 4)
+        {
+            const dmVMath::Vector4 v = world * dmVMath::Point3(vertices[i * 2], vertices[i * 2 + 1], 0.0f);
+            p[0] = v.getX();
+            p[1] = v.getY();
+            p[2] = v.getZ();
+            p[3] = 0.0f;
+        }
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        bounds[c] = out.Empty() ? world.getElem(3, c) : FLT_MAX;
+        bounds[c + 3] = out.Empty() ? world.getElem(3, c) : -FLT_MAX;
+    }
+    for (uint32_t i = 0; i < out.Size(); i += 4)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            bounds[c] = dmMath::Min(bounds[c], out[i + c]);
+            bounds[c + 3] = dmMath::Max(bounds[c + 3], out[i + c]);
+        }
+    }
+}
+
+// Used by the benchmark (see --world-vertices in utils/benchmark) to compare the SIMD kernels to the scalar path.
+// Computes the world positions (x, y, z, pad) of the visible region and mesh attachments in the current pose, and their bounds.
+// The transform is a column major 4x4 matrix. Returns the positions, the number of vertices in 'pcount', and the bounds
+// (min xyz, max xyz) in 'bounds'
+extern "C" DM_DLLEXPORT const float* SPINE_ComputeWorldVertices(void* _file, const float* transform, int scalar, int* pcount, float* bounds)
+{
+    SpineFile* file = TO_SPINE_FILE(_file);
+    CHECK_FILE_RETURN(file);
+
+    dmVMath::Matrix4 world;
+    for (int col = 0; col < 4; ++col)
+    {
+        for (int row = 0; row < 4; ++row)
+            world.setElem(col, row, transform[col * 4 + row]);
+    }
+
+    if (scalar)
+    {
+        ComputeScalarWorldVertices(file, world, bounds);
+        *pcount = (int)(file->m_ScalarWorldVertices.Size() / 4);
+        return file->m_ScalarWorldVertices.Begin();
+    }
+    dmSpine::UpdateWorldVertexCache(file->m_WorldVertexCache, file->m_SkeletonInstance, world);
+    *pcount = (int)file->m_WorldVertexCache.m_VertexCount;
+    memcpy(bounds, file->m_WorldVertexCache.m_Min, sizeof(float) * 3);
+    memcpy(bounds + 3, file->m_WorldVertexCache.m_Max, sizeof(float) * 3);
+    return file->m_WorldVertexCache.m_Positions.Begin();
 }
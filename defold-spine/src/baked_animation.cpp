@@ -0,0 +1,236 @@
+#include "baked_animation.h"
+
+#include <dmsdk/dlib/math.h>
+
+#include <spine/Animation.h>
+#include <spine/AnimationState.h>
+#include <spine/Bone.h>
+#include <spine/Skeleton.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+
+#include <math.h>
+#include <string.h>
+
+namespace dmSpine
+{
+    // The timelines that are replaced by the baked bone samples
+    static bool IsBakedTimeline(spTimelineType type)
+    {
+        switch (type)
+        {
+            case SP_TIMELINE_ROTATE:
+            case SP_TIMELINE_TRANSLATE:
+            case SP_TIMELINE_TRANSLATEX:
+            case SP_TIMELINE_TRANSLATEY:
+            case SP_TIMELINE_SCALE:
+            case SP_TIMELINE_SCALEX:
+            case SP_TIMELINE_SCALEY:
+            case SP_TIMELINE_SHEAR:
+            case SP_TIMELINE_SHEARX:
+            case SP_TIMELINE_SHEARY:
+            case SP_TIMELINE_INHERIT:
+            case SP_TIMELINE_IKCONSTRAINT:
+            case SP_TIMELINE_TRANSFORMCONSTRAINT:
+            case SP_TIMELINE_PATHCONSTRAINTPOSITION:
+            case SP_TIMELINE_PATHCONSTRAINTSPACING:
+            case SP_TIMELINE_PATHCONSTRAINTMIX:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_INERTIA:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_STRENGTH:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_DAMPING:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_MASS:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_WIND:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_GRAVITY:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_MIX:
+            case SP_TIMELINE_PHYSICSCONSTRAINT_RESET:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    BakedAnimation* BakeAnimation(spSkeletonData* skeleton_data, spAnimation* animation, float sample_rate)
+    {
+        if (sample_rate <= 0.0f)
+            return 0;
+
+        spSkeleton* skeleton = spSkeleton_create(skeleton_data);
+        if (!skeleton)
+            return 0;
+
+        // Make sure that all skin bones and constraints are active, since we don't know which skins will be used
+        spSkin* skin = spSkin_create("baked");
+        for (int i = 0; i < skeleton_data->skinsCount; ++i)
+        {
+            spSkin_addSkin(skin, skeleton_data->skins[i]);
+        }
+        spSkeleton_setSkin(skeleton, skin);
+
+        uint32_t bone_count = (uint32_t)skeleton->bonesCount;
+        uint32_t sample_count = (uint32_t)ceilf(animation->duration * sample_rate) + 1;
+
+        // Sample all bones (bone major), and then remove the ones that don't move
+        BakedBoneSample* samples = new BakedBoneSample[bone_count * sample_count];
+        for (uint32_t s = 0; s < sample_count; ++s)
+        {
+            float time = dmMath::Min(s / sample_rate, animation->duration);
+            spSkeleton_setToSetupPose(skeleton);
+            spAnimation_apply(animation, skeleton, time, time, 0, 0, 0, 1.0f, SP_MIX_BLEND_SETUP, SP_MIX_DIRECTION_IN);
+            spSkeleton_updateWorldTransform(skeleton, SP_PHYSICS_POSE);
+
+            for (uint32_t b = 0; b < bone_count; ++b)
+            {
+                const spBone* bone = skeleton->bones[b];
+                BakedBoneSample& sample = samples[b * sample_count + s];
+                sample.m_A = bone->a;
+                sample.m_B = bone->b;
+                sample.m_C = bone->c;
+                sample.m_D = bone->d;
+                sample.m_X = bone->worldX;
+                sample.m_Y = bone->worldY;
+            }
+        }
+
+        spSkeleton_dispose(skeleton);
+        spSkin_dispose(skin);
+
+        BakedAnimation* baked = new BakedAnimation;
+        baked->m_SampleRate = sample_rate;
+        baked->m_SampleCount = sample_count;
+        baked->m_BoneCount = bone_count;
+        baked->m_Tracks = new BakedBoneTrack[bone_count];
+
+        uint32_t total_count = 0;
+        for (uint32_t b = 0; b < bone_count; ++b)
+        {
+            const BakedBoneSample* bone_samples = &samples[b * sample_count];
+            uint32_t count = 1;
+            for (uint32_t s = 1; s < sample_count; ++s)
+            {
+                if (memcmp(&bone_samples[0], &bone_samples[s], sizeof(BakedBoneSample)) != 0)
+                {
+                    count = sample_count;
+                    break;
+                }
+            }
+            baked->m_Tracks[b].m_SampleStart = total_count;
+            baked->m_Tracks[b].m_SampleCount = count;
+            total_count += count;
+        }
+
+        baked->m_Samples = new BakedBoneSample[total_count];
+        for (uint32_t b = 0; b < bone_count; ++b)
+        {
+            const BakedBoneTrack& track = baked->m_Tracks[b];
+            memcpy(&baked->m_Samples[track.m_SampleStart], &samples[b * sample_count], sizeof(BakedBoneSample) * track.m_SampleCount);
+        }
+        delete[] samples;
+
+        // The animation state still plays the slot timelines and fires the events
+        spTimelineArray* timelines = spTimelineArray_create(dmMath::Max(1, animation->timelines->size));
+        for (int i = 0; i < animation->timelines->size; ++i)
+        {
+            spTimeline* timeline = animation->timelines->items[i];
+            if (!IsBakedTimeline(timeline->type))
+                spTimelineArray_add(timelines, timeline);
+        }
+        baked->m_Animation = spAnimation_create(animation->name, timelines, animation->duration);
+        return baked;
+    }
+
+    void DestroyBakedAnimation(BakedAnimation* baked)
+    {
+        // The timelines are owned by the source animation
+        baked->m_Animation->timelines->size = 0;
+        spAnimation_dispose(baked->m_Animation);
+        delete[] baked->m_Samples;
+        delete[] baked->m_Tracks;
+        delete baked;
+    }
+
+    static void ApplyBakedAnimation(const BakedAnimation* baked, spTrackEntry* entry, float alpha, spSkeleton* skeleton)
+    {
+        float time = spTrackEntry_getAnimationTime(entry);
+        if (entry->reverse)
+            time = baked->m_Animation->duration - time;
+
+        float frame = dmMath::Clamp(time * baked->m_SampleRate, 0.0f, (float)(baked->m_SampleCount - 1));
+        uint32_t i0 = (uint32_t)frame;
+        uint32_t i1 = dmMath::Min(i0 + 1, baked->m_SampleCount - 1);
+        float t = frame - i0;
+
+        uint32_t bone_count = dmMath::Min(baked->m_BoneCount, (uint32_t)skeleton->bonesCount);
+        for (uint32_t b = 0; b < bone_count; ++b)
+        {
+            const BakedBoneTrack& track = baked->m_Tracks[b];
+            const BakedBoneSample* samples = &baked->m_Samples[track.m_SampleStart];
+
+            BakedBoneSample sample = samples[0];
+            if (track.m_SampleCount > 1)
+            {
+                const BakedBoneSample& s0 = samples[i0];
+                const BakedBoneSample& s1 = samples[i1];
+                sample.m_A = s0.m_A + (s1.m_A - s0.m_A) * t;
+                sample.m_B = s0.m_B + (s1.m_B - s0.m_B) * t;
+                sample.m_C = s0.m_C + (s1.m_C - s0.m_C) * t;
+                sample.m_D = s0.m_D + (s1.m_D - s0.m_D) * t;
+                sample.m_X = s0.m_X + (s1.m_X - s0.m_X) * t;
+                sample.m_Y = s0.m_Y + (s1.m_Y - s0.m_Y) * t;
+            }
+
+            spBone* bone = skeleton->bones[b];
+            if (alpha >= 1.0f)
+            {
+                bone->a         = sample.m_A;
+                bone->b         = sample.m_B;
+                bone->c         = sample.m_C;
+                bone->d         = sample.m_D;
+                bone->worldX    = sample.m_X;
+                bone->worldY    = sample.m_Y;
+            }
+            else
+            {
+                bone->a        += (sample.m_A - bone->a) * alpha;
+                bone->b        += (sample.m_B - bone->b) * alpha;
+                bone->c        += (sample.m_C - bone->c) * alpha;
+                bone->d        += (sample.m_D - bone->d) * alpha;
+                bone->worldX   += (sample.m_X - bone->worldX) * alpha;
+                bone->worldY   += (sample.m_Y - bone->worldY) * alpha;
+            }
+        }
+    }
+
+    bool UpdateBakedPose(spSkeleton* skeleton, spTrackEntry* entry)
+    {
+        const BakedAnimation* baked = entry ? (const BakedAnimation*)entry->rendererObject : 0;
+        if (!baked)
+            return false;
+
+        float alpha = 1.0f;
+        spTrackEntry* from = entry->mixingFrom;
+        if (from && from->rendererObject && entry->mixDuration > 0.0f)
+        {
+            ApplyBakedAnimation((const BakedAnimation*)from->rendererObject, from, 1.0f, skeleton);
+            alpha = dmMath::Min(1.0f, entry->mixTime / entry->mixDuration);
+        }
+        ApplyBakedAnimation(baked, entry, alpha, skeleton);
+
+        // The samples were taken with the skeleton at the origin, and without any scaling
+        float sx = skeleton->scaleX;
+        float sy = skeleton->scaleY;
+        if (sx != 1.0f || sy != 1.0f || skeleton->x != 0.0f || skeleton->y != 0.0f)
+        {
+            for (int i = 0; i < skeleton->bonesCount; ++i)
+            {
+                spBone* bone = skeleton->bones[i];
+                bone->a *= sx;
+                bone->b *= sx;
+                bone->c *= sy;
+                bone->d *= sy;
+                bone->worldX = bone->worldX * sx + skeleton->x;
+                bone->worldY = bone->worldY * sy + skeleton->y;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef DM_SPINE_BAKED_ANIMATION_H
+#define DM_SPINE_BAKED_ANIMATION_H
+
+#include <stdint.h>
+
+struct spAnimation;
+struct spSkeleton;
+struct spSkeletonData;
+struct spTrackEntry;
+
+namespace dmSpine
+{
+    // The skeleton space transform of a bone (i.e. after the constraints were solved)
+    struct BakedBoneSample
+    {
+        float m_A, m_B, m_C, m_D;
+        float m_X, m_Y;
+    };
+
+    struct BakedBoneTrack
+    {
+        uint32_t m_SampleStart;     // First sample in BakedAnimation::m_Samples
+        uint32_t m_SampleCount;     // Either 1 (the bone doesn't move), or BakedAnimation::m_SampleCount
+    };
+
+    // An animation sampled at a fixed rate. The bone transforms are lerped between the samples, while the remaining
+    // timelines (attachments, colors, deforms, draw order and events) are still played by the animation state.
+    struct BakedAnimation
+    {
+        spAnimation*        m_Animation;    // The source animation, without the bone and constraint timelines
+        BakedBoneTrack*     m_Tracks;       // One per bone
+        BakedBoneSample*    m_Samples;
+        float               m_SampleRate;
+        uint32_t            m_SampleCount;
+        uint32_t            m_BoneCount;
+    };
+
+    BakedAnimation* BakeAnimation(spSkeletonData* skeleton_data, spAnimation* animation, float sample_rate);
+    void            DestroyBakedAnimation(BakedAnimation* baked);
+
+    // Sets the bone world transforms from the baked animation playing on the track entry (crossfading from the previous
+    // one, if any). The local bone transforms aren't updated, and the constraints and physics aren't evaluated.
+    // Returns false if the entry isn't playing a baked animation, in which case the skeleton is left untouched.
+    bool            UpdateBakedPose(spSkeleton* skeleton, spTrackEntry* entry);
+}
+
+#endif // DM_SPINE_BAKED_ANIMATION_H
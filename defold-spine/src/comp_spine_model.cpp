@@ -12,6 +12,8 @@
 
 #include "comp_spine_model.h"
 #include "res_spine_scene.h"
+#include "baked_animation.h"
+#include "worker_pool.h"
 
 extern "C" {
 
@@ -44,6 +46,7 @@ extern "C" {
 #include <dmsdk/resource/resource.hpp>
 #include <gameobject/gameobject_ddf.h>
 
+#include <common/skeleton_snapshot.h>
 #include <common/vertices.h>
 
 
@@ -53,6 +56,12 @@ extern "C" {
 DM_PROPERTY_GROUP(rmtp_Spine, "Spine", 0);
 DM_PROPERTY_U32(rmtp_SpineBones, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine bones", &rmtp_Spine);
 DM_PROPERTY_U32(rmtp_SpineComponents, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine components", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineClipPasses, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine clip passes", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineClippedTriangles, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine clipped triangles", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineVertices, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine vertices generated", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineRenderObjects, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine render objects", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineUploadBytes, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine vertex and index bytes uploaded", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineCulled, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine components culled", &rmtp_Spine);
 
 namespace dmSpine
 {
@@ -66,21 +75,124 @@ namespace dmSpine
     static const dmhash_t MATERIAL_EXT_HASH = dmHashString64("materialc");
 
     static const uint32_t INVALID_ANIMATION_INDEX = 0xFFFFFFFF;
+    static const uint32_t PARALLEL_UPDATE_CHUNK_SIZE = 8; // Components per job in the parallel update
+    static const uint32_t PARALLEL_VERTEX_CHUNK_SIZE = 4; // Components per job in the parallel vertex generation
+    static const uint32_t INVALID_PIPELINE_ITEM = 0xFFFFFFFF;
 
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams* params);
     static void DestroyComponent(struct SpineModelWorld* world, uint32_t index);
 
+    // A skeleton that is evaluated once for all components playing the same animation in phase (instanced playback).
+    // The vertices are generated in skeleton space, and each component only applies its own world transform.
+    struct SpineInstanceGroup
+    {
+        SpineSceneResource*                 m_SpineScene;
+        spSkeleton*                         m_SkeletonInstance;
+        spAnimationState*                   m_AnimationStateInstance;
+        spTrackEntry*                       m_AnimationInstance;
+        dmArray<SpineModelComponent*>       m_Components;
+        dmArray<SpineModelComponent*>       m_EventComponents;      // A copy of m_Components while the events are sent (see InstanceGroupEventListener)
+        SpineWorldVertexCache               m_VertexCache;          // In skeleton space
+        dmArray<dmSpine::SpineVertex>       m_VertexBufferData;
+        dmArray<dmSpine::SpineVertexCompact> m_CompactVertexBufferData;
+        dmArray<uint32_t>                   m_IndexBufferData;      // Relative to the group vertex buffer
+        dmArray<SpineDrawDesc>              m_DrawDescBuffer;
+        uint32_t                            m_UpdateFrame;          // The last frame the skeleton was updated
+        uint8_t                             m_VerticesDirty : 1;
+        uint8_t                             m_SendingEvents : 1;    // m_EventComponents is in use
+    };
+
+    // An animation state event from a component updated on a worker thread. It's sent on the main thread after the update.
+    struct SpineDeferredEvent
+    {
+        SpineModelComponent*                m_Component;
+        uint32_t                            m_ComponentIndex;       // The update order, so the events are sent in the same order as a serial update
+        const spAnimation*                  m_Animation;
+        const spEvent*                      m_Event;                // Owned by the skeleton data
+        uint32_t                            m_CallbackId;           // The track callback, when the track entry was disposed
+        int                                 m_TrackIndex;
+        spEventType                         m_Type;
+    };
+
+    // Per thread state for the parallel update and vertex generation (the main thread is index 0)
+    struct SpineWorkerData
+    {
+        SpineScratch                        m_Scratch;
+        dmArray<SpineDeferredEvent>         m_Events;               // Sorted by component index, since each thread takes the chunks in order
+        uint32_t                            m_ComponentIndex;       // The component being updated
+        uint32_t                            m_NextEvent;            // Used when sending the events
+
+        // The vertices generated on this thread, before they're copied to the world buffers (pipelined vertex generation)
+        spSkeletonClipping*                 m_SkeletonClipper;
+        dmArray<dmSpine::SpineVertex>       m_VertexBufferData;
+        dmArray<dmSpine::SpineVertexCompact> m_CompactVertexBufferData;
+        dmArray<uint32_t>                   m_IndexBufferData;      // Relative to the thread vertex buffer
+        dmArray<SpineDrawDesc>              m_DrawDescBuffer;
+        SpineVertexStats                    m_Stats;
+    };
+
+    // The output of a component in a batch. The parallel vertex generation only uses the world buffer ranges,
+    // while the pipelined one generates into the buffers of a thread first, and copies them later
+    struct SpineBatchItem
+    {
+        SpineModelComponent*                m_Component;
+        const spSkeleton*                   m_Skeleton;             // The component skeleton, or its snapshot (pipelined vertex generation)
+        const SpineInstanceGroup*           m_InstanceGroup;
+        uint32_t                            m_Thread;
+        uint32_t                            m_VertexStart;
+        uint32_t                            m_VertexCount;
+        uint32_t                            m_IndexStart;
+        uint32_t                            m_IndexCount;
+        uint32_t                            m_DrawDescStart;
+        uint32_t                            m_DrawDescCount;
+        uint32_t                            m_DstVertexStart;
+        uint32_t                            m_DstIndexStart;
+        uint32_t                            m_DstDrawDescStart;
+    };
+
+    struct SpineBatchJob
+    {
+        struct SpineModelWorld*             m_World;
+        SpineWorkerData*                    m_Data;                 // One per thread
+        dmArray<SpineBatchItem>*            m_Items;
+        bool                                m_UseDrawDescs;
+    };
+
     struct SpineModelWorld
     {
         dmObjectPool<SpineModelComponent*>  m_Components;
+        dmArray<SpineInstanceGroup*>        m_InstanceGroups;
         dmArray<dmRender::RenderObject>     m_RenderObjects;
-        dmArray<dmSpine::SpineModelBounds>  m_BoundingBoxes;
         dmGraphics::HVertexDeclaration      m_VertexDeclaration;
         dmGraphics::HVertexBuffer           m_VertexBuffer;
         dmArray<dmSpine::SpineVertex>       m_VertexBufferData;
+        dmArray<dmSpine::SpineVertexCompact> m_CompactVertexBufferData; // Used instead of m_VertexBufferData if m_CompactVertexFormat is set
+        dmGraphics::HIndexBuffer            m_IndexBuffer;
+        dmArray<uint32_t>                   m_IndexBufferData;      // Narrowed to 16 bit indices when uploaded, if possible
         dmArray<SpineDrawDesc>              m_DrawDescBuffer;
+        dmArray<SpineDrawDesc>              m_MergedDrawDescBuffer;
+        dmArray<SpineBatchItem>             m_BatchItems;           // Parallel vertex generation
+        dmArray<SpineBatchItem>             m_PipelineItems;        // Pipelined vertex generation, indexed by SpineModelComponent::m_PipelineItem
+        SpineWorkerData*                    m_PipelineData;         // One per pool thread. Separate from m_WorkerData, since the results are kept until rendered
+        SpineBatchJob                       m_PipelineJob;
         dmResource::HFactory                m_Factory;
         spSkeletonClipping*                 m_SkeletonClipper;
+        SpineScratch                        m_Scratch;              // Reused by the vertex generation every frame
+        HWorkerPool                         m_WorkerPool;           // Owned by the context
+        SpineWorkerData*                    m_WorkerData;           // One per pool thread
+        uint32_t                            m_WorkerDataCount;
+        SpineWorkerData                     m_GroupEventData;       // The events of the instance groups in the parallel update. Only the events are used.
+        uint32_t                            m_OffscreenUpdateInterval;
+        float                               m_OffscreenBoundsPadding;
+        float                               m_InstanceTimeStep;     // Max phase difference for components to share an instance group
+        uint32_t                            m_Frame;
+        uint8_t                             m_Is32BitIndexSupported : 1;
+        uint8_t                             m_CompactVertexFormat : 1;
+        uint8_t                             m_InstancedPlayback : 1;
+        uint8_t                             m_ParallelUpdate : 1;
+        uint8_t                             m_ParallelVertexGeneration : 1;
+        uint8_t                             m_PipelinedVertexGeneration : 1;
+        uint8_t                             m_PipelineRunning : 1;  // The vertex generation job is started, but not waited for
     };
 
     struct SpineModelContext
@@ -93,6 +205,15 @@ namespace dmSpine
         dmRender::HRenderContext    m_RenderContext;
         dmGraphics::HContext        m_GraphicsContext;
         uint32_t                    m_MaxSpineModelCount;
+        uint32_t                    m_OffscreenUpdateInterval;
+        float                       m_OffscreenBoundsPadding;
+        float                       m_InstanceTimeStep;
+        HWorkerPool                 m_WorkerPool;
+        uint8_t                     m_CompactVertexFormat : 1;
+        uint8_t                     m_InstancedPlayback : 1;
+        uint8_t                     m_ParallelUpdate : 1;
+        uint8_t                     m_ParallelVertexGeneration : 1;
+        uint8_t                     m_PipelinedVertexGeneration : 1;
     };
 
     dmGameObject::CreateResult CompSpineModelNewWorld(const dmGameObject::ComponentNewWorldParams& params)
@@ -106,17 +227,40 @@ namespace dmSpine
 
         world->m_Components.SetCapacity(comp_count);
         world->m_RenderObjects.SetCapacity(comp_count);
-        world->m_BoundingBoxes.SetCapacity(comp_count);
-        world->m_BoundingBoxes.SetSize(comp_count);
+
+        world->m_CompactVertexFormat = context->m_CompactVertexFormat;
+        world->m_OffscreenUpdateInterval = context->m_OffscreenUpdateInterval;
+        world->m_OffscreenBoundsPadding = context->m_OffscreenBoundsPadding;
+        world->m_InstancedPlayback = context->m_InstancedPlayback;
+        world->m_InstanceTimeStep = context->m_InstanceTimeStep;
+        world->m_ParallelUpdate = context->m_ParallelUpdate;
+        world->m_ParallelVertexGeneration = context->m_ParallelVertexGeneration;
+        world->m_WorkerPool = context->m_WorkerPool;
+        world->m_PipelinedVertexGeneration = context->m_PipelinedVertexGeneration && world->m_WorkerPool;
+        world->m_WorkerDataCount = GetThreadCount(world->m_WorkerPool);
+        world->m_WorkerData = new SpineWorkerData[world->m_WorkerDataCount];
+        world->m_PipelineData = new SpineWorkerData[world->m_WorkerDataCount];
 
         dmGraphics::HVertexStreamDeclaration stream_declaration = dmGraphics::NewVertexStreamDeclaration(context->m_GraphicsContext);
-        dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
-        dmGraphics::AddVertexStream(stream_declaration, "texcoord0", 2, dmGraphics::TYPE_FLOAT, true);
-        dmGraphics::AddVertexStream(stream_declaration, "color", 4, dmGraphics::TYPE_FLOAT, true);
-        dmGraphics::AddVertexStream(stream_declaration, "page_index", 1, dmGraphics::TYPE_FLOAT, false);
+        if (world->m_CompactVertexFormat)
+        {
+            // Normalized streams, so the shaders see the same values as with the float format
+            dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
+            dmGraphics::AddVertexStream(stream_declaration, "texcoord0", 2, dmGraphics::TYPE_UNSIGNED_SHORT, true);
+            dmGraphics::AddVertexStream(stream_declaration, "color", 4, dmGraphics::TYPE_UNSIGNED_BYTE, true);
+        }
+        else
+        {
+            dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
+            dmGraphics::AddVertexStream(stream_declaration, "texcoord0", 2, dmGraphics::TYPE_FLOAT, true);
+            dmGraphics::AddVertexStream(stream_declaration, "color", 4, dmGraphics::TYPE_FLOAT, true);
+            dmGraphics::AddVertexStream(stream_declaration, "page_index", 1, dmGraphics::TYPE_FLOAT, false);
+        }
 
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(context->m_GraphicsContext, stream_declaration);
         world->m_VertexBuffer = dmGraphics::NewVertexBuffer(context->m_GraphicsContext, 0, 0x0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        world->m_IndexBuffer = dmGraphics::NewIndexBuffer(context->m_GraphicsContext, 0, 0x0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        world->m_Is32BitIndexSupported = dmGraphics::IsIndexBufferFormatSupported(context->m_GraphicsContext, dmGraphics::INDEXBUFFER_FORMAT_32);
 
         dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 
@@ -125,20 +269,43 @@ namespace dmSpine
         dmResource::RegisterResourceReloadedCallback(context->m_Factory, ResourceReloadedCallback, world);
 
         world->m_SkeletonClipper = spSkeletonClipping_create();
+        for (uint32_t i = 0; i < world->m_WorkerDataCount; ++i)
+        {
+            world->m_WorkerData[i].m_SkeletonClipper = spSkeletonClipping_create();
+            world->m_PipelineData[i].m_SkeletonClipper = spSkeletonClipping_create();
+        }
 
         return dmGameObject::CREATE_RESULT_OK;
     }
 
+    static void DestroyInstanceGroup(SpineInstanceGroup* group);
+
+    static void StartPipeline(SpineModelWorld* world);
+    static void WaitForPipeline(SpineModelWorld* world);
+
     dmGameObject::CreateResult CompSpineModelDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params)
     {
         SpineModelWorld* world = (SpineModelWorld*)params.m_World;
+        WaitForPipeline(world);
+        for (uint32_t i = 0; i < world->m_InstanceGroups.Size(); ++i)
+        {
+            DestroyInstanceGroup(world->m_InstanceGroups[i]);
+        }
         dmGraphics::DeleteVertexDeclaration(world->m_VertexDeclaration);
         dmGraphics::DeleteVertexBuffer(world->m_VertexBuffer);
+        dmGraphics::DeleteIndexBuffer(world->m_IndexBuffer);
 
         dmResource::UnregisterResourceReloadedCallback(((SpineModelContext*)params.m_Context)->m_Factory, ResourceReloadedCallback, world);
 
         spSkeletonClipping_dispose(world->m_SkeletonClipper);
+        for (uint32_t i = 0; i < world->m_WorkerDataCount; ++i)
+        {
+            spSkeletonClipping_dispose(world->m_WorkerData[i].m_SkeletonClipper);
+            spSkeletonClipping_dispose(world->m_PipelineData[i].m_SkeletonClipper);
+        }
 
+        delete[] world->m_WorkerData;
+        delete[] world->m_PipelineData;
         delete world;
 
         return dmGameObject::CREATE_RESULT_OK;
@@ -217,13 +384,14 @@ namespace dmSpine
             return false;
         }
 
+        // Indexed like the skeleton bones
+        int bone_index = bone->data->index;
         SetTransformFromBone(bone_instance, component->m_Transform, bone);
 
         dmhash_t name_hash = dmHashString64(bone->data->name);
-        component->m_BoneNameToNodeInstanceIndex.Put(name_hash, component->m_BoneInstances.Size());
+        component->m_BoneNameToNodeInstanceIndex.Put(name_hash, (uint32_t)bone_index);
 
-        component->m_BoneInstances.Push(bone_instance);
-        component->m_Bones.Push(bone);
+        component->m_BoneInstances[bone_index] = bone_instance;
 
         // Create the children
         for (int n = 0; n < bone->childrenCount; ++n)
@@ -247,8 +415,9 @@ namespace dmSpine
 
         spSkeleton* skeleton = component->m_SkeletonInstance;
 
-        component->m_Bones.SetCapacity(skeleton->bonesCount);
         component->m_BoneInstances.SetCapacity(skeleton->bonesCount);
+        component->m_BoneInstances.SetSize(skeleton->bonesCount);
+        memset(component->m_BoneInstances.Begin(), 0, sizeof(dmGameObject::HInstance) * skeleton->bonesCount);
         component->m_BoneNameToNodeInstanceIndex.SetCapacity((skeleton->bonesCount+1)/2, skeleton->bonesCount);
         if (!CreateGOBone(component, dmGameObject::GetCollection(component->m_Instance), component->m_Instance, 0, skeleton->root, 0))
         {
@@ -315,6 +484,14 @@ namespace dmSpine
         }
     }
 
+    // The animations were baked when the baked model was loaded (see BakeAnimations). 0 if the scene has no sample rate
+    static BakedAnimation* GetBakedAnimation(SpineSceneResource* spine_scene, uint32_t index)
+    {
+        if (index >= spine_scene->m_BakedAnimations.Size())
+            return 0;
+        return spine_scene->m_BakedAnimations[index];
+    }
+
     static bool PlayAnimation(SpineModelComponent* component, dmhash_t animation_id, dmGameObject::Playback playback,
         float blend_duration, float offset, float playback_rate, int track_index)
     {
@@ -337,6 +514,14 @@ namespace dmSpine
 
         spAnimation* animation = spine_scene->m_Skeleton->animations[index];
 
+        BakedAnimation* baked = 0;
+        if (component->m_Resource->m_Ddf->m_Baked)
+        {
+            baked = GetBakedAnimation(spine_scene, index);
+            if (baked)
+                animation = baked->m_Animation;
+        }
+
         if (track_index < 0)
         {
             dmLogError("Invalid track index %d", track_index);
@@ -361,6 +546,7 @@ namespace dmSpine
 
         track.m_AnimationId = animation_id;
         track.m_AnimationInstance = spAnimationState_setAnimation(component->m_AnimationStateInstance, track_index, animation, loop);
+        track.m_AnimationInstance->rendererObject = baked;
 
         track.m_Playback = playback;
         track.m_AnimationInstance->timeScale = playback_rate;
@@ -410,9 +596,9 @@ namespace dmSpine
         return false;
     }
 
-    static void SendAnimationDone(SpineModelComponent* component, const spAnimationState* state, const spTrackEntry* entry, const spEvent* event)
+    static void SendAnimationDone(SpineModelComponent* component, int track_index, const spAnimation* animation)
     {
-        SpineAnimationTrack& track = component->m_AnimationTracks[entry->trackIndex];
+        SpineAnimationTrack& track = component->m_AnimationTracks[track_index];
 
         dmMessage::URL sender;
         dmMessage::URL receiver = track.m_Listener;
@@ -424,9 +610,9 @@ namespace dmSpine
         }
 
         dmGameSystemDDF::SpineAnimationDone message;
-        message.m_AnimationId = dmHashString64(entry->animation->name);
+        message.m_AnimationId = dmHashString64(animation->name);
         message.m_Playback    = track.m_Playback;
-        message.m_Track       = entry->trackIndex + 1;
+        message.m_Track       = track_index + 1;
 
         if (track.m_CallbackInfo)
         {
@@ -452,9 +638,9 @@ namespace dmSpine
         }
     }
 
-    static void SendSpineEvent(SpineModelComponent* component, const spAnimationState* state, const spTrackEntry* entry, const spEvent* event)
+    static void SendSpineEvent(SpineModelComponent* component, int track_index, const spAnimation* animation, const spEvent* event)
     {
-        SpineAnimationTrack& track = component->m_AnimationTracks[entry->trackIndex];
+        SpineAnimationTrack& track = component->m_AnimationTracks[track_index];
 
         dmMessage::URL sender;
         dmMessage::URL receiver = track.m_Listener;
@@ -472,7 +658,7 @@ namespace dmSpine
         }
 
         dmGameSystemDDF::SpineEvent message;
-        message.m_AnimationId = dmHashString64(entry->animation->name);
+        message.m_AnimationId = dmHashString64(animation->name);
         message.m_EventId     = dmHashString64(event->data->name);
         message.m_BlendWeight = 0.0f;//keyframe_event->m_BlendWeight;
         message.m_T           = event->time;
@@ -481,7 +667,7 @@ namespace dmSpine
         message.m_String      = dmHashString64(event->stringValue?event->stringValue:"");
         message.m_Node.m_Ref  = 0;
         message.m_Node.m_ContextTableRef = 0;
-        message.m_Track       = entry->trackIndex + 1;
+        message.m_Track       = track_index + 1;
 
         if (track.m_CallbackInfo)
         {
@@ -492,14 +678,79 @@ namespace dmSpine
             dmGameObject::Result result = dmGameObject::PostDDF(&message, &sender, &receiver, 0, false);
             if (result != dmGameObject::RESULT_OK)
             {
-                dmLogError("Could not send animation event '%s' from animation '%s' to listener: %d", entry->animation->name, event->data->name, result);
+                dmLogError("Could not send animation event '%s' from animation '%s' to listener: %d", animation->name, event->data->name, result);
+            }
+        }
+    }
+
+    static void DeferEvent(SpineModelComponent* component, spEventType type, const spTrackEntry* entry, const spEvent* event, uint32_t callback_id)
+    {
+        SpineWorkerData* data = component->m_WorkerData;
+        if (data->m_Events.Full())
+            data->m_Events.OffsetCapacity(dmMath::Max(16U, data->m_Events.Capacity()));
+
+        SpineDeferredEvent deferred;
+        deferred.m_Component        = component;
+        deferred.m_ComponentIndex   = data->m_ComponentIndex;
+        deferred.m_Animation        = entry->animation;
+        deferred.m_Event            = event;
+        deferred.m_CallbackId       = callback_id;
+        deferred.m_TrackIndex       = entry->trackIndex;
+        deferred.m_Type             = type;
+        data->m_Events.Push(deferred);
+    }
+
+    // Called on a worker thread (parallel update). Only the component itself is updated here,
+    // and the messages and callbacks are sent from the main thread (see SendDeferredEvents)
+    static void DeferredEventListener(SpineModelComponent* component, spEventType type, spTrackEntry* entry, spEvent* event)
+    {
+        switch (type)
+        {
+            case SP_ANIMATION_COMPLETE:
+            {
+                if (entry->mixingTo != 0)
+                    return;
+
+                SpineAnimationTrack& track = component->m_AnimationTracks[entry->trackIndex];
+                if (!IsLooping(track.m_Playback))
+                {
+                    DeferEvent(component, type, entry, event, 0);
+                }
+
+                if (IsPingPong(track.m_Playback))
+                {
+                    track.m_AnimationInstance->reverse = !track.m_AnimationInstance->reverse;
+                }
+                break;
+            }
+            case SP_ANIMATION_DISPOSE:
+            {
+                // The entry is gone after this, but the callback can only be destroyed on the main thread
+                SpineAnimationTrack* track = GetTrackFromIndex(component, entry->trackIndex);
+                if (track && track->m_AnimationInstance == entry)
+                {
+                    track->m_AnimationInstance = nullptr;
+                    if (track->m_CallbackInfo)
+                        DeferEvent(component, type, entry, event, track->m_CallbackId);
+                }
+                break;
             }
+            case SP_ANIMATION_EVENT:
+                DeferEvent(component, type, entry, event, 0);
+                break;
+            default:
+                break;
         }
     }
 
     static void SpineEventListener(spAnimationState* state, spEventType type, spTrackEntry* entry, spEvent* event)
     {
         SpineModelComponent* component = (SpineModelComponent*)state->userData;
+        if (component->m_WorkerData)
+        {
+            DeferredEventListener(component, type, entry, event);
+            return;
+        }
 
         // Events are explained here: http://esotericsoftware.com/spine-api-reference#AnimationStateListener
         switch (type)
@@ -535,7 +786,7 @@ namespace dmSpine
                 if (!IsLooping(track.m_Playback))
                 {
                     // We only send the event if it's not looping (same behavior as before)
-                    SendAnimationDone(component, state, entry, event);
+                    SendAnimationDone(component, entry->trackIndex, entry->animation);
                 }
 
                 if (IsPingPong(track.m_Playback))
@@ -555,13 +806,247 @@ namespace dmSpine
                 break;
             }
             case SP_ANIMATION_EVENT:
-                SendSpineEvent(component, state, entry, event);
+                SendSpineEvent(component, entry->trackIndex, entry->animation, event);
+                break;
+            default:
+                break;
+        }
+    }
+
+    static void SendDeferredEvent(const SpineDeferredEvent& deferred)
+    {
+        SpineModelComponent* component = deferred.m_Component;
+        SpineAnimationTrack* track = GetTrackFromIndex(component, deferred.m_TrackIndex);
+        if (!track)
+            return;
+
+        switch (deferred.m_Type)
+        {
+            case SP_ANIMATION_COMPLETE:
+                SendAnimationDone(component, deferred.m_TrackIndex, deferred.m_Animation);
+                break;
+            case SP_ANIMATION_DISPOSE:
+                // Unless an earlier callback already replaced it
+                if (track->m_CallbackId == deferred.m_CallbackId)
+                    ClearCompletionCallback(track);
+                break;
+            case SP_ANIMATION_EVENT:
+                SendSpineEvent(component, deferred.m_TrackIndex, deferred.m_Animation, deferred.m_Event);
                 break;
             default:
                 break;
         }
     }
 
+    // The events of the threads, and of the instance groups that were updated before them
+    static SpineWorkerData* GetEventData(SpineModelWorld* world, uint32_t index)
+    {
+        return index < world->m_WorkerDataCount ? &world->m_WorkerData[index] : &world->m_GroupEventData;
+    }
+
+    static void ResetDeferredEvents(SpineModelWorld* world)
+    {
+        for (uint32_t i = 0; i < world->m_WorkerDataCount + 1; ++i)
+        {
+            SpineWorkerData* data = GetEventData(world, i);
+            data->m_Events.SetSize(0);
+            data->m_NextEvent = 0;
+        }
+    }
+
+    // Sends the events of the components before end_index, in component order
+    static void SendDeferredEvents(SpineModelWorld* world, uint32_t end_index)
+    {
+        DM_PROFILE("SendEvents");
+        while (true)
+        {
+            SpineWorkerData* next = 0;
+            uint32_t next_index = end_index;
+            for (uint32_t i = 0; i < world->m_WorkerDataCount + 1; ++i)
+            {
+                SpineWorkerData* data = GetEventData(world, i);
+                if (data->m_NextEvent < data->m_Events.Size() && data->m_Events[data->m_NextEvent].m_ComponentIndex < next_index)
+                {
+                    next = data;
+                    next_index = data->m_Events[data->m_NextEvent].m_ComponentIndex;
+                }
+            }
+            if (!next)
+                break;
+            SendDeferredEvent(next->m_Events[next->m_NextEvent++]);
+        }
+    }
+
+    static void InstanceGroupEventListener(spAnimationState* state, spEventType type, spTrackEntry* entry, spEvent* event)
+    {
+        // Each component gets the events, as if it had played the animation itself
+        if (type != SP_ANIMATION_COMPLETE && type != SP_ANIMATION_EVENT)
+            return;
+
+        // The callbacks may detach components from the group (e.g. spine.play_anim), or add new ones, so we iterate
+        // over a copy. The components that were detached play their own animation, and don't get the group events.
+        // The copy is kept in the group, so that it's only allocated when the group grows. If a callback makes the
+        // group send events again, that call makes its own copy.
+        SpineInstanceGroup* group = (SpineInstanceGroup*)state->userData;
+        dmArray<SpineModelComponent*> nested_components;
+        dmArray<SpineModelComponent*>& components = group->m_SendingEvents ? nested_components : group->m_EventComponents;
+        bool sending_events = group->m_SendingEvents;
+        group->m_SendingEvents = 1;
+
+        components.SetSize(0);
+        if (components.Capacity() < group->m_Components.Size())
+            components.SetCapacity(group->m_Components.Size());
+        components.PushArray(group->m_Components.Begin(), group->m_Components.Size());
+        for (uint32_t i = 0; i < components.Size(); ++i)
+        {
+            SpineModelComponent* component = components[i];
+            if (component->m_InstanceGroup != group)
+                continue;
+            SpineEventListener(component->m_AnimationStateInstance, type, component->m_AnimationTracks[0].m_AnimationInstance, event);
+        }
+
+        group->m_SendingEvents = sending_events;
+    }
+
+    static void DestroyInstanceGroup(SpineInstanceGroup* group)
+    {
+        if (group->m_AnimationStateInstance)
+            spAnimationState_dispose(group->m_AnimationStateInstance);
+        if (group->m_SkeletonInstance)
+            spSkeleton_dispose(group->m_SkeletonInstance);
+        delete group;
+    }
+
+    static SpineInstanceGroup* CreateInstanceGroup(SpineSceneResource* spine_scene, spSkin* skin, const spTrackEntry* entry)
+    {
+        SpineInstanceGroup* group = new SpineInstanceGroup;
+        group->m_SpineScene = spine_scene;
+        group->m_UpdateFrame = 0;
+        group->m_VerticesDirty = 1;
+        group->m_SendingEvents = 0;
+
+        group->m_SkeletonInstance = spSkeleton_create(spine_scene->m_Skeleton);
+        group->m_AnimationStateInstance = spAnimationState_create(spine_scene->m_AnimationStateData);
+        if (!group->m_SkeletonInstance || !group->m_AnimationStateInstance)
+        {
+            DestroyInstanceGroup(group);
+            return 0;
+        }
+
+        spSkeleton_setSkin(group->m_SkeletonInstance, skin);
+        spSkeleton_setToSetupPose(group->m_SkeletonInstance);
+        spSkeleton_updateWorldTransform(group->m_SkeletonInstance, SP_PHYSICS_UPDATE);
+
+        group->m_AnimationStateInstance->userData = group;
+        group->m_AnimationStateInstance->listener = InstanceGroupEventListener;
+
+        spTrackEntry* group_entry = spAnimationState_setAnimation(group->m_AnimationStateInstance, 0, entry->animation, entry->loop);
+        group_entry->timeScale = entry->timeScale;
+        group_entry->reverse = entry->reverse;
+        group_entry->trackTime = entry->trackTime;
+        group_entry->rendererObject = entry->rendererObject;
+        group->m_AnimationInstance = group_entry;
+        return group;
+    }
+
+    static float GetInstancePhaseDistance(const spTrackEntry* a, const spTrackEntry* b)
+    {
+        float distance = fabsf(a->trackTime - b->trackTime);
+        float duration = a->animationEnd - a->animationStart;
+        if (a->loop && duration > 0.0f)
+        {
+            distance = fmodf(distance, duration);
+            distance = dmMath::Min(distance, duration - distance);
+        }
+        return distance;
+    }
+
+    // Lets the component share the animation evaluation with others playing the same animation in phase
+    static void AttachToInstanceGroup(SpineModelWorld* world, SpineModelComponent* component)
+    {
+        // Only the untouched default animation may be shared
+        if (component->m_AnimationTracks.Size() != 1 || !component->m_AnimationTracks[0].m_AnimationInstance)
+            return;
+
+        const spTrackEntry* entry = component->m_AnimationTracks[0].m_AnimationInstance;
+        SpineSceneResource* spine_scene = component->m_Resource->m_SpineScene;
+        spSkin* skin = component->m_SkeletonInstance->skin;
+
+        SpineInstanceGroup* group = 0;
+        for (uint32_t i = 0; i < world->m_InstanceGroups.Size(); ++i)
+        {
+            SpineInstanceGroup* candidate = world->m_InstanceGroups[i];
+            const spTrackEntry* group_entry = candidate->m_AnimationInstance;
+            if (candidate->m_SpineScene == spine_scene &&
+                candidate->m_SkeletonInstance->skin == skin &&
+                group_entry->animation == entry->animation &&
+                group_entry->loop == entry->loop &&
+                group_entry->reverse == entry->reverse &&
+                group_entry->timeScale == entry->timeScale &&
+                GetInstancePhaseDistance(group_entry, entry) <= world->m_InstanceTimeStep)
+            {
+                group = candidate;
+                break;
+            }
+        }
+
+        if (!group)
+        {
+            group = CreateInstanceGroup(spine_scene, skin, entry);
+            if (!group)
+                return;
+            if (world->m_InstanceGroups.Full())
+                world->m_InstanceGroups.OffsetCapacity(16);
+            world->m_InstanceGroups.Push(group);
+        }
+
+        if (group->m_Components.Full())
+            group->m_Components.OffsetCapacity(dmMath::Max(8U, group->m_Components.Capacity()));
+        group->m_Components.Push(component);
+        component->m_InstanceGroup = group;
+    }
+
+    static void RemoveFromInstanceGroup(SpineModelComponent* component)
+    {
+        SpineInstanceGroup* group = component->m_InstanceGroup;
+        component->m_InstanceGroup = 0;
+        for (uint32_t i = 0; i < group->m_Components.Size(); ++i)
+        {
+            if (group->m_Components[i] == component)
+            {
+                group->m_Components.EraseSwap(i);
+                break;
+            }
+        }
+        // Empty groups are deleted in the next update
+    }
+
+    // Called before the component diverges from the other instances (e.g. play_anim, IK targets or skins)
+    static void DetachFromInstanceGroup(SpineModelComponent* component)
+    {
+        SpineInstanceGroup* group = component->m_InstanceGroup;
+        if (!group)
+            return;
+        RemoveFromInstanceGroup(component);
+
+        // Continue from where the shared animation is. The events up until now were already sent by the group.
+        const spTrackEntry* src = group->m_AnimationInstance;
+        spTrackEntry* dst = component->m_AnimationTracks[0].m_AnimationInstance;
+        dst->trackTime          = src->trackTime;
+        dst->trackLast          = src->trackLast;
+        dst->nextTrackLast      = src->nextTrackLast;
+        dst->animationLast      = src->animationLast;
+        dst->nextAnimationLast  = src->nextAnimationLast;
+
+        spAnimationState_apply(component->m_AnimationStateInstance, component->m_SkeletonInstance);
+        if (!dmSpine::UpdateBakedPose(component->m_SkeletonInstance, dst))
+        {
+            spSkeleton_updateWorldTransform(component->m_SkeletonInstance, SP_PHYSICS_UPDATE);
+        }
+        // The cache only holds the bounds from the group, so the vertices are generated from the skeleton until the next update
+        component->m_WorldVertexCacheStale = 1;
+    }
+
     dmGameObject::CreateResult CompSpineModelCreate(const dmGameObject::ComponentCreateParams& params)
     {
         SpineModelWorld* world = (SpineModelWorld*)params.m_World;
@@ -585,25 +1070,24 @@ namespace dmSpine
 
         component->m_ComponentIndex = params.m_ComponentIndex;
         component->m_Enabled = 1;
+        component->m_Visible = 1; // So that the first update is a full one
+        component->m_PipelineItem = INVALID_PIPELINE_ITEM;
         component->m_World = Matrix4::identity();
         component->m_DoRender = 0;
         component->m_RenderConstants = 0;
 
-        component->m_SkeletonInstance = spSkeleton_create(spine_scene->m_Skeleton);
+        // Reuses the instances of a destroyed model if there are any (see spine.instance_pool_size)
+        dmSpine::SpineInstance instance;
+        dmSpine::AcquireInstance(&spine_scene->m_InstancePool, spine_scene->m_Skeleton, spine_scene->m_AnimationStateData, &instance);
+        component->m_Arena = instance.m_Arena;
+        component->m_SkeletonInstance = instance.m_Skeleton;
+        component->m_AnimationStateInstance = instance.m_AnimationState;
         if (!component->m_SkeletonInstance)
         {
             dmLogError("Failed to create skeleton instance");
             DestroyComponent(world, index);
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
-
-        if (0 == spSkeleton_setSkinByName(component->m_SkeletonInstance, component->m_Resource->m_Ddf->m_Skin))
-        {
-            spSkeleton_setSkin(component->m_SkeletonInstance, spine_scene->m_Skeleton->defaultSkin);
-        }
-        spSkeleton_setSlotsToSetupPose(component->m_SkeletonInstance);
-
-        component->m_AnimationStateInstance = spAnimationState_create(spine_scene->m_AnimationStateData);
         if (!component->m_AnimationStateInstance)
         {
             dmLogError("Failed to create animation state instance");
@@ -611,6 +1095,12 @@ namespace dmSpine
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
 
+        if (0 == spSkeleton_setSkinByName(component->m_SkeletonInstance, component->m_Resource->m_Ddf->m_Skin))
+        {
+            spSkeleton_setSkin(component->m_SkeletonInstance, spine_scene->m_Skeleton->defaultSkin);
+        }
+        spSkeleton_setSlotsToSetupPose(component->m_SkeletonInstance);
+
         component->m_AnimationStateInstance->userData = component;
         component->m_AnimationStateInstance->listener = SpineEventListener;
 
@@ -635,6 +1125,12 @@ namespace dmSpine
             component->m_Resource->m_Ddf->m_Offset, component->m_Resource->m_Ddf->m_PlaybackRate, 0);
             // TODO: Is the default playmode specified anywhere?
 
+        // Game object bones need their own skeleton
+        if (world->m_InstancedPlayback && !spine_model->m_CreateGoBones)
+        {
+            AttachToInstanceGroup(world, component);
+        }
+
         component->m_ReHash = 1;
 
         *params.m_UserData = (uintptr_t)index;
@@ -644,10 +1140,14 @@ namespace dmSpine
     static void DestroyComponent(SpineModelWorld* world, uint32_t index)
     {
         SpineModelComponent* component = world->m_Components.Get(index);
+        if (component->m_InstanceGroup)
+            RemoveFromInstanceGroup(component);
         dmGameObject::DeleteBones(component->m_Instance);
         // If we're going to use memset, then we should explicitly clear pose and instance arrays.
         component->m_BoneInstances.SetCapacity(0);
         component->m_AnimationTracks.SetCapacity(0);
+        component->m_WorldVertexCache.m_Positions.SetCapacity(0);
+        component->m_WorldVertexCache.m_Slots.SetCapacity(0);
         if (component->m_Material)
         {
             dmResource::Release(world->m_Factory, (void*)component->m_Material);
@@ -657,10 +1157,15 @@ namespace dmSpine
             dmGameSystem::DestroyRenderConstants(component->m_RenderConstants);
         }
 
-        if (component->m_AnimationStateInstance)
-            spAnimationState_dispose(component->m_AnimationStateInstance);
-        if (component->m_SkeletonInstance)
-            spSkeleton_dispose(component->m_SkeletonInstance);
+        if (component->m_PipelineSkeleton)
+            spSkeleton_dispose(component->m_PipelineSkeleton);
+
+        dmSpine::SpineInstance instance;
+        instance.m_Arena = component->m_Arena;
+        instance.m_Skeleton = component->m_SkeletonInstance;
+        instance.m_AnimationState = component->m_AnimationStateInstance;
+        SpineSceneResource* spine_scene = component->m_Resource->m_SpineScene;
+        dmSpine::ReleaseInstance(&spine_scene->m_InstancePool, spine_scene->m_Skeleton, &instance);
 
         delete component;
         world->m_Components.Free(index, true);
@@ -671,6 +1176,7 @@ namespace dmSpine
         //SpineModelContext* ctx = (SpineModelContext*)params.m_Context;
         SpineModelWorld* world = (SpineModelWorld*)params.m_World;
         uint32_t index = *params.m_UserData;
+        WaitForPipeline(world);
         DestroyComponent(world, index);
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -680,18 +1186,13 @@ namespace dmSpine
         if (component->m_BoneInstances.Empty())
             return;
 
-        uint32_t size = component->m_Bones.Size();
-        dmArray<dmTransform::Transform> transforms;
-        transforms.SetCapacity(size);
-        transforms.SetSize(size);
-
+        DM_PROFILE("BoneSync");
+        uint32_t size = component->m_BoneInstances.Size();
         DM_PROPERTY_ADD_U32(rmtp_SpineBones, size);
+        spBone** bones = component->m_SkeletonInstance->bones;
         for (uint32_t n = 0; n < size; ++n)
         {
-            spBone* bone = component->m_Bones[n];
-
-            dmGameObject::HInstance bone_instance = component->m_BoneInstances[n];
-            SetTransformFromBone(bone_instance, component->m_Transform, bone);
+            SetTransformFromBone(component->m_BoneInstances[n], component->m_Transform, bones[n]);
         }
     }
 
@@ -731,73 +1232,315 @@ namespace dmSpine
     }
 
 
-    dmGameObject::UpdateResult CompSpineModelUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    static void UpdateInstanceGroup(SpineModelWorld* world, SpineInstanceGroup* group, float dt)
     {
-        SpineModelWorld* world = (SpineModelWorld*)params.m_World;
-
-        float dt = params.m_UpdateContext->m_DT;
+        if (group->m_UpdateFrame == world->m_Frame)
+            return;
+        group->m_UpdateFrame = world->m_Frame;
 
-        dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
-        const uint32_t count = components.Size();
-        DM_PROPERTY_ADD_U32(rmtp_SpineComponents, count);
-        uint32_t num_active = 0;
-        for (uint32_t i = 0; i < count; ++i)
+        spAnimationState_update(group->m_AnimationStateInstance, dt);
+        spAnimationState_apply(group->m_AnimationStateInstance, group->m_SkeletonInstance);
+        spSkeleton_update(group->m_SkeletonInstance, dt);
+        if (!dmSpine::UpdateBakedPose(group->m_SkeletonInstance, group->m_AnimationInstance))
         {
-            SpineModelComponent& component = *components[i];
-            component.m_DoRender = 0;
+            spSkeleton_updateWorldTransform(group->m_SkeletonInstance, SP_PHYSICS_UPDATE);
+        }
+
+        dmSpine::UpdateWorldVertexCache(group->m_VertexCache, group->m_SkeletonInstance, Matrix4::identity());
+        group->m_VerticesDirty = 1;
+    }
+
+    static void UpdateInstanceBounds(SpineModelComponent* component)
+    {
+        const SpineInstanceGroup* group = component->m_InstanceGroup;
+        const dmSpine::SpineWorldVertexCache& local = group->m_VertexCache;
+        dmSpine::SpineWorldVertexCache& cache = component->m_WorldVertexCache;
+        const Matrix4& world = component->m_World;
 
-            if (!component.m_SkeletonInstance || !component.m_AnimationStateInstance)
+        // Transform the center and extents of the skeleton space bounds
+        for (uint32_t row = 0; row < 3; ++row)
+        {
+            float center = world.getElem(3, row);
+            float extent = 0.0f;
+            for (uint32_t col = 0; col < 3; ++col)
             {
-                component.m_Enabled = false;
+                center += world.getElem(col, row) * (local.m_Min[col] + local.m_Max[col]) * 0.5f;
+                extent += fabsf(world.getElem(col, row)) * (local.m_Max[col] - local.m_Min[col]) * 0.5f;
             }
+            cache.m_Min[row] = center - extent;
+            cache.m_Max[row] = center + extent;
+        }
+        cache.m_VertexCount = local.m_VertexCount;
+        cache.m_IndexCount = local.m_IndexCount;
+        component->m_WorldVertexCacheOrigin = Point3(world.getCol(3).getXYZ());
 
-            if (!component.m_Enabled || !component.m_AddedToUpdate)
-                continue;
+        // Keep the track in sync, for the cursor property
+        component->m_AnimationTracks[0].m_AnimationInstance->trackTime = group->m_AnimationInstance->trackTime;
+    }
 
-            const Matrix4& go_world = dmGameObject::GetWorldMatrix(component.m_Instance);
-            const Matrix4 local = dmTransform::ToMatrix4(component.m_Transform);
-            // if (dmGameObject::ScaleAlongZ(component.m_Instance))
-            // {
-            //     component.m_World = go_world * local;
-            // }
-            // else
+    // Updates the animation and the pose of a component. In the parallel update, this is called on the worker threads,
+    // so it mustn't touch anything that is shared with the other components (see FinishComponentUpdate)
+    static void UpdateComponent(SpineModelWorld* world, SpineModelComponent& component, float dt)
+    {
+        component.m_DoRender = 0;
+
+        if (!component.m_SkeletonInstance || !component.m_AnimationStateInstance)
+        {
+            component.m_Enabled = false;
+        }
+
+        if (!component.m_Enabled || !component.m_AddedToUpdate)
+            return;
+
+        const Matrix4& go_world = dmGameObject::GetWorldMatrix(component.m_Instance);
+        const Matrix4 local = dmTransform::ToMatrix4(component.m_Transform);
+        // if (dmGameObject::ScaleAlongZ(component.m_Instance))
+        // {
+        //     component.m_World = go_world * local;
+        // }
+        // else
+        {
+            component.m_World = dmTransform::MulNoScaleZ(go_world, local);
+        }
+
+        // Models that weren't drawn last frame may do less work, depending on their offscreen update policy.
+        // They're still submitted for rendering, so that the culling can tell when they're visible again.
+        bool update_pose = true;
+        bool skip_update = false;
+        component.m_PendingDt += dt;
+        if (component.m_InstanceGroup)
+        {
+            // The animation is evaluated once for the whole group, and each component only transforms the bounds
+            UpdateInstanceGroup(world, component.m_InstanceGroup, dt);
+            UpdateInstanceBounds(&component);
+            component.m_PendingDt = 0.0f;
+            skip_update = true;
+        }
+        else if (!component.m_Visible)
+        {
+            switch (component.m_Resource->m_Ddf->m_OffscreenUpdate)
             {
-                component.m_World = dmTransform::MulNoScaleZ(go_world, local);
+                case dmGameSystemDDF::SpineModelDesc::OFFSCREEN_UPDATE_ADVANCE_TIME:
+                    update_pose = false;
+                    break;
+                case dmGameSystemDDF::SpineModelDesc::OFFSCREEN_UPDATE_REDUCED_RATE:
+                    skip_update = ++component.m_OffscreenFrames < world->m_OffscreenUpdateInterval;
+                    break;
+                default:
+                    break;
             }
+        }
 
-            ++num_active;
+        if (!skip_update)
+        {
+            float component_dt = component.m_PendingDt;
+            component.m_PendingDt = 0.0f;
+            component.m_OffscreenFrames = 0;
 
             // docs: http://esotericsoftware.com/spine-runtime-skeletons
-            spAnimationState_update(component.m_AnimationStateInstance, dt);
-            spAnimationState_apply(component.m_AnimationStateInstance, component.m_SkeletonInstance);
+            {
+                DM_PROFILE("AnimationUpdate");
+                spAnimationState_update(component.m_AnimationStateInstance, component_dt);
+            }
+            {
+                DM_PROFILE("AnimationApply");
+                // Without a pose update, only the events are fired. The timelines are applied again
+                // in the first frame the model is visible.
+                if (update_pose)
+                {
+                    // The bones that were mixed out in the meantime would otherwise keep their old pose
+                    if (component.m_PoseStale)
+                        spSkeleton_setBonesToSetupPose(component.m_SkeletonInstance);
+                    spAnimationState_apply(component.m_AnimationStateInstance, component.m_SkeletonInstance);
+                }
+                else
+                {
+                    spAnimationState_applyEvents(component.m_AnimationStateInstance, component.m_SkeletonInstance);
+                }
+                component.m_PoseStale = !update_pose;
+            }
 
-            ApplyIKTargets(&component);
+            spSkeleton_update(component.m_SkeletonInstance, component_dt);
 
-            spSkeleton_update(component.m_SkeletonInstance, dt);
-            spSkeleton_updateWorldTransform(component.m_SkeletonInstance, SP_PHYSICS_UPDATE);
+            if (update_pose)
+            {
+                // Baked animations are posed directly from their samples, without any constraints
+                if (!dmSpine::UpdateBakedPose(component.m_SkeletonInstance, spAnimationState_getCurrent(component.m_AnimationStateInstance, 0)))
+                {
+                    {
+                        DM_PROFILE("IKTargets");
+                        ApplyIKTargets(&component);
+                    }
 
-            // Update the game world objects
-            UpdateBones(&component);
+                    DM_PROFILE("WorldTransform");
+                    spSkeleton_updateWorldTransform(component.m_SkeletonInstance, SP_PHYSICS_UPDATE);
+                }
 
-            if (component.m_ReHash || (component.m_RenderConstants && dmGameSystem::AreRenderConstantsUpdated(component.m_RenderConstants)))
-            {
-                ReHash(&component);
+                // The positions are shared between the culling and the vertex generation
+                DM_PROFILE("Bounds");
+                dmSpine::UpdateWorldVertexCache(component.m_WorldVertexCache, component.m_SkeletonInstance, component.m_World);
+                component.m_WorldVertexCacheOrigin = Point3(component.m_World.getCol(3).getXYZ());
             }
+        }
+        component.m_WorldVertexCacheStale = !component.m_InstanceGroup && (skip_update || !update_pose);
+        component.m_DoRender = 1;
+    }
+
+    // The part of the update that touches the game objects, or the render state. Always called on the main thread.
+    static void FinishComponentUpdate(SpineModelComponent& component)
+    {
+        if (!component.m_DoRender)
+            return;
 
-            component.m_DoRender = 1;
+        // Update the game world objects, if the pose was updated
+        if (!component.m_InstanceGroup && !component.m_WorldVertexCacheStale)
+        {
+            UpdateBones(&component);
         }
 
-        // Since we've moved the child game objects (bones), we need to sync back the transforms
-        update_result.m_TransformsUpdated = num_active > 0;
-        return dmGameObject::UPDATE_RESULT_OK;
+        if (component.m_ReHash || (component.m_RenderConstants && dmGameSystem::AreRenderConstantsUpdated(component.m_RenderConstants)))
+        {
+            ReHash(&component);
+        }
     }
 
-    static inline dmGameSystemDDF::SpineModelDesc::BlendMode SpineBlendModeToRenderBlendMode(spBlendMode sp_blend_mode)
+    // Sequence attachments are updated in place when their vertices are computed, and they're shared by all instances
+    static inline bool CanUpdateInParallel(const SpineModelComponent& component)
     {
-        switch(sp_blend_mode)
-        {
-            case SP_BLEND_MODE_NORMAL:
-                return dmGameSystemDDF::SpineModelDesc::BLEND_MODE_ALPHA;
+        return !component.m_Resource->m_SpineScene->m_HasSequences;
+    }
+
+    struct SpineUpdateJob
+    {
+        SpineModelWorld*    m_World;
+        float               m_Dt;
+    };
+
+    static void UpdateComponentsJob(void* context, uint32_t thread_index, uint32_t begin, uint32_t end)
+    {
+        SpineUpdateJob* job = (SpineUpdateJob*)context;
+        SpineModelWorld* world = job->m_World;
+        SpineWorkerData* data = &world->m_WorkerData[thread_index];
+        dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            SpineModelComponent& component = *components[i];
+            if (!CanUpdateInParallel(component))
+                continue;
+
+            data->m_ComponentIndex = i;
+            component.m_WorkerData = data;
+            UpdateComponent(world, component, job->m_Dt);
+            component.m_WorkerData = 0;
+        }
+    }
+
+    static void UpdateComponentsParallel(SpineModelWorld* world, float dt)
+    {
+        dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
+        const uint32_t count = components.Size();
+
+        ResetDeferredEvents(world);
+
+        // The instance groups fire the events of all their components, so they're updated up front. Their events
+        // are sent where the first component of the group would have been updated in the serial update.
+        SpineWorkerData* group_data = &world->m_GroupEventData;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            SpineModelComponent& component = *components[i];
+            SpineInstanceGroup* group = component.m_InstanceGroup;
+            if (!group || !component.m_Enabled || !component.m_AddedToUpdate || group->m_UpdateFrame == world->m_Frame)
+                continue;
+
+            group_data->m_ComponentIndex = i;
+            for (uint32_t j = 0; j < group->m_Components.Size(); ++j)
+                group->m_Components[j]->m_WorkerData = group_data;
+            UpdateInstanceGroup(world, group, dt);
+            for (uint32_t j = 0; j < group->m_Components.Size(); ++j)
+                group->m_Components[j]->m_WorkerData = 0;
+        }
+
+        SpineUpdateJob job;
+        job.m_World = world;
+        job.m_Dt = dt;
+        ParallelFor(world->m_WorkerPool, count, PARALLEL_UPDATE_CHUNK_SIZE, UpdateComponentsJob, &job);
+
+        // The components that can't be updated in parallel send their events right away, so we send the
+        // deferred events of the components before them first. This keeps the order of the serial update.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            SpineModelComponent& component = *components[i];
+            if (!CanUpdateInParallel(component))
+            {
+                SendDeferredEvents(world, i);
+                UpdateComponent(world, component, dt);
+            }
+        }
+        SendDeferredEvents(world, count);
+        ResetDeferredEvents(world);
+    }
+
+    dmGameObject::UpdateResult CompSpineModelUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+    {
+        DM_PROFILE("SpineModelUpdate");
+        SpineModelWorld* world = (SpineModelWorld*)params.m_World;
+
+        float dt = params.m_UpdateContext->m_DT;
+        ++world->m_Frame;
+
+        // In case the last frame wasn't rendered
+        WaitForPipeline(world);
+
+        for (uint32_t i = 0; i < world->m_InstanceGroups.Size();)
+        {
+            SpineInstanceGroup* group = world->m_InstanceGroups[i];
+            if (group->m_Components.Empty())
+            {
+                DestroyInstanceGroup(group);
+                world->m_InstanceGroups.EraseSwap(i);
+                continue;
+            }
+            ++i;
+        }
+
+        dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
+        const uint32_t count = components.Size();
+        DM_PROPERTY_ADD_U32(rmtp_SpineComponents, count);
+
+        bool parallel = world->m_WorkerPool && world->m_ParallelUpdate;
+        if (parallel)
+        {
+            UpdateComponentsParallel(world, dt);
+        }
+
+        uint32_t num_active = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            SpineModelComponent& component = *components[i];
+            if (!parallel)
+            {
+                UpdateComponent(world, component, dt);
+            }
+            FinishComponentUpdate(component);
+            num_active += component.m_DoRender;
+        }
+
+        if (world->m_PipelinedVertexGeneration)
+        {
+            StartPipeline(world);
+        }
+
+        // Since we've moved the child game objects (bones), we need to sync back the transforms
+        update_result.m_TransformsUpdated = num_active > 0;
+        return dmGameObject::UPDATE_RESULT_OK;
+    }
+
+    static inline dmGameSystemDDF::SpineModelDesc::BlendMode SpineBlendModeToRenderBlendMode(spBlendMode sp_blend_mode)
+    {
+        switch(sp_blend_mode)
+        {
+            case SP_BLEND_MODE_NORMAL:
+                return dmGameSystemDDF::SpineModelDesc::BLEND_MODE_ALPHA;
             case SP_BLEND_MODE_ADDITIVE:
                 return dmGameSystemDDF::SpineModelDesc::BLEND_MODE_ADD;
             case SP_BLEND_MODE_MULTIPLY:
@@ -816,15 +1559,16 @@ namespace dmSpine
         dmGraphics::HTexture                       texture,
         dmRender::HMaterial                        material,
         dmGameSystemDDF::SpineModelDesc::BlendMode blend_mode,
-        uint32_t                                   vertex_start,
-        uint32_t                                   vertex_count)
+        uint32_t                                   index_start,
+        uint32_t                                   index_count)
     {
         ro.Init();
         ro.m_VertexDeclaration = world->m_VertexDeclaration;
         ro.m_VertexBuffer      = world->m_VertexBuffer;
+        ro.m_IndexBuffer       = world->m_IndexBuffer;
         ro.m_PrimitiveType     = dmGraphics::PRIMITIVE_TRIANGLES;
-        ro.m_VertexStart       = vertex_start;
-        ro.m_VertexCount       = vertex_count;
+        ro.m_VertexStart       = index_start;   // index offset, converted to a byte offset when the index type is known (see UploadBuffers)
+        ro.m_VertexCount       = index_count;
         ro.m_Textures[0]       = texture;
         ro.m_Material          = material;
 
@@ -866,9 +1610,423 @@ namespace dmSpine
         dmRender::AddToRender(render_context, &ro);
     }
 
+    template <typename T>
+    static void ReserveArray(dmArray<T>& array, uint32_t num_to_add)
+    {
+        if (array.Remaining() < num_to_add)
+        {
+            array.OffsetCapacity(num_to_add - array.Remaining());
+        }
+    }
+
+    static inline const spSkeleton* GetRenderSkeleton(const SpineModelComponent* component)
+    {
+        return component->m_InstanceGroup ? component->m_InstanceGroup->m_SkeletonInstance : component->m_SkeletonInstance;
+    }
+
+    // Generates the skeleton space vertices of the group, once per pose update
+    static void GenerateInstanceGroupVertexData(SpineModelWorld* world, SpineInstanceGroup* group, SpineVertexStats* stats)
+    {
+        if (!group->m_VerticesDirty)
+            return;
+        group->m_VerticesDirty = 0;
+
+        const Matrix4 identity = Matrix4::identity();
+        group->m_IndexBufferData.SetSize(0);
+        group->m_DrawDescBuffer.SetSize(0);
+        if (world->m_CompactVertexFormat)
+        {
+            group->m_CompactVertexBufferData.SetSize(0);
+            dmSpine::GenerateIndexedVertexData(group->m_CompactVertexBufferData, group->m_IndexBufferData, group->m_SkeletonInstance, world->m_SkeletonClipper, &world->m_Scratch, identity, &group->m_VertexCache, &group->m_DrawDescBuffer, stats);
+        }
+        else
+        {
+            group->m_VertexBufferData.SetSize(0);
+            dmSpine::GenerateIndexedVertexData(group->m_VertexBufferData, group->m_IndexBufferData, group->m_SkeletonInstance, world->m_SkeletonClipper, &world->m_Scratch, identity, &group->m_VertexCache, &group->m_DrawDescBuffer, stats);
+        }
+    }
+
+    // Copies the group vertices, transformed by the component world matrix. Returns the first vertex
+    template <typename T>
+    static uint32_t AppendInstanceVertexData(dmArray<T>& vertex_buffer, dmArray<uint32_t>& index_buffer, const dmArray<T>& src_vertices, const dmArray<uint32_t>& src_indices, const Matrix4& world)
+    {
+        uint32_t vertex_start = vertex_buffer.Size();
+        uint32_t vertex_count = src_vertices.Size();
+        uint32_t index_count = src_indices.Size();
+        ReserveArray(vertex_buffer, vertex_count);
+        ReserveArray(index_buffer, index_count);
+
+        const float m00 = world.getElem(0, 0), m10 = world.getElem(1, 0), m20 = world.getElem(2, 0), m30 = world.getElem(3, 0);
+        const float m01 = world.getElem(0, 1), m11 = world.getElem(1, 1), m21 = world.getElem(2, 1), m31 = world.getElem(3, 1);
+        const float m02 = world.getElem(0, 2), m12 = world.getElem(1, 2), m22 = world.getElem(2, 2), m32 = world.getElem(3, 2);
+
+        vertex_buffer.SetSize(vertex_start + vertex_count);
+        T* dst = vertex_buffer.Begin() + vertex_start;
+        const T* src = src_vertices.Begin();
+        for (uint32_t i = 0; i < vertex_count; ++i, ++dst, ++src)
+        {
+            *dst = *src;
+            dst->x = m00 * src->x + m10 * src->y + m20 * src->z + m30;
+            dst->y = m01 * src->x + m11 * src->y + m21 * src->z + m31;
+            dst->z = m02 * src->x + m12 * src->y + m22 * src->z + m32;
+        }
+
+        uint32_t index_start = index_buffer.Size();
+        index_buffer.SetSize(index_start + index_count);
+        uint32_t* dst_index = index_buffer.Begin() + index_start;
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            dst_index[i] = src_indices[i] + vertex_start;
+        }
+        return vertex_start;
+    }
+
+    // The group vertices must have been generated (see GenerateInstanceGroupVertexData)
+    static void AppendInstanceDrawData(SpineModelWorld* world, const SpineInstanceGroup* group, const Matrix4& transform, dmArray<dmSpine::SpineVertex>& vertex_buffer,
+                                        dmArray<dmSpine::SpineVertexCompact>& compact_vertex_buffer, dmArray<uint32_t>& index_buffer, dmArray<SpineDrawDesc>* draw_descs)
+    {
+        uint32_t index_start = index_buffer.Size();
+        uint32_t vertex_start;
+        if (world->m_CompactVertexFormat)
+            vertex_start = AppendInstanceVertexData(compact_vertex_buffer, index_buffer, group->m_CompactVertexBufferData, group->m_IndexBufferData, transform);
+        else
+            vertex_start = AppendInstanceVertexData(vertex_buffer, index_buffer, group->m_VertexBufferData, group->m_IndexBufferData, transform);
+
+        if (draw_descs)
+        {
+            ReserveArray(*draw_descs, group->m_DrawDescBuffer.Size());
+            for (uint32_t i = 0; i < group->m_DrawDescBuffer.Size(); ++i)
+            {
+                SpineDrawDesc desc = group->m_DrawDescBuffer[i];
+                desc.m_VertexStart += vertex_start;
+                desc.m_IndexStart += index_start;
+                draw_descs->Push(desc);
+            }
+        }
+    }
+
+    // Appends the vertices of a component. The indices and draw descs are absolute offsets into the given buffers.
+    // The skeleton and group are passed separately, since the pipelined vertex generation uses a snapshot
+    static void AddVertexStats(SpineVertexStats* stats, const SpineVertexStats& other)
+    {
+        stats->m_ClipPasses += other.m_ClipPasses;
+        stats->m_ClippedTriangles += other.m_ClippedTriangles;
+        stats->m_Vertices += other.m_Vertices;
+    }
+
+    static void ReportVertexStats(const SpineVertexStats& stats)
+    {
+        DM_PROPERTY_ADD_U32(rmtp_SpineClipPasses, stats.m_ClipPasses);
+        DM_PROPERTY_ADD_U32(rmtp_SpineClippedTriangles, stats.m_ClippedTriangles);
+        DM_PROPERTY_ADD_U32(rmtp_SpineVertices, stats.m_Vertices);
+    }
+
+    static void GenerateComponentVertexData(SpineModelWorld* world, const SpineModelComponent* component, const spSkeleton* skeleton, const SpineInstanceGroup* group,
+                                            dmArray<dmSpine::SpineVertex>& vertex_buffer, dmArray<dmSpine::SpineVertexCompact>& compact_vertex_buffer, dmArray<uint32_t>& index_buffer,
+                                            spSkeletonClipping* clipper, SpineScratch* scratch, dmArray<SpineDrawDesc>* draw_descs, SpineVertexStats* stats)
+    {
+        if (group)
+        {
+            AppendInstanceDrawData(world, group, component->m_World, vertex_buffer, compact_vertex_buffer, index_buffer, draw_descs);
+            return;
+        }
+
+        // A stale cache has the positions from an older world transform, so we regenerate them instead
+        const dmSpine::SpineWorldVertexCache* cache = component->m_WorldVertexCacheStale ? 0 : &component->m_WorldVertexCache;
+        if (world->m_CompactVertexFormat)
+            dmSpine::GenerateIndexedVertexData(compact_vertex_buffer, index_buffer, skeleton, clipper, scratch, component->m_World, cache, draw_descs, stats);
+        else
+            dmSpine::GenerateIndexedVertexData(vertex_buffer, index_buffer, skeleton, clipper, scratch, component->m_World, cache, draw_descs, stats);
+    }
+
+    static void ResetWorkerBuffers(SpineModelWorld* world, SpineWorkerData* data)
+    {
+        for (uint32_t i = 0; i < world->m_WorkerDataCount; ++i)
+        {
+            data[i].m_VertexBufferData.SetSize(0);
+            data[i].m_CompactVertexBufferData.SetSize(0);
+            data[i].m_IndexBufferData.SetSize(0);
+            data[i].m_DrawDescBuffer.SetSize(0);
+            memset(&data[i].m_Stats, 0, sizeof(data[i].m_Stats));
+        }
+    }
+
+    static void GenerateBatchJob(void* context, uint32_t thread_index, uint32_t begin, uint32_t end)
+    {
+        SpineBatchJob* job = (SpineBatchJob*)context;
+        SpineModelWorld* world = job->m_World;
+        SpineWorkerData* data = &job->m_Data[thread_index];
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            SpineBatchItem& item = (*job->m_Items)[i];
+            item.m_Thread = thread_index;
+            item.m_VertexStart = world->m_CompactVertexFormat ? data->m_CompactVertexBufferData.Size() : data->m_VertexBufferData.Size();
+            item.m_IndexStart = data->m_IndexBufferData.Size();
+            item.m_DrawDescStart = data->m_DrawDescBuffer.Size();
+
+            GenerateComponentVertexData(world, item.m_Component, item.m_Skeleton, item.m_InstanceGroup, data->m_VertexBufferData, data->m_CompactVertexBufferData,
+                                        data->m_IndexBufferData, data->m_SkeletonClipper, &data->m_Scratch, job->m_UseDrawDescs ? &data->m_DrawDescBuffer : 0, &data->m_Stats);
+
+            item.m_VertexCount = (world->m_CompactVertexFormat ? data->m_CompactVertexBufferData.Size() : data->m_VertexBufferData.Size()) - item.m_VertexStart;
+            item.m_IndexCount = data->m_IndexBufferData.Size() - item.m_IndexStart;
+            item.m_DrawDescCount = data->m_DrawDescBuffer.Size() - item.m_DrawDescStart;
+        }
+    }
+
+    template <typename T>
+    static void CopyBatchVertices(dmArray<T>& dst, const dmArray<T>& src, const SpineBatchItem& item)
+    {
+        memcpy(dst.Begin() + item.m_DstVertexStart, src.Begin() + item.m_VertexStart, sizeof(T) * item.m_VertexCount);
+    }
+
+    // Copies the output of an item to its range in the world buffers (which must already be big enough)
+    static void CopyBatchItem(SpineModelWorld* world, const SpineBatchItem& item, const SpineWorkerData* data, bool copy_draw_descs)
+    {
+        if (world->m_CompactVertexFormat)
+            CopyBatchVertices(world->m_CompactVertexBufferData, data->m_CompactVertexBufferData, item);
+        else
+            CopyBatchVertices(world->m_VertexBufferData, data->m_VertexBufferData, item);
+
+        // Rebase the indices and draw descs on the world buffers
+        uint32_t vertex_offset = item.m_DstVertexStart - item.m_VertexStart;
+        uint32_t index_offset = item.m_DstIndexStart - item.m_IndexStart;
+
+        uint32_t* dst_index = world->m_IndexBufferData.Begin() + item.m_DstIndexStart;
+        const uint32_t* src_index = data->m_IndexBufferData.Begin() + item.m_IndexStart;
+        for (uint32_t j = 0; j < item.m_IndexCount; ++j)
+        {
+            dst_index[j] = src_index[j] + vertex_offset;
+        }
+
+        if (!copy_draw_descs)
+            return;
+
+        for (uint32_t j = 0; j < item.m_DrawDescCount; ++j)
+        {
+            SpineDrawDesc desc = data->m_DrawDescBuffer[item.m_DrawDescStart + j];
+            desc.m_VertexStart += vertex_offset;
+            desc.m_IndexStart += index_offset;
+            world->m_DrawDescBuffer[item.m_DstDrawDescStart + j] = desc;
+        }
+    }
+
+    // Sizes the output of each item, so that it can be generated in place (see GenerateBatchParallel)
+    static void SizeBatchJob(void* context, uint32_t thread_index, uint32_t begin, uint32_t end)
+    {
+        SpineBatchJob* job = (SpineBatchJob*)context;
+        SpineModelWorld* world = job->m_World;
+        SpineWorkerData* data = &job->m_Data[thread_index];
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            SpineBatchItem& item = (*job->m_Items)[i];
+            item.m_Thread = thread_index;
+            const SpineInstanceGroup* group = item.m_InstanceGroup;
+            if (group)
+            {
+                // The group vertices are already generated, and are only transformed
+                item.m_VertexCount = world->m_CompactVertexFormat ? group->m_CompactVertexBufferData.Size() : group->m_VertexBufferData.Size();
+                item.m_IndexCount = group->m_IndexBufferData.Size();
+                item.m_DrawDescCount = group->m_DrawDescBuffer.Size();
+            }
+            else
+            {
+                SpineVertexDataSize size;
+                dmSpine::CalcIndexedVertexDataSize(item.m_Skeleton, data->m_SkeletonClipper, &data->m_Scratch, &size);
+                item.m_VertexCount = size.m_VertexCount;
+                item.m_IndexCount = size.m_IndexCount;
+                item.m_DrawDescCount = size.m_DrawDescCount;
+            }
+            if (!job->m_UseDrawDescs)
+                item.m_DrawDescCount = 0;
+        }
+    }
+
+    // Generates each item directly into its range of the world buffers. The ranges are viewed as arrays
+    // that end with the range, so the indices and draw descs are absolute, and the arrays never grow
+    static void GenerateBatchInPlaceJob(void* context, uint32_t thread_index, uint32_t begin, uint32_t end)
+    {
+        SpineBatchJob* job = (SpineBatchJob*)context;
+        SpineModelWorld* world = job->m_World;
+        SpineWorkerData* data = &job->m_Data[thread_index];
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const SpineBatchItem& item = (*job->m_Items)[i];
+            dmArray<uint32_t> indices(world->m_IndexBufferData.Begin(), item.m_DstIndexStart, item.m_DstIndexStart + item.m_IndexCount);
+            dmArray<SpineDrawDesc> draw_descs(world->m_DrawDescBuffer.Begin(), item.m_DstDrawDescStart, item.m_DstDrawDescStart + item.m_DrawDescCount);
+            dmArray<SpineDrawDesc>* draw_descs_out = job->m_UseDrawDescs ? &draw_descs : 0;
+
+            // Only the vertex buffer of the world format is written to, so the thread buffer stands in for the other one
+            bool full;
+            if (world->m_CompactVertexFormat)
+            {
+                dmArray<dmSpine::SpineVertexCompact> vertices(world->m_CompactVertexBufferData.Begin(), item.m_DstVertexStart, item.m_DstVertexStart + item.m_VertexCount);
+                GenerateComponentVertexData(world, item.m_Component, item.m_Skeleton, item.m_InstanceGroup, data->m_VertexBufferData, vertices,
+                                            indices, data->m_SkeletonClipper, &data->m_Scratch, draw_descs_out, &data->m_Stats);
+                full = vertices.Full();
+            }
+            else
+            {
+                dmArray<dmSpine::SpineVertex> vertices(world->m_VertexBufferData.Begin(), item.m_DstVertexStart, item.m_DstVertexStart + item.m_VertexCount);
+                GenerateComponentVertexData(world, item.m_Component, item.m_Skeleton, item.m_InstanceGroup, vertices, data->m_CompactVertexBufferData,
+                                            indices, data->m_SkeletonClipper, &data->m_Scratch, draw_descs_out, &data->m_Stats);
+                full = vertices.Full();
+            }
+            // The sizes must match the output exactly, or the neighbouring ranges would be wrong
+            assert(full && indices.Full() && draw_descs.Full());
+            (void)full;
+        }
+    }
+
+    // Resizes a world buffer to fit the batch. It always has storage, since the views of the ranges need one
+    template <typename T>
+    static void ResizeBatchBuffer(dmArray<T>& array, uint32_t size)
+    {
+        ReserveArray(array, dmMath::Max(size, 1U) - array.Size());
+        array.SetSize(size);
+    }
+
+    // The components are sized first, which gives every component a fixed range in the world buffers.
+    // They're then generated in place in parallel, instead of being generated per thread and copied.
+    // Only the clipped attachments are computed twice, since the clipping output size isn't known up front
+    static void GenerateBatchParallel(SpineModelWorld* world, bool use_draw_descs, SpineVertexStats* stats)
+    {
+        ResetWorkerBuffers(world, world->m_WorkerData);
+
+        SpineBatchJob job;
+        job.m_World = world;
+        job.m_Data = world->m_WorkerData;
+        job.m_Items = &world->m_BatchItems;
+        job.m_UseDrawDescs = use_draw_descs;
+
+        uint32_t item_count = world->m_BatchItems.Size();
+        ParallelFor(world->m_WorkerPool, item_count, PARALLEL_VERTEX_CHUNK_SIZE, SizeBatchJob, &job);
+
+        uint32_t vertex_start = world->m_CompactVertexFormat ? world->m_CompactVertexBufferData.Size() : world->m_VertexBufferData.Size();
+        uint32_t index_start = world->m_IndexBufferData.Size();
+        uint32_t draw_desc_start = world->m_DrawDescBuffer.Size();
+        for (uint32_t i = 0; i < item_count; ++i)
+        {
+            SpineBatchItem& item = world->m_BatchItems[i];
+            item.m_DstVertexStart = vertex_start;
+            item.m_DstIndexStart = index_start;
+            item.m_DstDrawDescStart = draw_desc_start;
+            vertex_start += item.m_VertexCount;
+            index_start += item.m_IndexCount;
+            draw_desc_start += item.m_DrawDescCount;
+        }
+
+        if (world->m_CompactVertexFormat)
+            ResizeBatchBuffer(world->m_CompactVertexBufferData, vertex_start);
+        else
+            ResizeBatchBuffer(world->m_VertexBufferData, vertex_start);
+        ResizeBatchBuffer(world->m_IndexBufferData, index_start);
+        ResizeBatchBuffer(world->m_DrawDescBuffer, draw_desc_start);
+
+        ParallelFor(world->m_WorkerPool, item_count, PARALLEL_VERTEX_CHUNK_SIZE, GenerateBatchInPlaceJob, &job);
+
+        for (uint32_t i = 0; i < world->m_WorkerDataCount; ++i)
+        {
+            AddVertexStats(stats, world->m_WorkerData[i].m_Stats);
+        }
+    }
+
+    static const SpineBatchItem* GetPipelineItem(SpineModelWorld* world, const SpineModelComponent* component)
+    {
+        if (component->m_PipelineItem == INVALID_PIPELINE_ITEM)
+            return 0;
+        return &world->m_PipelineItems[component->m_PipelineItem];
+    }
+
+    static void AppendPipelineItem(SpineModelWorld* world, const SpineBatchItem& pipeline_item, bool copy_draw_descs)
+    {
+        SpineBatchItem item = pipeline_item;
+        if (world->m_CompactVertexFormat)
+        {
+            item.m_DstVertexStart = world->m_CompactVertexBufferData.Size();
+            ReserveArray(world->m_CompactVertexBufferData, item.m_VertexCount);
+            world->m_CompactVertexBufferData.SetSize(item.m_DstVertexStart + item.m_VertexCount);
+        }
+        else
+        {
+            item.m_DstVertexStart = world->m_VertexBufferData.Size();
+            ReserveArray(world->m_VertexBufferData, item.m_VertexCount);
+            world->m_VertexBufferData.SetSize(item.m_DstVertexStart + item.m_VertexCount);
+        }
+        item.m_DstIndexStart = world->m_IndexBufferData.Size();
+        ReserveArray(world->m_IndexBufferData, item.m_IndexCount);
+        world->m_IndexBufferData.SetSize(item.m_DstIndexStart + item.m_IndexCount);
+        if (copy_draw_descs)
+        {
+            item.m_DstDrawDescStart = world->m_DrawDescBuffer.Size();
+            ReserveArray(world->m_DrawDescBuffer, item.m_DrawDescCount);
+            world->m_DrawDescBuffer.SetSize(item.m_DstDrawDescStart + item.m_DrawDescCount);
+        }
+        CopyBatchItem(world, item, &world->m_PipelineData[item.m_Thread], copy_draw_descs);
+    }
+
+    // Snapshots the poses of the components that were drawn last frame, and starts generating their vertices on the
+    // worker threads. RenderBatch copies the results, so the scripts may change the skeletons in the meantime.
+    static void StartPipeline(SpineModelWorld* world)
+    {
+        ResetWorkerBuffers(world, world->m_PipelineData);
+        world->m_PipelineItems.SetSize(0);
+
+        dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
+        const uint32_t count = components.Size();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            SpineModelComponent& component = *components[i];
+            component.m_PipelineItem = INVALID_PIPELINE_ITEM;
+            if (!component.m_DoRender || !component.m_Visible || component.m_InstanceGroup || !CanUpdateInParallel(component))
+                continue;
+
+            spSkeleton* skeleton = component.m_SkeletonInstance;
+            if (component.m_PipelineSkeleton && component.m_PipelineSkeleton->data != skeleton->data)
+            {
+                spSkeleton_dispose(component.m_PipelineSkeleton);
+                component.m_PipelineSkeleton = 0;
+            }
+            if (!component.m_PipelineSkeleton)
+                component.m_PipelineSkeleton = spSkeleton_create(skeleton->data);
+            dmSpine::CopySkeletonPose(component.m_PipelineSkeleton, skeleton);
+
+            SpineBatchItem item = {};
+            item.m_Component = &component;
+            item.m_Skeleton = component.m_PipelineSkeleton;
+            component.m_PipelineItem = world->m_PipelineItems.Size();
+            if (world->m_PipelineItems.Full())
+                world->m_PipelineItems.OffsetCapacity(dmMath::Max(16U, world->m_PipelineItems.Capacity()));
+            world->m_PipelineItems.Push(item);
+        }
+
+        // The draw descs are always generated, since we don't know which batches will use them
+        SpineBatchJob& job = world->m_PipelineJob;
+        job.m_World = world;
+        job.m_Data = world->m_PipelineData;
+        job.m_Items = &world->m_PipelineItems;
+        job.m_UseDrawDescs = true;
+        BeginParallelFor(world->m_WorkerPool, world->m_PipelineItems.Size(), PARALLEL_VERTEX_CHUNK_SIZE, GenerateBatchJob, &job);
+        world->m_PipelineRunning = 1;
+    }
+
+    static void WaitForPipeline(SpineModelWorld* world)
+    {
+        if (!world->m_PipelineRunning)
+            return;
+        WaitParallelFor(world->m_WorkerPool);
+        world->m_PipelineRunning = 0;
+
+        SpineVertexStats stats = {};
+        for (uint32_t i = 0; i < world->m_WorkerDataCount; ++i)
+        {
+            AddVertexStats(&stats, world->m_PipelineData[i].m_Stats);
+        }
+        ReportVertexStats(stats);
+    }
+
     static void RenderBatch(SpineModelWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
-        //DM_PROFILE(SpineModel, "RenderBatch");
+        DM_PROFILE("RenderBatch");
 
         dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
 
@@ -879,42 +2037,90 @@ namespace dmSpine
         dmGameSystemDDF::SpineModelDesc::BlendMode blend_mode = resource->m_Ddf->m_BlendMode;
         bool use_inherit_blend = blend_mode == dmGameSystemDDF::SpineModelDesc::BLEND_MODE_INHERIT;
 
-        uint32_t vertex_start           = world->m_VertexBufferData.Size();
-        uint32_t vertex_count           = 0;
+        uint32_t index_start            = world->m_IndexBufferData.Size();
         uint32_t draw_desc_buffer_count = 0;
 
         // This is a temporary scratch buffer just used for this batch call, so we make sure to reset it.
         world->m_DrawDescBuffer.SetSize(0);
 
-        for (uint32_t *i = begin; i != end; ++i)
+        if (use_inherit_blend)
         {
-            component_index = (uint32_t)buf[*i].m_UserData;
-            const SpineModelComponent* component = (const SpineModelComponent*) components[component_index];
-            vertex_count += dmSpine::CalcVertexBufferSize(component->m_SkeletonInstance, world->m_SkeletonClipper, 0);
+            for (uint32_t *i = begin; i != end; ++i)
+            {
+                component_index = (uint32_t)buf[*i].m_UserData;
+                const SpineModelComponent* component = (const SpineModelComponent*) components[component_index];
+                draw_desc_buffer_count += dmSpine::CalcDrawDescCount(GetRenderSkeleton(component));
+            }
 
-            if (use_inherit_blend)
+            if (draw_desc_buffer_count > world->m_DrawDescBuffer.Capacity())
             {
-                draw_desc_buffer_count += dmSpine::CalcDrawDescCount(component->m_SkeletonInstance);
+                world->m_DrawDescBuffer.SetCapacity(draw_desc_buffer_count);
             }
         }
 
-        if (draw_desc_buffer_count && draw_desc_buffer_count > world->m_DrawDescBuffer.Capacity())
+        // Reserve space using the (pre clipping) counts from the vertex caches.
+        // The buffers still grow as needed, and keep their capacity between frames
+        uint32_t estimated_vertex_count = 0;
+        uint32_t estimated_index_count  = 0;
+        bool parallel = world->m_WorkerPool && world->m_ParallelVertexGeneration && !world->m_PipelinedVertexGeneration && (uint32_t)(end - begin) > PARALLEL_VERTEX_CHUNK_SIZE;
+        SpineVertexStats stats = {};
+        for (uint32_t *i = begin; i != end; ++i)
         {
-            world->m_DrawDescBuffer.SetCapacity(draw_desc_buffer_count);
-        }
+            component_index = (uint32_t)buf[*i].m_UserData;
+            SpineModelComponent* component = components[component_index];
+            component->m_Visible = 1;
+            estimated_vertex_count += component->m_WorldVertexCache.m_VertexCount;
+            estimated_index_count  += component->m_WorldVertexCache.m_IndexCount;
 
-        if (vertex_count > world->m_VertexBufferData.Capacity())
-        {
-            world->m_VertexBufferData.SetCapacity(vertex_count);
+            // The groups are shared between components, so they're generated up front
+            if (component->m_InstanceGroup)
+                GenerateInstanceGroupVertexData(world, component->m_InstanceGroup, &stats);
+
+            parallel = parallel && CanUpdateInParallel(*component);
         }
 
-        vertex_count = 0;
-        for (uint32_t *i = begin; i != end; ++i)
         {
-            component_index = (uint32_t)buf[*i].m_UserData;
-            const SpineModelComponent* component = (const SpineModelComponent*) components[component_index];
-            vertex_count += dmSpine::GenerateVertexData(world->m_VertexBufferData, component->m_SkeletonInstance, world->m_SkeletonClipper, component->m_World, use_inherit_blend ? &world->m_DrawDescBuffer : 0);
+            DM_PROFILE("GenerateVertices");
+            if (parallel)
+            {
+                world->m_BatchItems.SetSize(0);
+                ReserveArray(world->m_BatchItems, (uint32_t)(end - begin));
+                for (uint32_t *i = begin; i != end; ++i)
+                {
+                    SpineBatchItem item = {};
+                    item.m_Component = components[(uint32_t)buf[*i].m_UserData];
+                    item.m_Skeleton = item.m_Component->m_SkeletonInstance;
+                    item.m_InstanceGroup = item.m_Component->m_InstanceGroup;
+                    world->m_BatchItems.Push(item);
+                }
+                GenerateBatchParallel(world, use_inherit_blend, &stats);
+            }
+            else
+            {
+                if (world->m_CompactVertexFormat)
+                    ReserveArray(world->m_CompactVertexBufferData, estimated_vertex_count);
+                else
+                    ReserveArray(world->m_VertexBufferData, estimated_vertex_count);
+                ReserveArray(world->m_IndexBufferData, estimated_index_count);
+
+                dmArray<SpineDrawDesc>* draw_descs = use_inherit_blend ? &world->m_DrawDescBuffer : 0;
+                for (uint32_t *i = begin; i != end; ++i)
+                {
+                    component_index = (uint32_t)buf[*i].m_UserData;
+                    const SpineModelComponent* component = (const SpineModelComponent*) components[component_index];
+                    const SpineBatchItem* item = GetPipelineItem(world, component);
+                    if (item)
+                    {
+                        AppendPipelineItem(world, *item, draw_descs != 0);
+                        continue;
+                    }
+                    GenerateComponentVertexData(world, component, component->m_SkeletonInstance, component->m_InstanceGroup, world->m_VertexBufferData,
+                                                world->m_CompactVertexBufferData, world->m_IndexBufferData, world->m_SkeletonClipper, &world->m_Scratch, draw_descs, &stats);
+                }
+            }
         }
+        uint32_t index_count = world->m_IndexBufferData.Size() - index_start;
+        ReportVertexStats(stats);
 
         dmGraphics::HTexture texture = resource->m_SpineScene->m_TextureSet->m_Texture->m_Texture; // spine - texture set resource - texture resource - texture
         dmRender::HMaterial material = GetMaterial(first);
@@ -924,20 +2130,24 @@ namespace dmSpine
             uint32_t draw_desc_count = world->m_DrawDescBuffer.Size();
             if (draw_desc_count > 0)
             {
-                dmArray<SpineDrawDesc> scratch_draw_descs;
-                MergeDrawDescs(world->m_DrawDescBuffer, scratch_draw_descs);
+                dmArray<SpineDrawDesc>& scratch_draw_descs = world->m_MergedDrawDescBuffer;
+                {
+                    DM_PROFILE("MergeDrawDescs");
+                    MergeDrawDescs(world->m_DrawDescBuffer, scratch_draw_descs);
+                }
 
                 uint32_t merged_size = scratch_draw_descs.Size();
                 uint32_t ro_count_begin = world->m_RenderObjects.Size();
                 world->m_RenderObjects.SetSize(world->m_RenderObjects.Size() + merged_size);
+                DM_PROPERTY_ADD_U32(rmtp_SpineRenderObjects, merged_size);
 
                 for (int i = 0; i < merged_size; ++i)
                 {
                     dmRender::RenderObject& ro = world->m_RenderObjects[ro_count_begin + i];
                     FillRenderObject(world, render_context, ro, first->m_RenderConstants, texture, material,
                         SpineBlendModeToRenderBlendMode((spBlendMode) scratch_draw_descs[i].m_BlendMode),
-                        scratch_draw_descs[i].m_VertexStart,
-                        scratch_draw_descs[i].m_VertexCount);
+                        scratch_draw_descs[i].m_IndexStart,
+                        scratch_draw_descs[i].m_IndexCount);
                 }
             }
         }
@@ -945,8 +2155,72 @@ namespace dmSpine
         {
             uint32_t ro_index = world->m_RenderObjects.Size();
             world->m_RenderObjects.SetSize(ro_index + 1);
+            DM_PROPERTY_ADD_U32(rmtp_SpineRenderObjects, 1);
             dmRender::RenderObject& ro = world->m_RenderObjects[ro_index];
-            FillRenderObject(world, render_context, ro, first->m_RenderConstants, texture, material, blend_mode, vertex_start, vertex_count);
+            FillRenderObject(world, render_context, ro, first->m_RenderConstants, texture, material, blend_mode, index_start, index_count);
+        }
+    }
+
+    static void UploadBuffers(SpineModelWorld* world)
+    {
+        DM_PROFILE("UploadBuffers");
+        uint32_t vertex_count = 0;
+        uint32_t vertex_size = 0;
+        uint32_t index_count = world->m_IndexBufferData.Size();
+
+        if (world->m_CompactVertexFormat)
+        {
+            vertex_count = world->m_CompactVertexBufferData.Size();
+            vertex_size = sizeof(dmSpine::SpineVertexCompact);
+            dmGraphics::SetVertexBufferData(world->m_VertexBuffer, vertex_size * vertex_count,
+                                            world->m_CompactVertexBufferData.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        }
+        else
+        {
+            vertex_count = world->m_VertexBufferData.Size();
+            vertex_size = sizeof(dmSpine::SpineVertex);
+            dmGraphics::SetVertexBufferData(world->m_VertexBuffer, vertex_size * vertex_count,
+                                            world->m_VertexBufferData.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        }
+
+        // Use 16 bit indices whenever the vertex count allows it
+        bool use_16bit = vertex_count <= 0xFFFF;
+        if (!use_16bit && !world->m_Is32BitIndexSupported)
+        {
+            dmLogOnceError("Spine vertex count %u requires 32 bit indices, which are not supported on this device. Skipping spine model rendering.", vertex_count);
+            uint32_t ro_count = world->m_RenderObjects.Size();
+            for (uint32_t i = 0; i < ro_count; ++i)
+            {
+                world->m_RenderObjects[i].m_VertexCount = 0;
+            }
+            return;
+        }
+
+        uint32_t index_size = sizeof(uint32_t);
+        if (use_16bit)
+        {
+            // Narrow the indices in place. The write position never passes the read position.
+            index_size = sizeof(uint16_t);
+            uint16_t* dst = (uint16_t*)world->m_IndexBufferData.Begin();
+            const uint32_t* src = world->m_IndexBufferData.Begin();
+            for (uint32_t i = 0; i < index_count; ++i)
+            {
+                dst[i] = (uint16_t)src[i];
+            }
+        }
+
+        dmGraphics::SetIndexBufferData(world->m_IndexBuffer, index_size * index_count,
+                                       world->m_IndexBufferData.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        DM_PROPERTY_ADD_U32(rmtp_SpineUploadBytes, vertex_size * vertex_count + index_size * index_count);
+
+        // The render objects are drawn after the END operation, so we can still patch them
+        dmGraphics::Type index_type = use_16bit ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
+        uint32_t ro_count = world->m_RenderObjects.Size();
+        for (uint32_t i = 0; i < ro_count; ++i)
+        {
+            dmRender::RenderObject& ro = world->m_RenderObjects[i];
+            ro.m_IndexType = index_type;
+            ro.m_VertexStart *= index_size; // byte offset
         }
     }
 
@@ -959,6 +2233,7 @@ namespace dmSpine
         dmArray<SpineModelComponent*>& components = world->m_Components.GetRawObjects();
         const dmIntersection::Frustum frustum = *params.m_Frustum;
         uint32_t num_entries = params.m_NumEntries;
+        uint32_t num_culled = 0;
         for (uint32_t i = 0; i < num_entries; ++i)
         {
             dmRender::RenderListEntry* entry = &params.m_Entries[i];
@@ -966,23 +2241,26 @@ namespace dmSpine
 
             SpineModelComponent* component_p = components[component_index];
 
-            const SpineModelBounds& bounds = world->m_BoundingBoxes[component_index];
-
-            // get center of bounding box in local coords
-            float center_x = (bounds.maxX + bounds.minX)/2;
-            float center_y = (bounds.maxY + bounds.minY)/2;
-            dmVMath::Point3 center_local(center_x, center_y, 0);
-            dmVMath::Point3 corner_local(bounds.maxX, bounds.maxY, 0);
-
-            // transform to world coords
-            dmVMath::Vector4 center_world = component_p->m_World * center_local;
-            dmVMath::Vector4 corner_world = component_p->m_World * corner_local;
+            // The cached bounds are already in world space
+            const dmSpine::SpineWorldVertexCache& cache = component_p->m_WorldVertexCache;
+            dmVMath::Vector4 corner_world(cache.m_Max[0], cache.m_Max[1], cache.m_Max[2], 1.0f);
+            dmVMath::Vector4 center_world = (dmVMath::Vector4(cache.m_Min[0], cache.m_Min[1], cache.m_Min[2], 1.0f) + corner_world) * 0.5f;
 
             float radius =  Vectormath::Aos::length(corner_world - center_world);
 
+            if (component_p->m_WorldVertexCacheStale)
+            {
+                // The bounds are from the last pose update. Move them along with the component,
+                // and pad them to account for the animation since then
+                center_world += component_p->m_World.getCol(3) - dmVMath::Vector4(component_p->m_WorldVertexCacheOrigin);
+                radius *= 1.0f + world->m_OffscreenBoundsPadding;
+            }
+
             bool intersect = dmIntersection::TestFrustumSphere(frustum, center_world, radius);
             entry->m_Visibility = intersect ? dmRender::VISIBILITY_FULL : dmRender::VISIBILITY_NONE;
+            num_culled += intersect ? 0 : 1;
         }
+        DM_PROPERTY_ADD_U32(rmtp_SpineCulled, num_culled);
     }
 
 
@@ -994,9 +2272,13 @@ namespace dmSpine
         {
             case dmRender::RENDER_LIST_OPERATION_BEGIN:
             {
+                WaitForPipeline(world);
                 dmGraphics::SetVertexBufferData(world->m_VertexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                dmGraphics::SetIndexBufferData(world->m_IndexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
                 world->m_RenderObjects.SetSize(0);
                 world->m_VertexBufferData.SetSize(0);
+                world->m_CompactVertexBufferData.SetSize(0);
+                world->m_IndexBufferData.SetSize(0);
                 break;
             }
             case dmRender::RENDER_LIST_OPERATION_BATCH:
@@ -1006,8 +2288,7 @@ namespace dmSpine
             }
             case dmRender::RENDER_LIST_OPERATION_END:
             {
-                dmGraphics::SetVertexBufferData(world->m_VertexBuffer, sizeof(dmSpine::SpineVertex) * world->m_VertexBufferData.Size(),
-                                                world->m_VertexBufferData.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                UploadBuffers(world);
                 //DM_COUNTER("SpineVertexBuffer", world->m_VertexBufferData.Size() * sizeof(dmSpine::SpineVertex));
                 break;
             }
@@ -1039,9 +2320,8 @@ namespace dmSpine
             if (!component.m_DoRender || !component.m_Enabled)
                 continue;
 
-            // Update bounding boxes
-            SpineModelBounds& bounds = world->m_BoundingBoxes[i];
-            GetSkeletonBounds(component.m_SkeletonInstance,bounds);
+            // Set again if the component is drawn
+            component.m_Visible = 0;
 
             const Vector4 trans = component.m_World.getCol(3);
             write_ptr->m_WorldPosition = Point3(trans.getX(), trans.getY(), trans.getZ());
@@ -1075,6 +2355,7 @@ namespace dmSpine
 
     bool CompSpineModelPlayAnimation(SpineModelComponent* component, dmGameSystemDDF::SpinePlayAnimation* message, dmMessage::URL* sender, dmScript::LuaCallbackInfo* callback_info, lua_State* L)
     {
+        DetachFromInstanceGroup(component);
         bool result = PlayAnimation(component, message->m_AnimationId, (dmGameObject::Playback)message->m_Playback, message->m_BlendDuration,
                                                 message->m_Offset, message->m_PlaybackRate, message->m_Track - 1);
         if (result)
@@ -1090,6 +2371,7 @@ namespace dmSpine
 
     bool CompSpineModelCancelAnimation(SpineModelComponent* component, dmGameSystemDDF::SpineCancelAnimation* message)
     {
+        DetachFromInstanceGroup(component);
         if (message->m_Track == ALL_TRACKS)
         {
             CancelAllAnimations(component);
@@ -1159,6 +2441,7 @@ namespace dmSpine
         SpineModelWorld* world = (SpineModelWorld*)params.m_World;
         int index = *params.m_UserData;
         SpineModelComponent* component = GetComponentFromIndex(world, index);
+        WaitForPipeline(world);
         component->m_Resource = (SpineModelResource*)params.m_Resource;
         (void)OnResourceReloaded(world, component, index);
     }
@@ -1279,6 +2562,8 @@ namespace dmSpine
                 return dmGameObject::PROPERTY_RESULT_UNSUPPORTED_VALUE;
             }
 
+            DetachFromInstanceGroup(component);
+
             float unit_0_1 = fmodf(params.m_Value.m_Number + 1.0f, 1.0f);
 
             float duration = track->m_AnimationInstance->animationEnd - track->m_AnimationInstance->animationStart;
@@ -1305,6 +2590,7 @@ namespace dmSpine
                 return dmGameObject::PROPERTY_RESULT_UNSUPPORTED_VALUE;
             }
 
+            DetachFromInstanceGroup(component);
             track->m_AnimationInstance->timeScale = params.m_Value.m_Number;
             return dmGameObject::PROPERTY_RESULT_OK;
         }
@@ -1341,6 +2627,24 @@ namespace dmSpine
 
         int32_t max_rig_instance = dmConfigFile::GetInt(ctx->m_Config, "rig.max_instance_count", 128);
         spinemodelctx->m_MaxSpineModelCount = dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.max_count", 128), max_rig_instance);
+        spinemodelctx->m_CompactVertexFormat = dmConfigFile::GetInt(ctx->m_Config, "spine.compact_vertex_format", 0) != 0;
+        spinemodelctx->m_OffscreenUpdateInterval = (uint32_t)dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.offscreen_update_interval", 4), 1);
+        spinemodelctx->m_OffscreenBoundsPadding = dmMath::Max(dmConfigFile::GetFloat(ctx->m_Config, "spine.offscreen_bounds_padding", 0.5f), 0.0f);
+        spinemodelctx->m_InstancedPlayback = dmConfigFile::GetInt(ctx->m_Config, "spine.instanced_playback", 0) != 0;
+        spinemodelctx->m_InstanceTimeStep = dmMath::Max(dmConfigFile::GetFloat(ctx->m_Config, "spine.instance_time_step", 1.0f / 60.0f), 0.0f);
+        spinemodelctx->m_WorkerPool = NewWorkerPool((uint32_t)dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.worker_threads", 0), 0));
+        spinemodelctx->m_ParallelUpdate = dmConfigFile::GetInt(ctx->m_Config, "spine.parallel_update", 1) != 0;
+        spinemodelctx->m_ParallelVertexGeneration = dmConfigFile::GetInt(ctx->m_Config, "spine.parallel_vertex_generation", 1) != 0;
+        spinemodelctx->m_PipelinedVertexGeneration = dmConfigFile::GetInt(ctx->m_Config, "spine.pipelined_vertex_generation", 0) != 0;
+
+        // The spine scenes are loaded after the component types are created, and read the settings from their type context
+        HResourceType scene_type;
+        if (dmResource::GetTypeFromExtension(ctx->m_Factory, "spinescenec", &scene_type) == dmResource::RESULT_OK)
+        {
+            SpineSceneContext* scene_context = (SpineSceneContext*)ResourceTypeGetContext(scene_type);
+            scene_context->m_InstancePoolSize = (uint32_t)dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.instance_pool_size", 0), 0);
+            scene_context->m_InstancePoolPrewarm = (uint32_t)dmMath::Max(dmConfigFile::GetInt(ctx->m_Config, "spine.instance_pool_prewarm", 0), 0);
+        }
 
         // Spine system setup
         spBone_setYDown(0); // so we'll only call it once
@@ -1380,6 +2684,7 @@ namespace dmSpine
     static dmGameObject::Result CompTypeSpineModelDestroy(const dmGameObject::ComponentTypeCreateCtx* ctx, dmGameObject::ComponentType* type)
     {
         SpineModelContext* spinemodelctx = (SpineModelContext*)ComponentTypeGetContext(type);
+        DeleteWorkerPool(spinemodelctx->m_WorkerPool);
         delete spinemodelctx;
         return dmGameObject::RESULT_OK;
     }
@@ -1411,6 +2716,8 @@ namespace dmSpine
         if (*index > component->m_SkeletonInstance->ikConstraintsCount)
             return false;
 
+        DetachFromInstanceGroup(component);
+
         if (component->m_IKTargets.Full())
             component->m_IKTargets.OffsetCapacity(2);
 
@@ -1437,6 +2744,8 @@ namespace dmSpine
         if (*index > component->m_SkeletonInstance->ikConstraintsCount)
             return false;
 
+        DetachFromInstanceGroup(component);
+
         if (component->m_IKTargetPositions.Full())
             component->m_IKTargetPositions.OffsetCapacity(2);
 
@@ -1485,6 +2794,7 @@ namespace dmSpine
             skin = spine_scene->m_Skeleton->skins[*index];
         }
 
+        DetachFromInstanceGroup(component);
         spSkeleton_setSkin(component->m_SkeletonInstance, skin);
         spSkeleton_setSlotsToSetupPose(component->m_SkeletonInstance);
 
@@ -1522,6 +2832,7 @@ namespace dmSpine
             }
         }
 
+        DetachFromInstanceGroup(component);
         spSkeleton_setSkin(component->m_SkeletonInstance, skin);
         spSkeleton_setSlotsToSetupPose(component->m_SkeletonInstance);
 
@@ -1554,6 +2865,7 @@ namespace dmSpine
             attachment_name = *p_attachment_name;
         }
 
+        DetachFromInstanceGroup(component);
         spSlot* slot = component->m_SkeletonInstance->slots[*index];
 
         // it's a bit weird to use strings here, but we'd rather not use too much knowledge about the internals
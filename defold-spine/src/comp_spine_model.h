@@ -27,8 +27,10 @@
 #include <gamesys/gamesys_ddf.h>
 
 #include "res_spine_model.h"
+#include <common/vertices.h>
 
 struct spAnimationState;
+struct spArena;
 struct spBone;
 struct spSkeleton;
 struct spTrackEntry;
@@ -39,6 +41,9 @@ namespace dmSpine
 {
     const int32_t ALL_TRACKS = -1;
 
+    struct SpineInstanceGroup;
+    struct SpineWorkerData;
+
     struct SpineAnimationTrack {
         spTrackEntry*                           m_AnimationInstance;
         dmhash_t                                m_AnimationId;
@@ -66,22 +71,33 @@ namespace dmSpine
         SpineModelResource*                     m_Resource;
         spSkeleton*                             m_SkeletonInstance;
         spAnimationState*                       m_AnimationStateInstance;
+        spArena*                                m_Arena;                        // Holds the skeleton and animation state instances (see SpineInstancePool)
         dmArray<dmSpine::SpineAnimationTrack>   m_AnimationTracks;
         dmGameSystem::HComponentRenderConstants m_RenderConstants;
         dmGameSystem::MaterialResource*         m_Material;
         /// Node instances corresponding to the bones
-        dmArray<dmGameObject::HInstance>        m_BoneInstances;
-        dmArray<spBone*>                        m_Bones;                        // We shouldn't really have to have a duplicate array of these
+        dmArray<dmGameObject::HInstance>        m_BoneInstances;                // Indexed like the skeleton bones
         dmHashTable64<uint32_t>                 m_BoneNameToNodeInstanceIndex;  // should really be in the spine_scene
 
         dmArray<dmSpine::IKTarget>              m_IKTargets;
         dmArray<dmSpine::IKTarget>              m_IKTargetPositions;
+        SpineInstanceGroup*                     m_InstanceGroup;                // Set while sharing the animation with other components (instanced playback)
+        SpineWorkerData*                        m_WorkerData;                   // Set while updated on a worker thread, which defers the events (parallel update)
+        spSkeleton*                             m_PipelineSkeleton;             // A snapshot of the pose, read by the pipelined vertex generation
+        uint32_t                                m_PipelineItem;                 // The pipelined vertices of this frame, if any
+        dmSpine::SpineWorldVertexCache          m_WorldVertexCache;             // Updated after each skeleton update
+        dmVMath::Point3                         m_WorldVertexCacheOrigin;       // Component position when the cache was updated
+        float                                   m_PendingDt;                    // Time not yet applied to the animation state (offscreen updates)
         uint32_t                                m_MixedHash;
         uint16_t                                m_ComponentIndex;
+        uint16_t                                m_OffscreenFrames;              // Skipped frames (offscreen updates)
         uint8_t                                 m_Enabled : 1;
         uint8_t                                 m_DoRender : 1;
         uint8_t                                 m_AddedToUpdate : 1;
         uint8_t                                 m_ReHash : 1;
+        uint8_t                                 m_Visible : 1;                  // Drawn in the last frame
+        uint8_t                                 m_WorldVertexCacheStale : 1;    // The skeleton pose wasn't updated this frame
+        uint8_t                                 m_PoseStale : 1;                // Only the events were applied to the skeleton (offscreen updates)
     };
 
     // For scripting
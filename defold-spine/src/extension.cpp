@@ -1,9 +1,28 @@
-
 #include <dmsdk/sdk.h>
+#include <dmsdk/dlib/profile.h>
 #include "script_spine.h"
+#include <common/spine_alloc.h>
+#include <common/spine_layout.h>
+
+DM_PROPERTY_EXTERN(rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineAllocations, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine runtime allocations", &rmtp_Spine);
+DM_PROPERTY_U32(rmtp_SpineFrees, 0, PROFILE_PROPERTY_FRAME_RESET, "# spine runtime frees", &rmtp_Spine);
+
+static uint32_t g_LastAllocationCount = 0;
+static uint32_t g_LastFreeCount = 0;
 
 static dmExtension::Result AppInitializeSpine(dmExtension::AppParams* params)
 {
+    // The spine structs are shared with the prebuilt runtime library, which must be built from the same sources
+    uint32_t layout_hash = dmSpine::CalcSpineLayoutHash();
+    uint32_t lib_layout_hash = dmSpine::GetSpineLayoutHash();
+    if (layout_hash != lib_layout_hash)
+    {
+        dmLogError("The spine runtime library has another struct layout (%08x) than the extension (%08x). Rebuild it with utils/build_libs.sh", lib_layout_hash, layout_hash);
+        return dmExtension::RESULT_INIT_ERROR;
+    }
+
+    dmSpine::InstallAllocationCounter();
     return dmExtension::RESULT_OK;
 }
 
@@ -14,8 +33,21 @@ static dmExtension::Result InitializeSpine(dmExtension::Params* params)
     return dmExtension::RESULT_OK;
 }
 
+static dmExtension::Result UpdateSpine(dmExtension::Params* params)
+{
+    // Report the allocations made since the last frame
+    uint32_t allocation_count = dmSpine::GetAllocationCount();
+    uint32_t free_count = dmSpine::GetFreeCount();
+    DM_PROPERTY_ADD_U32(rmtp_SpineAllocations, allocation_count - g_LastAllocationCount);
+    DM_PROPERTY_ADD_U32(rmtp_SpineFrees, free_count - g_LastFreeCount);
+    g_LastAllocationCount = allocation_count;
+    g_LastFreeCount = free_count;
+    return dmExtension::RESULT_OK;
+}
+
 static dmExtension::Result AppFinalizeSpine(dmExtension::AppParams* params)
 {
+    dmSpine::UninstallAllocationCounter();
     return dmExtension::RESULT_OK;
 }
 
@@ -26,4 +58,4 @@ static dmExtension::Result FinalizeSpine(dmExtension::Params* params)
 
 
 // DM_DECLARE_EXTENSION(symbol, name, app_init, app_final, init, update, on_event, final)
-DM_DECLARE_EXTENSION(SpineExt, "SpineExt", AppInitializeSpine, AppFinalizeSpine, InitializeSpine, 0, 0, FinalizeSpine);
+DM_DECLARE_EXTENSION(SpineExt, "SpineExt", AppInitializeSpine, AppFinalizeSpine, InitializeSpine, UpdateSpine, 0, FinalizeSpine);
@@ -25,6 +25,9 @@
 
 DM_PROPERTY_EXTERN(rmtp_Spine);
 DM_PROPERTY_EXTERN(rmtp_SpineBones);
+DM_PROPERTY_EXTERN(rmtp_SpineClipPasses);
+DM_PROPERTY_EXTERN(rmtp_SpineClippedTriangles);
+DM_PROPERTY_EXTERN(rmtp_SpineVertices);
 DM_PROPERTY_U32(rmtp_SpineGuiNodes, 0, PROFILE_PROPERTY_FRAME_RESET, "", &rmtp_Spine);
 
 namespace dmSpine
@@ -37,7 +40,8 @@ static const dmhash_t SPINE_SCENE_SUFFIX        = dmHashString64(".spinescenec")
 
 struct GuiNodeTypeContext
 {
-    spSkeletonClipping* m_SkeletonClipper;
+    spSkeletonClipping*     m_SkeletonClipper;
+    dmSpine::SpineScratch   m_Scratch;
 };
 
 struct InternalGuiNode
@@ -870,8 +874,12 @@ static void GuiGetVertices(const dmGameSystem::CustomNodeCtx* nodectx, uint32_t
     // We currently know it's xyz-uv-rgba
     dmArray<dmSpine::SpineVertex>* vbdata = (dmArray<dmSpine::SpineVertex>*)&vertices;
 
-    uint32_t num_vertices = dmSpine::GenerateVertexData(*vbdata, node->m_SkeletonInstance, type_context->m_SkeletonClipper, node->m_Transform, 0);
+    dmSpine::SpineVertexStats stats = {};
+    uint32_t num_vertices = dmSpine::GenerateVertexData(*vbdata, node->m_SkeletonInstance, type_context->m_SkeletonClipper, &type_context->m_Scratch, node->m_Transform, 0, &stats);
     (void)num_vertices;
+    DM_PROPERTY_ADD_U32(rmtp_SpineClipPasses, stats.m_ClipPasses);
+    DM_PROPERTY_ADD_U32(rmtp_SpineClippedTriangles, stats.m_ClippedTriangles);
+    DM_PROPERTY_ADD_U32(rmtp_SpineVertices, stats.m_Vertices);
 }
 
 static void GuiUpdate(const dmGameSystem::CustomNodeCtx* nodectx, float dt)
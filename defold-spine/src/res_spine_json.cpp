@@ -9,44 +9,70 @@
     #include <malloc.h>
 #endif
 
+#include <common/skeleton_blob.h>
+#include <common/spine_loader.h>
+
+#include <spine/SkeletonData.h>
+
 #include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/profile.h>
 #include <dmsdk/resource/resource.h>
 
 namespace dmSpine
 {
-    static SpineJsonResource* CreateResource(const void* buffer, uint32_t buffer_size)
+    // The atlas regions are bound later, when a spine scene loads the skeleton with its atlas
+    static SpineJsonResource* CreateResource(const char* path, const void* buffer, uint32_t buffer_size)
     {
-        SpineJsonResource* resource = new SpineJsonResource;
-        resource->m_Json = (char*)malloc(buffer_size + 1);
-        if (!resource->m_Json)
+        DM_PROFILE("SpineParseSkeleton");
+
+        // Parsed directly from the resource buffer
+        spDefoldAtlasAttachmentLoader* loader = dmSpine::CreateAttachmentLoader();
+        spSkeletonData* skeleton_data = dmSpine::ReadSkeletonData((spAttachmentLoader*)loader, path, buffer, buffer_size);
+
+        uint32_t blob_size = 0;
+        void* blob = 0;
+        if (skeleton_data)
         {
-            delete resource;
-            return 0;
+            blob = dmSpine::WriteSkeletonBlob(skeleton_data, &blob_size);
+            spSkeletonData_dispose(skeleton_data);
         }
+        dmSpine::Dispose(loader);
 
-        memcpy((void*)resource->m_Json, buffer, buffer_size);
-        resource->m_Json[buffer_size] = 0;
-        resource->m_Length = buffer_size;
+        if (!blob)
+        {
+            return 0;
+        }
 
+        SpineJsonResource* resource = new SpineJsonResource;
+        resource->m_SkeletonBlob = blob;
+        resource->m_SkeletonBlobSize = blob_size;
         return resource;
     }
 
     static void DestroyResource(SpineJsonResource* resource)
     {
-        free((void*)resource->m_Json);
+        free(resource->m_SkeletonBlob);
         delete resource;
     }
 
-    static dmResource::Result ResourceTypeJson_Create(const dmResource::ResourceCreateParams* params)
+    // Runs on the preload thread, so that the main thread doesn't need to parse the file
+    static dmResource::Result ResourceTypeJson_Preload(const dmResource::ResourcePreloadParams* params)
     {
-        SpineJsonResource* resource = CreateResource(params->m_Buffer, params->m_BufferSize);
+        SpineJsonResource* resource = CreateResource(params->m_Filename, params->m_Buffer, params->m_BufferSize);
         if (!resource)
         {
-            return dmResource::RESULT_OUT_OF_RESOURCES;
+            return dmResource::RESULT_INVALID_DATA;
         }
 
+        *params->m_PreloadData = resource;
+        return dmResource::RESULT_OK;
+    }
+
+    static dmResource::Result ResourceTypeJson_Create(const dmResource::ResourceCreateParams* params)
+    {
+        SpineJsonResource* resource = (SpineJsonResource*)params->m_PreloadData;
         dmResource::SetResource(params->m_Resource, resource);
-        dmResource::SetResourceSize(params->m_Resource, resource->m_Length);
+        dmResource::SetResourceSize(params->m_Resource, resource->m_SkeletonBlobSize);
         return dmResource::RESULT_OK;
     }
 
@@ -59,24 +85,24 @@ namespace dmSpine
 
     static dmResource::Result ResourceTypeJson_Recreate(const dmResource::ResourceRecreateParams* params)
     {
-        SpineJsonResource* new_resource = CreateResource(params->m_Buffer, params->m_BufferSize);
+        SpineJsonResource* new_resource = CreateResource(params->m_Filename, params->m_Buffer, params->m_BufferSize);
         if (!new_resource)
         {
-            return dmResource::RESULT_OUT_OF_RESOURCES;
+            return dmResource::RESULT_INVALID_DATA;
         }
 
         SpineJsonResource* old_resource = (SpineJsonResource*) dmResource::GetResource(params->m_Resource);
 
         // swap the internals
         // we wish to keep the "old" resource, since that pointer might be shared in the system
-        char* tmp = old_resource->m_Json;
-        old_resource->m_Json = new_resource->m_Json;
-        old_resource->m_Length = new_resource->m_Length;
+        void* tmp = old_resource->m_SkeletonBlob;
+        old_resource->m_SkeletonBlob = new_resource->m_SkeletonBlob;
+        old_resource->m_SkeletonBlobSize = new_resource->m_SkeletonBlobSize;
 
-        new_resource->m_Json = tmp;
+        new_resource->m_SkeletonBlob = tmp;
         DestroyResource(new_resource);
 
-        dmResource::SetResourceSize(params->m_Resource, old_resource->m_Length);
+        dmResource::SetResourceSize(params->m_Resource, old_resource->m_SkeletonBlobSize);
         return dmResource::RESULT_OK;
     }
 
@@ -85,7 +111,7 @@ namespace dmSpine
         return (ResourceResult)dmResource::SetupType(ctx,
                                                        type,
                                                        0, // context
-                                                       0, // preload
+                                                       ResourceTypeJson_Preload,
                                                        ResourceTypeJson_Create,
                                                        0, // post create
                                                        ResourceTypeJson_Destroy,
@@ -95,3 +121,4 @@ namespace dmSpine
 }
 
 DM_DECLARE_RESOURCE_TYPE(ResourceTypeSpineJsonExt, "spinejsonc", dmSpine::ResourceTypeJson_Register, 0);
+DM_DECLARE_RESOURCE_TYPE(ResourceTypeSpineBinaryExt, "skelc", dmSpine::ResourceTypeJson_Register, 0);
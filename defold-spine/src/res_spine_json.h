@@ -5,10 +5,13 @@
 
 namespace dmSpine
 {
+    // Also used for the binary exports (.skelc), see dmSpine::ReadSkeletonData
+    // The file is parsed on the resource preload thread, and kept as a precompiled skeleton (see skeleton_blob.h)
+    // without any atlas regions. Each spine scene loads its own copy with its atlas.
     struct SpineJsonResource
     {
-        char*       m_Json;
-        uint32_t    m_Length;
+        void*       m_SkeletonBlob;
+        uint32_t    m_SkeletonBlobSize;
     };
 }
 
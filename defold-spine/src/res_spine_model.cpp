@@ -1,4 +1,5 @@
 #include "res_spine_model.h"
+#include "res_spine_scene.h"
 
 #include <dmsdk/dlib/log.h>
 #include <dmsdk/resource/resource.h>
@@ -26,6 +27,10 @@ namespace dmSpine
 
         resource->m_CreateGoBones = resource->m_Ddf->m_CreateGoBones!=0;
 
+        // Baked while loading, rather than the first time an animation is played
+        if (resource->m_Ddf->m_Baked)
+            dmSpine::BakeAnimations(resource->m_SpineScene);
+
         return dmResource::RESULT_OK;
     }
 
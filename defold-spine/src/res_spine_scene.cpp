@@ -1,17 +1,25 @@
 #include "res_spine_scene.h"
 #include "res_spine_json.h"
+#include "baked_animation.h"
 #include "spine_ddf.h" // generated from the spine_ddf.proto
 
+#include <common/skeleton_blob.h>
 #include <common/spine_loader.h>
 
 #include <dmsdk/dlib/log.h>
 #include <dmsdk/dlib/math.h>
+#include <dmsdk/dlib/profile.h>
 #include <dmsdk/resource/resource.h>
 
 #include <spine/SkeletonJson.h>
 #include <spine/AnimationStateData.h>
+#include <spine/MeshAttachment.h>
+#include <spine/RegionAttachment.h>
 #include <dmsdk/gamesys/resources/res_textureset.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 // Also see the guide http://esotericsoftware.com/spine-c#Loading-skeleton-data
 
 #if 0
@@ -23,16 +31,22 @@
 namespace dmSpine
 {
 
-    static dmResource::Result AcquireResources(dmResource::HFactory factory, SpineSceneResource* resource, const char* filename)
+    static bool HasSequence(const spAttachment* attachment)
     {
-        dmResource::Result result = dmResource::Get(factory, resource->m_Ddf->m_Atlas, (void**) &resource->m_TextureSet); // .atlas -> .texturesetc
-        if (result != dmResource::RESULT_OK)
+        switch (attachment->type)
         {
-            return result;
+            case SP_ATTACHMENT_REGION:
+                return ((const spRegionAttachment*)attachment)->sequence != 0;
+            case SP_ATTACHMENT_MESH:
+                return ((const spMeshAttachment*)attachment)->sequence != 0;
+            default:
+                return false;
         }
+    }
 
-        SpineJsonResource* spine_json_resource = 0;
-        result = dmResource::Get(factory, resource->m_Ddf->m_SpineJson, (void**) &spine_json_resource);
+    static dmResource::Result AcquireResources(dmResource::HFactory factory, SpineSceneResource* resource, const char* filename)
+    {
+        dmResource::Result result = dmResource::Get(factory, resource->m_Ddf->m_Atlas, (void**) &resource->m_TextureSet); // .atlas -> .texturesetc
         if (result != dmResource::RESULT_OK)
         {
             return result;
@@ -42,8 +56,40 @@ namespace dmSpine
         resource->m_Regions = dmSpine::CreateRegions(resource->m_TextureSet->m_TextureSet);
         resource->m_AttachmentLoader = dmSpine::CreateAttachmentLoader(resource->m_TextureSet->m_TextureSet, resource->m_Regions);
 
-        // Create the spine resource
-        resource->m_Skeleton = dmSpine::ReadSkeletonJsonData((spAttachmentLoader*)resource->m_AttachmentLoader, filename, spine_json_resource->m_Json);
+        // The skeleton is created from the blob, and the atlas regions are bound to it
+        // If it was precompiled by bob, the blob is in the ddf message
+        const void* blob = resource->m_Ddf->m_SkeletonData.m_Data;
+        uint32_t blob_size = resource->m_Ddf->m_SkeletonData.m_Count;
+        SpineJsonResource* spine_json_resource = 0;
+        if (!dmSpine::IsSkeletonBlobCompatible(blob, blob_size))
+        {
+            // The json is bundled next to the precompiled skeleton, in case bob ran with another version of the extension
+            if (blob_size)
+            {
+                dmLogWarning("The precompiled skeleton of '%s' was built with another version. Loading '%s' instead", filename, resource->m_Ddf->m_SpineJson);
+            }
+
+            // Parsed on the preload thread (see res_spine_json.cpp)
+            result = dmResource::Get(factory, resource->m_Ddf->m_SpineJson, (void**) &spine_json_resource);
+            if (result != dmResource::RESULT_OK)
+            {
+                return result;
+            }
+
+            // The resource may be shared with scenes that use other atlases
+            blob = spine_json_resource->m_SkeletonBlob;
+            blob_size = spine_json_resource->m_SkeletonBlobSize;
+        }
+
+        {
+            DM_PROFILE("SpineLoadSkeleton");
+            resource->m_Skeleton = dmSpine::LoadSkeletonBlob(resource->m_AttachmentLoader, filename, blob, blob_size);
+        }
+
+        // We can release this json data now
+        if (spine_json_resource)
+            dmResource::Release(factory, spine_json_resource);
+
         if (!resource->m_Skeleton)
         {
             return dmResource::RESULT_INVALID_DATA;
@@ -53,9 +99,6 @@ namespace dmSpine
         //spAnimationStateData_setDefaultMix(resource->m_AnimationStateData, 0.1f); // There's currently no such function!
         resource->m_AnimationStateData->defaultMix = 0.1f; // force mixing
 
-        // We can release this json data now
-        dmResource::Release(factory, spine_json_resource);
-
         {
             uint32_t count = resource->m_Skeleton->animationsCount;
             resource->m_AnimationNameToIndex.SetCapacity(dmMath::Max(1U, count/3), count);
@@ -71,6 +114,7 @@ namespace dmSpine
             uint32_t count = resource->m_Skeleton->skinsCount;
             resource->m_SkinNameToIndex.SetCapacity(dmMath::Max(1U, count/3), count);
             resource->m_AttachmentHashToName.SetCapacity(17,32);
+            resource->m_HasSequences = 0;
             for (int n = 0; n < count; ++n)
             {
                 spSkin* skin = resource->m_Skeleton->skins[n];
@@ -88,6 +132,8 @@ namespace dmSpine
                         resource->m_AttachmentHashToName.SetCapacity(capacity/2+1, capacity);
                     }
                     resource->m_AttachmentHashToName.Put(dmHashString64(entry->name), entry->name);
+                    if (HasSequence(entry->attachment))
+                        resource->m_HasSequences = 1;
                     entry = entry->next;
                 }
             }
@@ -115,23 +161,58 @@ namespace dmSpine
             }
         }
 
+        dmSpine::PrewarmInstancePool(&resource->m_InstancePool, resource->m_Skeleton, resource->m_AnimationStateData);
+
+        // Reloaded, and the baked models still use it
+        if (resource->m_BakeAnimations)
+            BakeAnimations(resource);
+
         return dmResource::RESULT_OK;
     }
 
+    void BakeAnimations(SpineSceneResource* resource)
+    {
+        resource->m_BakeAnimations = 1;
+
+        float sample_rate = resource->m_Ddf->m_SampleRate;
+        if (sample_rate <= 0.0f || !resource->m_BakedAnimations.Empty())
+            return;
+
+        DM_PROFILE("SpineBakeAnimations");
+        uint32_t count = resource->m_Skeleton->animationsCount;
+        resource->m_BakedAnimations.SetCapacity(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            resource->m_BakedAnimations.Push(dmSpine::BakeAnimation(resource->m_Skeleton, resource->m_Skeleton->animations[i], sample_rate));
+        }
+    }
+
     static void ReleaseResources(dmResource::HFactory factory, SpineSceneResource* resource)
     {
-        if (resource->m_Ddf)
-            dmDDF::FreeMessage(resource->m_Ddf);
+        // The pooled instances were created from the skeleton data
+        dmSpine::FlushInstancePool(&resource->m_InstancePool);
+
         if (resource->m_TextureSet)
             dmResource::Release(factory, resource->m_TextureSet);
 
+        for (uint32_t i = 0; i < resource->m_BakedAnimations.Size(); ++i)
+        {
+            if (resource->m_BakedAnimations[i])
+                dmSpine::DestroyBakedAnimation(resource->m_BakedAnimations[i]);
+        }
+        resource->m_BakedAnimations.SetSize(0);
+
         if (resource->m_AnimationStateData)
             spAnimationStateData_dispose(resource->m_AnimationStateData);
         if (resource->m_Skeleton)
-            spSkeletonData_dispose(resource->m_Skeleton);
+            dmSpine::DisposeSkeletonBlob(resource->m_Skeleton);
+        resource->m_Skeleton = 0;
         if (resource->m_AttachmentLoader)
             dmSpine::Dispose(resource->m_AttachmentLoader);
         delete[] resource->m_Regions;
+
+        if (resource->m_Ddf)
+            dmDDF::FreeMessage(resource->m_Ddf);
     }
 
     static dmResource::Result ResourceTypeScene_Preload(const dmResource::ResourcePreloadParams* params)
@@ -143,7 +224,8 @@ namespace dmSpine
             return dmResource::RESULT_DDF_ERROR;
         }
 
-        dmResource::PreloadHint(params->m_HintInfo, ddf->m_SpineJson);
+        if (!dmSpine::IsSkeletonBlobCompatible(ddf->m_SkeletonData.m_Data, ddf->m_SkeletonData.m_Count))
+            dmResource::PreloadHint(params->m_HintInfo, ddf->m_SpineJson);
         dmResource::PreloadHint(params->m_HintInfo, ddf->m_Atlas);
 
         *params->m_PreloadData = ddf;
@@ -152,8 +234,10 @@ namespace dmSpine
 
     static dmResource::Result ResourceTypeScene_Create(const dmResource::ResourceCreateParams* params)
     {
+        SpineSceneContext* context = (SpineSceneContext*)params->m_Context;
         SpineSceneResource* scene_resource = new SpineSceneResource();
         scene_resource->m_Ddf = (dmGameSystemDDF::SpineSceneDesc*) params->m_PreloadData;
+        dmSpine::SetInstancePoolSize(&scene_resource->m_InstancePool, context->m_InstancePoolSize, context->m_InstancePoolPrewarm);
         dmResource::Result r = AcquireResources(params->m_Factory, scene_resource, params->m_Filename);
         if (r == dmResource::RESULT_OK)
         {
@@ -171,6 +255,7 @@ namespace dmSpine
     {
         SpineSceneResource* scene_resource = (SpineSceneResource*)dmResource::GetResource(params->m_Resource);
         ReleaseResources(params->m_Factory, scene_resource);
+        DestroyInstancePool(&scene_resource->m_InstancePool);
         delete scene_resource;
         return dmResource::RESULT_OK;
     }
@@ -191,9 +276,11 @@ namespace dmSpine
 
     static ResourceResult ResourceTypeScene_Register(HResourceTypeContext ctx, HResourceType type)
     {
+        // The settings are 0 (no instance pooling) until the spine model component type sets them
+        SpineSceneContext* context = new SpineSceneContext();
         return (ResourceResult)dmResource::SetupType(ctx,
                                                    type,
-                                                   0, // context
+                                                   context,
                                                    ResourceTypeScene_Preload,
                                                    ResourceTypeScene_Create,
                                                    0, // post create
@@ -201,6 +288,12 @@ namespace dmSpine
                                                    ResourceTypeScene_Recreate);
 
     }
+
+    static ResourceResult ResourceTypeScene_Deregister(HResourceTypeContext ctx, HResourceType type)
+    {
+        delete (SpineSceneContext*)ResourceTypeGetContext(type);
+        return RESOURCE_RESULT_OK;
+    }
 }
 
-DM_DECLARE_RESOURCE_TYPE(ResourceTypeSpineSceneExt, "spinescenec", dmSpine::ResourceTypeScene_Register, 0);
+DM_DECLARE_RESOURCE_TYPE(ResourceTypeSpineSceneExt, "spinescenec", dmSpine::ResourceTypeScene_Register, dmSpine::ResourceTypeScene_Deregister);
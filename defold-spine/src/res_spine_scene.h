@@ -1,7 +1,9 @@
 #ifndef DM_RES_SPINE_SCENE_H
 #define DM_RES_SPINE_SCENE_H
 
+#include <dmsdk/dlib/array.h>
 #include <dmsdk/dlib/hashtable.h>
+#include <common/instance_pool.h>
 
 struct spAtlasRegion;
 struct spSkeletonData;
@@ -20,13 +22,22 @@ namespace dmGameSystem
 namespace dmSpine
 {
     struct spDefoldAtlasAttachmentLoader;
+    struct BakedAnimation;
+
+    // The resource type context of the spine scenes. The settings are read by the spine model component type,
+    // which is created before any spine scene is loaded.
+    struct SpineSceneContext
+    {
+        uint32_t                            m_InstancePoolSize;     // spine.instance_pool_size
+        uint32_t                            m_InstancePoolPrewarm;  // spine.instance_pool_prewarm
+    };
 
     struct SpineSceneResource
     {
         dmGameSystemDDF::SpineSceneDesc*    m_Ddf;
         dmGameSystem::TextureSetResource*   m_TextureSet;   // The atlas
         spAtlasRegion*                      m_Regions;      // Maps 1:1 with the atlas animations array
-        spSkeletonData*                     m_Skeleton;     // the .spinejson file
+        spSkeletonData*                     m_Skeleton;     // the .spinejson file, loaded from a precompiled skeleton (see skeleton_blob.h)
         spAnimationStateData*               m_AnimationStateData;
         spDefoldAtlasAttachmentLoader*      m_AttachmentLoader;
         dmHashTable64<uint32_t>             m_AnimationNameToIndex;
@@ -34,7 +45,15 @@ namespace dmSpine
         dmHashTable64<uint32_t>             m_SlotNameToIndex;
         dmHashTable64<uint32_t>             m_IKNameToIndex;
         dmHashTable64<const char*>          m_AttachmentHashToName; // makes it easy for us to do a reverse hash for attachments
+        dmArray<BakedAnimation*>            m_BakedAnimations;      // Indexed like the skeleton animations. Empty until a baked model uses the scene (see BakeAnimations)
+        SpineInstancePool                   m_InstancePool;         // For the spine model instances of the scene
+        uint8_t                             m_HasSequences : 1;     // Sequence attachments are updated in place, so the skeletons can't be updated in parallel
+        uint8_t                             m_BakeAnimations : 1;   // A baked model uses the scene, so the animations are baked again when it's reloaded
     };
+
+    // Bakes all the animations of the scene at its sample rate, unless they are already baked.
+    // Called when a baked spine model is loaded, so that playing an animation doesn't bake it.
+    void BakeAnimations(SpineSceneResource* resource);
 }
 
 #endif // DM_RES_SPINE_SCENE_H
@@ -0,0 +1,225 @@
+#include "worker_pool.h"
+
+#include <assert.h>
+#include <dmsdk/dlib/array.h>
+#include <dmsdk/dlib/atomic.h>
+#include <dmsdk/dlib/condition_variable.h>
+#include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/math.h>
+#include <dmsdk/dlib/mutex.h>
+#include <dmsdk/dlib/thread.h>
+
+#include <spine/extension.h>
+
+#if defined(__EMSCRIPTEN__)
+    #define SPINE_NO_THREADS
+#endif
+
+namespace dmSpine
+{
+    struct WorkerPool;
+
+    struct WorkerThread
+    {
+        WorkerPool*         m_Pool;
+        dmThread::Thread    m_Thread;
+        uint32_t            m_Index;
+    };
+
+    struct WorkerPool
+    {
+        dmArray<WorkerThread>                   m_Threads;
+        dmMutex::HMutex                         m_Mutex;
+        dmConditionVariable::HConditionVariable m_WorkCondition;
+        dmConditionVariable::HConditionVariable m_DoneCondition;
+
+        // The current job
+        WorkerFn                                m_Fn;
+        void*                                   m_Context;
+        uint32_t                                m_Count;
+        uint32_t                                m_ChunkSize;
+        uint32_t                                m_ChunkCount;
+        int32_atomic_t                          m_NextChunk;
+
+        uint32_t                                m_Generation;       // Incremented for each job
+        uint32_t                                m_BusyWorkers;      // Workers that haven't finished the current job
+        uint8_t                                 m_Quit : 1;
+    };
+
+    static void RunChunks(WorkerPool* pool, uint32_t thread_index)
+    {
+        // The spine allocations would otherwise go to an arena on some threads, and to the heap on others
+        assert(_spGetArena() == 0);
+        while (true)
+        {
+            uint32_t chunk = (uint32_t)dmAtomicAdd32(&pool->m_NextChunk, 1);
+            if (chunk >= pool->m_ChunkCount)
+                break;
+            uint32_t begin = chunk * pool->m_ChunkSize;
+            uint32_t end = dmMath::Min(begin + pool->m_ChunkSize, pool->m_Count);
+            pool->m_Fn(pool->m_Context, thread_index, begin, end);
+        }
+    }
+
+    static void WorkerThreadMain(void* arg)
+    {
+        WorkerThread* thread = (WorkerThread*)arg;
+        WorkerPool* pool = thread->m_Pool;
+        uint32_t generation = 0;
+        while (true)
+        {
+            dmMutex::Lock(pool->m_Mutex);
+            while (!pool->m_Quit && pool->m_Generation == generation)
+            {
+                dmConditionVariable::Wait(pool->m_WorkCondition, pool->m_Mutex);
+            }
+            bool quit = pool->m_Quit;
+            generation = pool->m_Generation;
+            dmMutex::Unlock(pool->m_Mutex);
+
+            if (quit)
+                return;
+
+            RunChunks(pool, thread->m_Index);
+
+            dmMutex::Lock(pool->m_Mutex);
+            if (--pool->m_BusyWorkers == 0)
+            {
+                dmConditionVariable::Signal(pool->m_DoneCondition);
+            }
+            dmMutex::Unlock(pool->m_Mutex);
+        }
+    }
+
+    HWorkerPool NewWorkerPool(uint32_t worker_count)
+    {
+#if defined(SPINE_NO_THREADS)
+        if (worker_count > 0)
+        {
+            dmLogWarning("Spine worker threads aren't supported on this platform");
+        }
+        return 0;
+#else
+        if (worker_count == 0)
+            return 0;
+
+        WorkerPool* pool = new WorkerPool;
+        pool->m_Mutex = dmMutex::New();
+        pool->m_WorkCondition = dmConditionVariable::New();
+        pool->m_DoneCondition = dmConditionVariable::New();
+        pool->m_Fn = 0;
+        pool->m_Context = 0;
+        pool->m_Count = 0;
+        pool->m_ChunkSize = 0;
+        pool->m_ChunkCount = 0;
+        pool->m_NextChunk = 0;
+        pool->m_Generation = 0;
+        pool->m_BusyWorkers = 0;
+        pool->m_Quit = 0;
+
+        // The threads keep a pointer to their entry, so the array mustn't grow after this
+        pool->m_Threads.SetCapacity(worker_count);
+        pool->m_Threads.SetSize(worker_count);
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            WorkerThread& thread = pool->m_Threads[i];
+            thread.m_Pool = pool;
+            thread.m_Index = i + 1;
+            thread.m_Thread = dmThread::New(WorkerThreadMain, 0x20000, &thread, "spine_worker");
+        }
+        return pool;
+#endif
+    }
+
+    void DeleteWorkerPool(HWorkerPool pool)
+    {
+        if (!pool)
+            return;
+
+        dmMutex::Lock(pool->m_Mutex);
+        pool->m_Quit = 1;
+        dmConditionVariable::Broadcast(pool->m_WorkCondition);
+        dmMutex::Unlock(pool->m_Mutex);
+
+        for (uint32_t i = 0; i < pool->m_Threads.Size(); ++i)
+        {
+            dmThread::Join(pool->m_Threads[i].m_Thread);
+        }
+
+        dmConditionVariable::Delete(pool->m_WorkCondition);
+        dmConditionVariable::Delete(pool->m_DoneCondition);
+        dmMutex::Delete(pool->m_Mutex);
+        delete pool;
+    }
+
+    uint32_t GetThreadCount(HWorkerPool pool)
+    {
+        return pool ? pool->m_Threads.Size() + 1 : 1;
+    }
+
+    static void StartJob(HWorkerPool pool, uint32_t count, uint32_t chunk_size, WorkerFn fn, void* context)
+    {
+        dmMutex::Lock(pool->m_Mutex);
+        // E.g. another world's pipelined job
+        while (pool->m_BusyWorkers > 0)
+        {
+            dmConditionVariable::Wait(pool->m_DoneCondition, pool->m_Mutex);
+        }
+        pool->m_Fn = fn;
+        pool->m_Context = context;
+        pool->m_Count = count;
+        pool->m_ChunkSize = chunk_size;
+        pool->m_ChunkCount = (count + chunk_size - 1) / chunk_size;
+        dmAtomicStore32(&pool->m_NextChunk, 0);
+        pool->m_BusyWorkers = pool->m_Threads.Size();
+        pool->m_Generation++;
+        dmConditionVariable::Broadcast(pool->m_WorkCondition);
+        dmMutex::Unlock(pool->m_Mutex);
+    }
+
+    void ParallelFor(HWorkerPool pool, uint32_t count, uint32_t chunk_size, WorkerFn fn, void* context)
+    {
+        assert(_spGetArena() == 0); // See RunChunks
+        if (count == 0)
+            return;
+
+        chunk_size = dmMath::Max(chunk_size, 1U);
+        if (!pool || count <= chunk_size)
+        {
+            fn(context, 0, 0, count);
+            return;
+        }
+
+        StartJob(pool, count, chunk_size, fn, context);
+        RunChunks(pool, 0);
+        WaitParallelFor(pool);
+    }
+
+    void BeginParallelFor(HWorkerPool pool, uint32_t count, uint32_t chunk_size, WorkerFn fn, void* context)
+    {
+        assert(_spGetArena() == 0); // See RunChunks
+        if (count == 0)
+            return;
+
+        chunk_size = dmMath::Max(chunk_size, 1U);
+        if (!pool)
+        {
+            fn(context, 0, 0, count);
+            return;
+        }
+        StartJob(pool, count, chunk_size, fn, context);
+    }
+
+    void WaitParallelFor(HWorkerPool pool)
+    {
+        if (!pool)
+            return;
+
+        dmMutex::Lock(pool->m_Mutex);
+        while (pool->m_BusyWorkers > 0)
+        {
+            dmConditionVariable::Wait(pool->m_DoneCondition, pool->m_Mutex);
+        }
+        dmMutex::Unlock(pool->m_Mutex);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef DM_SPINE_WORKER_POOL_H
+#define DM_SPINE_WORKER_POOL_H
+
+#include <stdint.h>
+
+namespace dmSpine
+{
+    typedef struct WorkerPool* HWorkerPool;
+
+    // Processes the items [begin, end). The thread index is 0 for the calling thread, and 1..N for the workers
+    typedef void (*WorkerFn)(void* context, uint32_t thread_index, uint32_t begin, uint32_t end);
+
+    // Returns 0 if the worker count is 0, or if the platform doesn't support threads
+    HWorkerPool NewWorkerPool(uint32_t worker_count);
+    void        DeleteWorkerPool(HWorkerPool pool);
+
+    // The number of threads taking part in a ParallelFor (the workers and the calling thread). 1 if the pool is 0
+    uint32_t    GetThreadCount(HWorkerPool pool);
+
+    // Splits [0, count) into chunks, which are processed by the workers and the calling thread.
+    // Returns when all chunks are done. If the pool is 0, the whole range is processed on the calling thread.
+    // Must only be called from one thread at a time (the jobs are started from the main thread).
+    void        ParallelFor(HWorkerPool pool, uint32_t count, uint32_t chunk_size, WorkerFn fn, void* context);
+
+    // Same as ParallelFor, but returns immediately, and the chunks are only processed by the workers.
+    // A new job waits for the current one to finish first. If the pool is 0, the range is processed before returning.
+    void        BeginParallelFor(HWorkerPool pool, uint32_t count, uint32_t chunk_size, WorkerFn fn, void* context);
+    // Returns when the current job is done. Returns immediately if there is none
+    void        WaitParallelFor(HWorkerPool pool);
+}
+
+#endif // DM_SPINE_WORKER_POOL_H
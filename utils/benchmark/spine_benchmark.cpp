@@ -0,0 +1,1680 @@
+// Headless benchmark for the spine runtime, using the C api of the editor plugin (pluginsrc/plugin.cpp)
+// The plugin library is loaded at runtime, the same way the editor loads it.
+//
+// Build and run from the project folder (containing the game.project):
+//     ./utils/build_benchmark.sh
+//     ./build/benchmark/spine_benchmark --instances 100 --frames 300
+//
+// The results are written to stdout as json. Log output from the plugin goes to stderr.
+//
+// It can also be used as a regression test (utils/test_benchmark.sh runs all the checks):
+//     --verify utils/benchmark/golden     Compares the vertices and draw calls to the golden files
+//     --write-golden <folder>             Writes new golden files (only after checking that the output is correct!)
+//     --baseline <results.json>           Compares the total times to an earlier run, see --max-slowdown
+//     --precompiled                       Loads the scenes from precompiled skeletons (see skeleton_blob.h), as bob writes them.
+//                                         Each precompiled skeleton must also be written again unchanged after loading it
+//     --foreign-version                   Like --precompiled, but as if bob ran with another version of the extension. The scenes
+//                                         must then be loaded from the json, which the golden checks also verify
+//     --pipelined                         Generates the vertices from pose snapshots on a worker thread, while the next frame is
+//                                         updated (spine.pipelined_vertex_generation in the runtime)
+//     --reuse-instances                   With --verify: Plays the animations one after the other on one instance, which goes through
+//                                         the instance pool before each animation (spine.instance_pool_size in the runtime)
+//
+// Or only measure the parsing of the skeleton data of all the .spinejson/.skel files in the assets folder:
+//     --parse                             Parses each file --instances times, and reports the time and allocations per parse
+//
+// Or only measure the timeline keyframe lookup, with synthetic animations of increasing length:
+//     --keyframes                         Spreads the instances over the whole animation, and reports the animation update time.
+//                                         Compare to another plugin library with --baseline
+//
+// Or only measure the world vertex kernels (vertices.cpp), against the scalar path they replaced:
+//     --world-vertices                    Computes the world positions of each test asset with both, and reports the times
+//                                         and the largest difference (which must be within --tolerance)
+// The exit code is non zero if any of the checks fail.
+
+#include <dlfcn.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#if defined(__GLIBC__)
+    #include <malloc.h>
+    #define SPINE_BENCHMARK_COUNT_ALLOCATIONS
+#endif
+
+#if defined(__APPLE__)
+    #if defined(__aarch64__)
+        static const char* DEFAULT_LIBRARY = "defold-spine/plugins/lib/arm64-osx/libSpineExt.dylib";
+    #else
+        static const char* DEFAULT_LIBRARY = "defold-spine/plugins/lib/x86_64-osx/libSpineExt.dylib";
+    #endif
+#else
+    static const char* DEFAULT_LIBRARY = "defold-spine/plugins/lib/x86_64-linux/libSpineExt.so";
+#endif
+
+// *******************************************************************************************************
+// Allocation tracking
+// On glibc, the allocation functions are replaced, so that we also see the allocations made by the plugin
+// (the executable is linked with -rdynamic, see build_benchmark.sh)
+
+static uint64_t g_AllocationCount = 0;
+static int64_t  g_LiveBytes = 0;
+static int64_t  g_PeakBytes = 0;
+
+#if defined(SPINE_BENCHMARK_COUNT_ALLOCATIONS)
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void  __libc_free(void* ptr);
+
+static inline void* TrackAllocation(void* ptr)
+{
+    if (ptr)
+    {
+        ++g_AllocationCount;
+        g_LiveBytes += (int64_t)malloc_usable_size(ptr);
+        if (g_LiveBytes > g_PeakBytes)
+            g_PeakBytes = g_LiveBytes;
+    }
+    return ptr;
+}
+
+static inline void TrackFree(void* ptr)
+{
+    if (ptr)
+        g_LiveBytes -= (int64_t)malloc_usable_size(ptr);
+}
+
+extern "C" void* malloc(size_t size)
+{
+    return TrackAllocation(__libc_malloc(size));
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    return TrackAllocation(__libc_calloc(count, size));
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    TrackFree(ptr);
+    void* result = __libc_realloc(ptr, size);
+    if (!result && ptr && size)
+    {
+        g_LiveBytes += (int64_t)malloc_usable_size(ptr); // The old block is still alive
+        return 0;
+    }
+    return TrackAllocation(result);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+    return TrackAllocation(__libc_memalign(alignment, size));
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+    return TrackAllocation(__libc_memalign(alignment, size));
+}
+
+extern "C" int posix_memalign(void** out, size_t alignment, size_t size)
+{
+    void* ptr = TrackAllocation(__libc_memalign(alignment, size));
+    if (!ptr)
+        return 12; // ENOMEM
+    *out = ptr;
+    return 0;
+}
+
+extern "C" void free(void* ptr)
+{
+    TrackFree(ptr);
+    __libc_free(ptr);
+}
+
+#endif
+
+// *******************************************************************************************************
+// The plugin api
+
+typedef void* (*LoadFromBufferFn)(void* json, size_t json_size, const char* path, void* atlas_buffer, size_t atlas_size, const char* atlas_path);
+typedef void  (*DestroyFn)(void* file);
+typedef void  (*SetAnimationFn)(void* file, const char* animation);
+typedef void  (*UpdateVerticesFn)(void* file, float dt);
+typedef void* (*GetVertexBufferDataFn)(void* file, int* count);
+typedef void  (*UpdateAnimationFn)(void* file, float dt);
+typedef void  (*UpdateWorldTransformFn)(void* file);
+typedef void  (*UpdateRenderDataFn)(void* file);
+typedef const char** (*GetAnimationDataFn)(void* file, int* count);
+typedef void* (*GetRenderObjectDataFn)(void* file, int* count);
+typedef void* (*CompileSkeletonBlobFn)(void* json, size_t json_size, const char* path, int* out_size);
+typedef void  (*FreeSkeletonBlobFn)(void* blob);
+typedef void* (*LoadPrecompiledFromBufferFn)(void* blob, size_t blob_size, void* json, size_t json_size, const char* path);
+typedef int   (*IsPrecompiledFn)(void* file);
+typedef int   (*ParseSkeletonFn)(void* json, size_t json_size, const char* path);
+typedef void  (*SnapshotPoseFn)(void* file);
+typedef void  (*UpdateRenderDataFromSnapshotFn)(void* file);
+typedef const float* (*ComputeWorldVerticesFn)(void* file, const float* transform, int scalar, int* count, float* bounds);
+typedef const char** (*GetSkinDataFn)(void* file, int* count);
+typedef void  (*SetSkinFn)(void* file, const char* skin);
+typedef void  (*ReuseInstanceFn)(void* file);
+
+struct PluginApi
+{
+    void*                   m_Library;
+    LoadFromBufferFn        m_LoadFromBuffer;
+    DestroyFn               m_Destroy;
+    SetAnimationFn          m_SetAnimation;
+    UpdateVerticesFn        m_UpdateVertices;
+    GetVertexBufferDataFn   m_GetVertexBufferData;
+    // Optional. Older plugin libraries only have SPINE_UpdateVertices
+    UpdateAnimationFn       m_UpdateAnimation;
+    UpdateWorldTransformFn  m_UpdateWorldTransform;
+    UpdateRenderDataFn      m_UpdateRenderData;
+    // Used by the golden file checks
+    GetAnimationDataFn      m_GetAnimationData;
+    GetRenderObjectDataFn   m_GetRenderObjectData;
+    // Used by --precompiled
+    CompileSkeletonBlobFn   m_CompileSkeletonBlob;
+    FreeSkeletonBlobFn      m_FreeSkeletonBlob;
+    LoadPrecompiledFromBufferFn m_LoadPrecompiledFromBuffer;
+    IsPrecompiledFn         m_IsPrecompiled;
+    // Used by --parse
+    ParseSkeletonFn         m_ParseSkeleton;
+    // Used by --pipelined
+    SnapshotPoseFn                  m_SnapshotPose;
+    UpdateRenderDataFromSnapshotFn  m_UpdateRenderDataFromSnapshot;
+    // Used by --world-vertices
+    ComputeWorldVerticesFn  m_ComputeWorldVertices;
+    // Used by --reuse-instances
+    GetSkinDataFn           m_GetSkinData;
+    SetSkinFn               m_SetSkin;
+    ReuseInstanceFn         m_ReuseInstance;
+};
+
+static bool LoadPluginApi(const char* path, PluginApi* api)
+{
+    memset(api, 0, sizeof(*api));
+    api->m_Library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!api->m_Library)
+    {
+        fprintf(stderr, "Failed to load plugin library '%s': %s\n", path, dlerror());
+        return false;
+    }
+
+    api->m_LoadFromBuffer       = (LoadFromBufferFn)dlsym(api->m_Library, "SPINE_LoadFromBuffer");
+    api->m_Destroy              = (DestroyFn)dlsym(api->m_Library, "SPINE_Destroy");
+    api->m_SetAnimation         = (SetAnimationFn)dlsym(api->m_Library, "SPINE_SetAnimation");
+    api->m_UpdateVertices       = (UpdateVerticesFn)dlsym(api->m_Library, "SPINE_UpdateVertices");
+    api->m_GetVertexBufferData  = (GetVertexBufferDataFn)dlsym(api->m_Library, "SPINE_GetVertexBufferData");
+    api->m_UpdateAnimation      = (UpdateAnimationFn)dlsym(api->m_Library, "SPINE_UpdateAnimation");
+    api->m_UpdateWorldTransform = (UpdateWorldTransformFn)dlsym(api->m_Library, "SPINE_UpdateWorldTransform");
+    api->m_UpdateRenderData     = (UpdateRenderDataFn)dlsym(api->m_Library, "SPINE_UpdateRenderData");
+    api->m_GetAnimationData     = (GetAnimationDataFn)dlsym(api->m_Library, "SPINE_GetAnimationData");
+    api->m_GetRenderObjectData  = (GetRenderObjectDataFn)dlsym(api->m_Library, "SPINE_GetRenderObjectData");
+    api->m_CompileSkeletonBlob  = (CompileSkeletonBlobFn)dlsym(api->m_Library, "SPINE_CompileSkeletonBlob");
+    api->m_FreeSkeletonBlob     = (FreeSkeletonBlobFn)dlsym(api->m_Library, "SPINE_FreeSkeletonBlob");
+    api->m_LoadPrecompiledFromBuffer = (LoadPrecompiledFromBufferFn)dlsym(api->m_Library, "SPINE_LoadPrecompiledFromBuffer");
+    api->m_IsPrecompiled        = (IsPrecompiledFn)dlsym(api->m_Library, "SPINE_IsPrecompiled");
+    api->m_ParseSkeleton        = (ParseSkeletonFn)dlsym(api->m_Library, "SPINE_ParseSkeleton");
+    api->m_SnapshotPose         = (SnapshotPoseFn)dlsym(api->m_Library, "SPINE_SnapshotPose");
+    api->m_UpdateRenderDataFromSnapshot = (UpdateRenderDataFromSnapshotFn)dlsym(api->m_Library, "SPINE_UpdateRenderDataFromSnapshot");
+    api->m_ComputeWorldVertices = (ComputeWorldVerticesFn)dlsym(api->m_Library, "SPINE_ComputeWorldVertices");
+    api->m_GetSkinData          = (GetSkinDataFn)dlsym(api->m_Library, "SPINE_GetSkinData");
+    api->m_SetSkin              = (SetSkinFn)dlsym(api->m_Library, "SPINE_SetSkin");
+    api->m_ReuseInstance        = (ReuseInstanceFn)dlsym(api->m_Library, "SPINE_ReuseInstance");
+
+    if (!api->m_LoadFromBuffer || !api->m_Destroy || !api->m_SetAnimation || !api->m_UpdateVertices || !api->m_GetVertexBufferData ||
+        !api->m_GetAnimationData || !api->m_GetRenderObjectData)
+    {
+        fprintf(stderr, "The plugin library '%s' is missing required functions\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool HasPhaseApi(const PluginApi* api)
+{
+    return api->m_UpdateAnimation && api->m_UpdateWorldTransform && api->m_UpdateRenderData;
+}
+
+// *******************************************************************************************************
+// Test cases
+
+struct BenchmarkCase
+{
+    const char* m_Name;
+    const char* m_Path;         // Relative to the assets folder. 0 for generated data
+    const char* m_Animation;
+    uint32_t    m_SyntheticKeys;
+};
+
+static const BenchmarkCase CASES[] = {
+    {"spineboy",            "spineboy/spineboy.spinejson",              "walk",         0},
+    {"squirrel",            "squirrel/squirrel.spinejson",              "Idle",         0},
+    {"coins",               "coins/coin-pro.spinejson",                 "animation",    0},
+    {"sequence_animation",  "sequence_animation/sequence.spinejson",    "animation",    0},
+    {"synthetic_100_keys",  0,                                          "long",         100},
+    {"synthetic_1000_keys", 0,                                          "long",         1000},
+};
+
+static const uint32_t SYNTHETIC_BONE_COUNT = 20;
+static const float    SYNTHETIC_KEY_INTERVAL = 1.0f / 30.0f;
+
+struct Buffer
+{
+    char*   m_Data;
+    size_t  m_Size;
+    size_t  m_Capacity;
+};
+
+static void Append(Buffer* buffer, const char* format, ...)
+{
+    while (true)
+    {
+        va_list args;
+        va_start(args, format);
+        size_t remaining = buffer->m_Capacity - buffer->m_Size;
+        int n = vsnprintf(buffer->m_Data + buffer->m_Size, remaining, format, args);
+        va_end(args);
+        if (n >= 0 && (size_t)n < remaining)
+        {
+            buffer->m_Size += n;
+            return;
+        }
+        buffer->m_Capacity = buffer->m_Capacity * 2 + n + 1;
+        buffer->m_Data = (char*)realloc(buffer->m_Data, buffer->m_Capacity);
+    }
+}
+
+// A chain of bones, each with a rotate and a translate timeline with "key_count" keys
+// Used to show how the timeline lookup scales with long animations
+static Buffer CreateSyntheticSkeleton(uint32_t key_count)
+{
+    Buffer json = {0, 0, 0};
+    Append(&json, "{\"skeleton\":{\"spine\":\"4.2.0\"},\"bones\":[{\"name\":\"root\"}");
+    Append(&json, ",{\"name\":\"bone0\",\"parent\":\"root\",\"length\":20}");
+    for (uint32_t i = 1; i < SYNTHETIC_BONE_COUNT; ++i)
+    {
+        Append(&json, ",{\"name\":\"bone%u\",\"parent\":\"bone%u\",\"length\":20,\"x\":20}", i, i - 1);
+    }
+    Append(&json, "],\"animations\":{\"long\":{\"bones\":{");
+    for (uint32_t i = 0; i < SYNTHETIC_BONE_COUNT; ++i)
+    {
+        Append(&json, "%s\"bone%u\":{\"rotate\":[", i == 0 ? "" : ",", i);
+        for (uint32_t k = 0; k < key_count; ++k)
+        {
+            Append(&json, "%s{\"time\":%.4f,\"value\":%.2f}", k == 0 ? "" : ",", k * SYNTHETIC_KEY_INTERVAL, (float)((k * 7 + i * 13) % 90));
+        }
+        Append(&json, "],\"translate\":[");
+        for (uint32_t k = 0; k < key_count; ++k)
+        {
+            Append(&json, "%s{\"time\":%.4f,\"x\":%.2f,\"y\":%.2f}", k == 0 ? "" : ",", k * SYNTHETIC_KEY_INTERVAL, (float)((k * 3 + i) % 10), (float)((k * 5 + i) % 10));
+        }
+        Append(&json, "]}");
+    }
+    Append(&json, "}}}}");
+    return json;
+}
+
+static bool ReadFile(const char* path, Buffer* out)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "Failed to open '%s'\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    // The json parser expects a null terminated string
+    out->m_Data = (char*)malloc(size + 1);
+    out->m_Size = size;
+    out->m_Capacity = size + 1;
+    bool ok = fread(out->m_Data, 1, size, f) == (size_t)size;
+    out->m_Data[size] = 0;
+    fclose(f);
+    return ok;
+}
+
+// *******************************************************************************************************
+
+static uint64_t GetTimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+struct BenchmarkResult
+{
+    double      m_LoadNs;               // Per instance
+    double      m_UpdateNs;             // Per instance and frame
+    double      m_WorldTransformNs;
+    double      m_VerticesNs;
+    double      m_TotalNs;
+    uint32_t    m_VertexCount;          // Per instance, in the last frame
+    uint64_t    m_LoadAllocations;      // Per instance
+    double      m_FrameAllocations;     // Per instance and frame
+    int64_t     m_PeakHeapBytes;        // Peak heap growth during the case
+};
+
+struct BenchmarkParams
+{
+    const char* m_LibraryPath;
+    const char* m_AssetsPath;
+    uint32_t    m_Instances;
+    uint32_t    m_Frames;
+    float       m_Dt;
+    bool        m_Precompiled;
+    bool        m_ForeignVersion;
+    bool        m_Parse;
+    bool        m_Keyframes;
+    bool        m_WorldVertices;
+    bool        m_Pipelined;
+    bool        m_ReuseInstances;
+};
+
+// The data of a test case. With --precompiled, the scene is loaded from the blob, and the json is the fallback
+struct CaseData
+{
+    Buffer  m_Json;
+    Buffer  m_Blob;
+    char    m_Path[1024];
+};
+
+// The offset of SkeletonBlobHeader::m_FormatHash (see skeleton_blob.cpp)
+static const uint32_t SKELETON_BLOB_FORMAT_HASH_OFFSET = 8;
+
+// The precompiled skeleton has every field of the skeleton data, so loading it and writing it again must give the same blob
+static bool CheckPrecompiledRoundTrip(const PluginApi* api, const CaseData* data)
+{
+    int size = 0;
+    void* blob = api->m_CompileSkeletonBlob(data->m_Blob.m_Data, data->m_Blob.m_Size, data->m_Path, &size);
+    bool same = blob && (uint32_t)size == data->m_Blob.m_Size && memcmp(blob, data->m_Blob.m_Data, size) == 0;
+    if (blob)
+        api->m_FreeSkeletonBlob(blob);
+    if (!same)
+        fprintf(stderr, "The precompiled skeleton of '%s' changed when it was loaded and written again\n", data->m_Path);
+    return same;
+}
+
+// Precompiles the skeleton data, the same way bob does it
+static bool PrecompileCaseData(const PluginApi* api, const BenchmarkParams* params, CaseData* data)
+{
+    int size = 0;
+    void* blob = api->m_CompileSkeletonBlob(data->m_Json.m_Data, data->m_Json.m_Size, data->m_Path, &size);
+    if (!blob)
+    {
+        fprintf(stderr, "Failed to precompile '%s'\n", data->m_Path);
+        return false;
+    }
+    data->m_Blob.m_Data = (char*)malloc(size);
+    data->m_Blob.m_Size = size;
+    data->m_Blob.m_Capacity = size;
+    memcpy(data->m_Blob.m_Data, blob, size);
+    api->m_FreeSkeletonBlob(blob);
+
+    // As if bob ran with another version of the extension
+    if (params->m_ForeignVersion)
+        data->m_Blob.m_Data[SKELETON_BLOB_FORMAT_HASH_OFFSET] ^= 0xFF;
+    else if (!CheckPrecompiledRoundTrip(api, data))
+        return false;
+    return true;
+}
+
+static void FreeCaseData(CaseData* data)
+{
+    free(data->m_Json.m_Data);
+    free(data->m_Blob.m_Data);
+}
+
+static void* LoadInstance(const PluginApi* api, const CaseData* data)
+{
+    if (data->m_Blob.m_Data)
+        return api->m_LoadPrecompiledFromBuffer(data->m_Blob.m_Data, data->m_Blob.m_Size, data->m_Json.m_Data, data->m_Json.m_Size, data->m_Path);
+    return api->m_LoadFromBuffer(data->m_Json.m_Data, data->m_Json.m_Size, data->m_Path, 0, 0, 0);
+}
+
+// Generates the vertices from the pose snapshots of the instances on a worker thread
+struct SnapshotJob
+{
+    const PluginApi*    m_Api;
+    void**              m_Instances;
+    uint32_t            m_Count;
+    pthread_t           m_Thread;
+    bool                m_Running;
+};
+
+static void* GenerateSnapshotVertices(void* _job)
+{
+    SnapshotJob* job = (SnapshotJob*)_job;
+    for (uint32_t i = 0; i < job->m_Count; ++i)
+        job->m_Api->m_UpdateRenderDataFromSnapshot(job->m_Instances[i]);
+    return 0;
+}
+
+static void WaitSnapshotJob(SnapshotJob* job)
+{
+    if (job->m_Running)
+        pthread_join(job->m_Thread, 0);
+    job->m_Running = false;
+}
+
+static void StartSnapshotJob(SnapshotJob* job)
+{
+    WaitSnapshotJob(job);
+    for (uint32_t i = 0; i < job->m_Count; ++i)
+        job->m_Api->m_SnapshotPose(job->m_Instances[i]);
+    job->m_Running = pthread_create(&job->m_Thread, 0, GenerateSnapshotVertices, job) == 0;
+    if (!job->m_Running)
+        GenerateSnapshotVertices(job);
+}
+
+static bool LoadCaseData(const PluginApi* api, const BenchmarkParams* params, const BenchmarkCase* test, CaseData* data)
+{
+    memset(data, 0, sizeof(*data));
+    if (test->m_Path)
+    {
+        snprintf(data->m_Path, sizeof(data->m_Path), "%s/%s", params->m_AssetsPath, test->m_Path);
+        if (!ReadFile(data->m_Path, &data->m_Json))
+            return false;
+    }
+    else
+    {
+        snprintf(data->m_Path, sizeof(data->m_Path), "%s", test->m_Name);
+        data->m_Json = CreateSyntheticSkeleton(test->m_SyntheticKeys);
+    }
+    if (params->m_Precompiled && !PrecompileCaseData(api, params, data))
+    {
+        FreeCaseData(data);
+        return false;
+    }
+    return true;
+}
+
+static bool RunCase(const PluginApi* api, const BenchmarkParams* params, const BenchmarkCase* test, BenchmarkResult* result)
+{
+    memset(result, 0, sizeof(*result));
+
+    CaseData data;
+    if (!LoadCaseData(api, params, test, &data))
+        return false;
+
+    const uint32_t instance_count = params->m_Instances;
+    void** instances = (void**)calloc(instance_count, sizeof(void*));
+
+    int64_t base_bytes = g_LiveBytes;
+    g_PeakBytes = g_LiveBytes;
+    uint64_t allocations = g_AllocationCount;
+    uint64_t start = GetTimeNs();
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        instances[i] = LoadInstance(api, &data);
+        if (!instances[i])
+        {
+            fprintf(stderr, "Failed to load '%s'\n", data.m_Path);
+            for (uint32_t j = 0; j < i; ++j)
+                api->m_Destroy(instances[j]);
+            free(instances);
+            FreeCaseData(&data);
+            return false;
+        }
+    }
+    result->m_LoadNs = (double)(GetTimeNs() - start) / instance_count;
+    result->m_LoadAllocations = (g_AllocationCount - allocations) / instance_count;
+
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        api->m_SetAnimation(instances[i], test->m_Animation);
+        // Spread the instances over the animation, and let the buffers reach their working size
+        api->m_UpdateVertices(instances[i], i * 0.1f);
+    }
+
+    SnapshotJob job = {api, instances, instance_count, pthread_t(), false};
+
+    const float dt = params->m_Dt;
+    uint64_t update_ns = 0;
+    uint64_t world_transform_ns = 0;
+    uint64_t vertices_ns = 0;
+    allocations = g_AllocationCount;
+    uint64_t total_start = GetTimeNs();
+    for (uint32_t frame = 0; frame < params->m_Frames; ++frame)
+    {
+        if (params->m_Pipelined)
+        {
+            // The vertices of the previous frame are generated while this frame is updated. The vertex time
+            // is the time the main thread spends waiting for them, and taking the new snapshots.
+            uint64_t t0 = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateAnimation(instances[i], dt);
+            uint64_t t1 = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateWorldTransform(instances[i]);
+            uint64_t t2 = GetTimeNs();
+            StartSnapshotJob(&job);
+            uint64_t t3 = GetTimeNs();
+            update_ns += t1 - t0;
+            world_transform_ns += t2 - t1;
+            vertices_ns += t3 - t2;
+        }
+        else if (HasPhaseApi(api))
+        {
+            // Each phase for all instances, like the engine does
+            uint64_t t0 = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateAnimation(instances[i], dt);
+            uint64_t t1 = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateWorldTransform(instances[i]);
+            uint64_t t2 = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateRenderData(instances[i]);
+            uint64_t t3 = GetTimeNs();
+            update_ns += t1 - t0;
+            world_transform_ns += t2 - t1;
+            vertices_ns += t3 - t2;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateVertices(instances[i], dt);
+        }
+    }
+    WaitSnapshotJob(&job);
+    uint64_t total_ns = GetTimeNs() - total_start;
+
+    double samples = (double)instance_count * params->m_Frames;
+    result->m_UpdateNs = update_ns / samples;
+    result->m_WorldTransformNs = world_transform_ns / samples;
+    result->m_VerticesNs = vertices_ns / samples;
+    result->m_TotalNs = total_ns / samples;
+    result->m_FrameAllocations = (g_AllocationCount - allocations) / samples;
+
+    uint64_t vertex_count = 0;
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        int count = 0;
+        api->m_GetVertexBufferData(instances[i], &count);
+        vertex_count += count;
+    }
+    result->m_VertexCount = (uint32_t)(vertex_count / instance_count);
+    result->m_PeakHeapBytes = g_PeakBytes - base_bytes;
+
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        api->m_Destroy(instances[i]);
+    }
+    free(instances);
+    FreeCaseData(&data);
+    return true;
+}
+
+// *******************************************************************************************************
+// Parsing
+
+struct ParseResult
+{
+    size_t      m_Bytes;
+    double      m_ParseNs;              // Per parse
+    uint64_t    m_Allocations;          // Per parse
+    int64_t     m_PeakHeapBytes;
+};
+
+static char**   g_ParseFiles = 0;
+static uint32_t g_ParseFileCount = 0;
+
+static int CollectSkeletonFile(const char* path, const struct stat*, int type, struct FTW*)
+{
+    const char* ext = strrchr(path, '.');
+    if (type != FTW_F || !ext || (strcmp(ext, ".spinejson") != 0 && strcmp(ext, ".skel") != 0))
+        return 0;
+    g_ParseFiles = (char**)realloc(g_ParseFiles, (g_ParseFileCount + 1) * sizeof(char*));
+    g_ParseFiles[g_ParseFileCount++] = strdup(path);
+    return 0;
+}
+
+static int ComparePaths(const void* a, const void* b)
+{
+    return strcmp(*(const char**)a, *(const char**)b);
+}
+
+static bool RunParse(const PluginApi* api, const BenchmarkParams* params, const char* path, ParseResult* result)
+{
+    memset(result, 0, sizeof(*result));
+
+    Buffer json;
+    if (!ReadFile(path, &json))
+        return false;
+    result->m_Bytes = json.m_Size;
+
+    int64_t base_bytes = g_LiveBytes;
+    g_PeakBytes = g_LiveBytes;
+    uint64_t allocations = g_AllocationCount;
+    uint64_t start = GetTimeNs();
+    for (uint32_t i = 0; i < params->m_Instances; ++i)
+    {
+        if (!api->m_ParseSkeleton(json.m_Data, json.m_Size, path))
+        {
+            fprintf(stderr, "Failed to parse '%s'\n", path);
+            free(json.m_Data);
+            return false;
+        }
+    }
+    result->m_ParseNs = (double)(GetTimeNs() - start) / params->m_Instances;
+    result->m_Allocations = (g_AllocationCount - allocations) / params->m_Instances;
+    result->m_PeakHeapBytes = g_PeakBytes - base_bytes;
+
+    free(json.m_Data);
+    return true;
+}
+
+// *******************************************************************************************************
+// Keyframe lookup
+// The synthetic animations are played all the way through, so that the lookup is measured at every point of
+// the timelines (not only the first seconds, where even a scan from the first frame is cheap)
+
+static const uint32_t KEYFRAME_KEY_COUNTS[] = {10, 100, 1000, 2000};
+
+struct KeyframeResult
+{
+    float       m_Duration;             // Of the animation, in seconds
+    double      m_UpdateNs;             // Per instance and frame
+    double      m_TimelineNs;           // Per timeline and frame
+};
+
+static bool RunKeyframes(const PluginApi* api, const BenchmarkParams* params, const BenchmarkCase* test, KeyframeResult* result)
+{
+    memset(result, 0, sizeof(*result));
+
+    CaseData data;
+    if (!LoadCaseData(api, params, test, &data))
+        return false;
+
+    const uint32_t instance_count = params->m_Instances;
+    void** instances = (void**)calloc(instance_count, sizeof(void*));
+    result->m_Duration = (test->m_SyntheticKeys - 1) * SYNTHETIC_KEY_INTERVAL;
+    bool ok = true;
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        instances[i] = LoadInstance(api, &data);
+        if (!instances[i])
+        {
+            fprintf(stderr, "Failed to load '%s'\n", data.m_Path);
+            ok = false;
+            break;
+        }
+        api->m_SetAnimation(instances[i], test->m_Animation);
+        api->m_UpdateVertices(instances[i], result->m_Duration * i / instance_count);
+    }
+
+    if (ok)
+    {
+        const float dt = params->m_Dt;
+        uint64_t start = GetTimeNs();
+        for (uint32_t frame = 0; frame < params->m_Frames; ++frame)
+        {
+            for (uint32_t i = 0; i < instance_count; ++i)
+                api->m_UpdateAnimation(instances[i], dt);
+        }
+        double samples = (double)instance_count * params->m_Frames;
+        result->m_UpdateNs = (GetTimeNs() - start) / samples;
+        result->m_TimelineNs = result->m_UpdateNs / (SYNTHETIC_BONE_COUNT * 2);
+    }
+
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        api->m_Destroy(instances[i]);
+    }
+    free(instances);
+    FreeCaseData(&data);
+    return ok;
+}
+
+// *******************************************************************************************************
+// World vertices
+// The SIMD kernels of UpdateWorldVertexCache and the scalar path (the spine-c world vertices, and a matrix transform
+// per vertex) are run on the same poses. The transform rotates, scales and moves the model, like a game object would.
+
+static const float WORLD_VERTICES_TRANSFORM[16] = {
+    1.5f * 0.8660254f,  1.5f * 0.5f,        0.0f,   0.0f,
+    -1.5f * 0.5f,       1.5f * 0.8660254f,  0.0f,   0.0f,
+    0.0f,               0.0f,               1.0f,   0.0f,
+    100.0f,             50.0f,              0.5f,   1.0f,
+};
+
+static int CompareU64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+struct WorldVerticesResult
+{
+    uint32_t    m_VertexCount;          // Per instance, in the last frame
+    double      m_SimdNs;               // Per instance, in the median frame
+    double      m_ScalarNs;
+    float       m_MaxError;             // Relative to the largest coordinate of the model (the rounding errors grow with the magnitude of the terms)
+};
+
+static bool RunWorldVertices(const PluginApi* api, const BenchmarkParams* params, const BenchmarkCase* test, WorldVerticesResult* result)
+{
+    memset(result, 0, sizeof(*result));
+
+    CaseData data;
+    if (!LoadCaseData(api, params, test, &data))
+        return false;
+
+    const uint32_t instance_count = params->m_Instances;
+    void** instances = (void**)calloc(instance_count, sizeof(void*));
+    bool ok = true;
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        instances[i] = LoadInstance(api, &data);
+        if (!instances[i])
+        {
+            fprintf(stderr, "Failed to load '%s'\n", data.m_Path);
+            ok = false;
+            break;
+        }
+        api->m_SetAnimation(instances[i], test->m_Animation);
+        api->m_UpdateVertices(instances[i], i * 0.1f);
+    }
+
+    // The calls are short, so the median frame is used, and the order of the two is swapped every frame
+    float* simd_positions = 0;
+    uint64_t* simd_ns = (uint64_t*)calloc(params->m_Frames, sizeof(uint64_t));
+    uint64_t* scalar_ns = (uint64_t*)calloc(params->m_Frames, sizeof(uint64_t));
+    for (uint32_t frame = 0; ok && frame < params->m_Frames; ++frame)
+    {
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            api->m_UpdateAnimation(instances[i], params->m_Dt);
+            api->m_UpdateWorldTransform(instances[i]);
+        }
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            int scalar = (pass + frame) & 1;
+            uint64_t start = GetTimeNs();
+            for (uint32_t i = 0; i < instance_count; ++i)
+            {
+                int count = 0;
+                float bounds[6];
+                api->m_ComputeWorldVertices(instances[i], WORLD_VERTICES_TRANSFORM, scalar, &count, bounds);
+            }
+            (scalar ? scalar_ns : simd_ns)[frame] = GetTimeNs() - start;
+        }
+
+        // Compare the last instance. The positions are only valid until the next call on the instance
+        void* instance = instances[instance_count - 1];
+        int simd_count = 0;
+        int scalar_count = 0;
+        float simd_bounds[6];
+        float scalar_bounds[6];
+        const float* simd = api->m_ComputeWorldVertices(instance, WORLD_VERTICES_TRANSFORM, 0, &simd_count, simd_bounds);
+        simd_positions = (float*)realloc(simd_positions, sizeof(float) * 4 * (simd_count + 1));
+        memcpy(simd_positions, simd, sizeof(float) * 4 * simd_count);
+        const float* scalar = api->m_ComputeWorldVertices(instance, WORLD_VERTICES_TRANSFORM, 1, &scalar_count, scalar_bounds);
+        if (simd_count != scalar_count)
+        {
+            fprintf(stderr, "%s: %d vertices from the SIMD kernels, but %d from the scalar path\n", test->m_Name, simd_count, scalar_count);
+            ok = false;
+            break;
+        }
+        float scale = 1.0f;
+        float max_difference = 0.0f;
+        for (int v = 0; v < simd_count; ++v)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                float a = simd_positions[v * 4 + c];
+                float b = scalar[v * 4 + c];
+                scale = fabsf(b) > scale ? fabsf(b) : scale;
+                max_difference = fabsf(a - b) > max_difference ? fabsf(a - b) : max_difference;
+            }
+        }
+        for (int c = 0; c < 6; ++c)
+        {
+            float difference = fabsf(simd_bounds[c] - scalar_bounds[c]);
+            max_difference = difference > max_difference ? difference : max_difference;
+        }
+        if (max_difference / scale > result->m_MaxError)
+            result->m_MaxError = max_difference / scale;
+        result->m_VertexCount = (uint32_t)simd_count;
+    }
+
+    qsort(simd_ns, params->m_Frames, sizeof(uint64_t), CompareU64);
+    qsort(scalar_ns, params->m_Frames, sizeof(uint64_t), CompareU64);
+    result->m_SimdNs = (double)simd_ns[params->m_Frames / 2] / instance_count;
+    result->m_ScalarNs = (double)scalar_ns[params->m_Frames / 2] / instance_count;
+
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        api->m_Destroy(instances[i]);
+    }
+    free(simd_ns);
+    free(scalar_ns);
+    free(simd_positions);
+    free(instances);
+    FreeCaseData(&data);
+    return ok;
+}
+
+// *******************************************************************************************************
+// Golden files
+// Each asset is evaluated at fixed times for each of its animations, and compared to <folder>/<case name>.golden
+// The files are text, so that the changes can be reviewed. Instead of all the vertices, each sample has:
+//     sample <time> <vertex count> <draw call count> <animation>
+//     draw <vertex start> <vertex count> <blend factor>     For each draw call
+//     min/max <x y z u v r g b a page_index>                The range of each vertex component
+//     sum/weighted_sum <x y z u v r g b a page_index>       The sums of each vertex component. In the weighted sum, vertex i is
+//                                                           multiplied by (1 + i % 16), so that it also changes when vertices swap places
+//     vertex <index> <x y z u v r g b a page_index>         An evenly spaced selection of GOLDEN_VERTEX_SAMPLES vertices
+
+static const uint32_t GOLDEN_VERSION = 2;
+static const float    GOLDEN_TIMES[] = {0.25f, 1.1f};
+static const uint32_t GOLDEN_VERTEX_FLOATS = 10; // dmSpine::SpineVertex
+static const uint32_t GOLDEN_VERTEX_SAMPLES = 16;
+static const uint32_t GOLDEN_SUM_WEIGHTS = 16;
+static const char*    GOLDEN_COMPONENTS[] = {"x", "y", "z", "u", "v", "r", "g", "b", "a", "page_index"};
+
+// The parts of dmSpinePlugin::RenderObject that we compare (see pluginsrc/renderobject.h)
+struct PluginRenderObject
+{
+    uint8_t     m_StencilTestParamsTransformAndConstants[256];
+    uint32_t    m_NumConstants;
+    uint32_t    m_VertexStart;
+    uint32_t    m_VertexCount;
+    uint32_t    m_BlendFactor;
+    uint8_t     m_Flags[16];
+};
+
+static_assert(sizeof(PluginRenderObject) == 288, "Doesn't match the size of dmSpinePlugin::RenderObject");
+
+struct GoldenParams
+{
+    const char* m_WritePath;
+    const char* m_VerifyPath;
+    float       m_Tolerance;
+};
+
+struct GoldenResult
+{
+    uint32_t    m_Samples;
+    uint32_t    m_Mismatches;
+    char        m_FirstMismatch[256];
+};
+
+struct GoldenSummary
+{
+    float       m_Min[GOLDEN_VERTEX_FLOATS];
+    float       m_Max[GOLDEN_VERTEX_FLOATS];
+    double      m_Sum[GOLDEN_VERTEX_FLOATS];
+    double      m_WeightedSum[GOLDEN_VERTEX_FLOATS];
+    double      m_Scale[GOLDEN_VERTEX_FLOATS]; // The mean magnitude of the component (at least 1). Only used when verifying
+};
+
+static void SummarizeVertices(const float* vertices, uint32_t vertex_count, GoldenSummary* summary)
+{
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+    {
+        summary->m_Min[c] = vertex_count ? vertices[c] : 0.0f;
+        summary->m_Max[c] = vertex_count ? vertices[c] : 0.0f;
+        summary->m_Sum[c] = 0.0;
+        summary->m_WeightedSum[c] = 0.0;
+        summary->m_Scale[c] = 0.0;
+    }
+    for (uint32_t i = 0; i < vertex_count; ++i)
+    {
+        const float* vertex = &vertices[i * GOLDEN_VERTEX_FLOATS];
+        double weight = 1 + i % GOLDEN_SUM_WEIGHTS;
+        for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+        {
+            summary->m_Min[c] = fminf(summary->m_Min[c], vertex[c]);
+            summary->m_Max[c] = fmaxf(summary->m_Max[c], vertex[c]);
+            summary->m_Sum[c] += vertex[c];
+            summary->m_WeightedSum[c] += vertex[c] * weight;
+            summary->m_Scale[c] += fabsf(vertex[c]);
+        }
+    }
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+    {
+        double mean = vertex_count ? summary->m_Scale[c] / vertex_count : 0.0;
+        summary->m_Scale[c] = mean > 1.0 ? mean : 1.0;
+    }
+}
+
+// The distance between the sampled vertices
+static uint32_t GetVertexSampleStride(uint32_t vertex_count)
+{
+    uint32_t stride = (vertex_count + GOLDEN_VERTEX_SAMPLES - 1) / GOLDEN_VERTEX_SAMPLES;
+    return stride > 0 ? stride : 1;
+}
+
+static bool IsClose(float a, float b, float tolerance)
+{
+    float scale = fabsf(b) > 1.0f ? fabsf(b) : 1.0f;
+    return fabsf(a - b) <= tolerance * scale;
+}
+
+static void AddMismatch(GoldenResult* result, const char* animation, float time, const char* what)
+{
+    if (result->m_Mismatches++ == 0)
+    {
+        snprintf(result->m_FirstMismatch, sizeof(result->m_FirstMismatch), "%s at %.2f: %s", animation, time, what);
+    }
+}
+
+// Reads the next line, skipping comments and empty lines
+// Returns the text after the keyword, or 0 if the line doesn't start with the keyword
+static const char* ReadGoldenLine(FILE* f, const char* keyword, char* line, uint32_t line_size)
+{
+    do
+    {
+        if (!fgets(line, line_size, f))
+            return 0;
+    } while (line[0] == '#' || line[0] == '\n');
+
+    size_t length = strlen(keyword);
+    if (strncmp(line, keyword, length) != 0 || line[length] != ' ')
+        return 0;
+    return line + length + 1;
+}
+
+// Returns false if the text is missing (0), or has too few values
+static bool ParseFloats(const char* text, float* values, uint32_t count)
+{
+    if (!text)
+        return false;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char* end = 0;
+        values[i] = strtof(text, &end);
+        if (end == text)
+            return false;
+        text = end;
+    }
+    return true;
+}
+
+static bool ParseDoubles(const char* text, double* values, uint32_t count)
+{
+    if (!text)
+        return false;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char* end = 0;
+        values[i] = strtod(text, &end);
+        if (end == text)
+            return false;
+        text = end;
+    }
+    return true;
+}
+
+static void WriteFloats(FILE* f, const char* keyword, const float* values)
+{
+    fprintf(f, "%s", keyword);
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+        fprintf(f, " %.9g", values[c]);
+    fprintf(f, "\n");
+}
+
+static void WriteDoubles(FILE* f, const char* keyword, const double* values)
+{
+    fprintf(f, "%s", keyword);
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+        fprintf(f, " %.12g", values[c]);
+    fprintf(f, "\n");
+}
+
+// Compares the values, and adds a mismatch for the first one that differs
+static bool VerifyFloats(const char* what, const float* values, const float* golden, float tolerance, const char* animation, float time, GoldenResult* result)
+{
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+    {
+        if (!IsClose(values[c], golden[c], tolerance))
+        {
+            char text[128];
+            snprintf(text, sizeof(text), "%s %s is %f, expected %f", what, GOLDEN_COMPONENTS[c], values[c], golden[c]);
+            AddMismatch(result, animation, time, text);
+            return false;
+        }
+    }
+    return true;
+}
+
+// The sums may differ by the tolerance of a single vertex of average size
+static bool VerifySums(const char* what, const double* values, const double* golden, const double* scale, double weight, float tolerance,
+                       const char* animation, float time, GoldenResult* result)
+{
+    for (uint32_t c = 0; c < GOLDEN_VERTEX_FLOATS; ++c)
+    {
+        if (!(fabs(values[c] - golden[c]) <= tolerance * scale[c] * weight))
+        {
+            char text[128];
+            snprintf(text, sizeof(text), "%s %s is %f, expected %f", what, GOLDEN_COMPONENTS[c], values[c], golden[c]);
+            AddMismatch(result, animation, time, text);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compares the current output with the next sample in the file
+static void VerifySample(FILE* f, const char* animation, float time, const float* vertices, uint32_t vertex_count,
+                         const PluginRenderObject* ros, uint32_t ro_count, float tolerance, GoldenResult* result)
+{
+    char line[1024];
+    const char* text = ReadGoldenLine(f, "sample", line, sizeof(line));
+    float golden_time = 0;
+    uint32_t golden_vertex_count = 0;
+    uint32_t golden_ro_count = 0;
+    int name_offset = 0;
+    if (!text || sscanf(text, "%f %u %u %n", &golden_time, &golden_vertex_count, &golden_ro_count, &name_offset) != 3)
+    {
+        AddMismatch(result, animation, time, "missing sample");
+        return;
+    }
+    const char* golden_name = text + name_offset;
+    size_t name_length = strcspn(golden_name, "\n");
+    if (name_length != strlen(animation) || strncmp(golden_name, animation, name_length) != 0 || !IsClose(golden_time, time, 0.0001f))
+    {
+        AddMismatch(result, animation, time, "the samples don't match (the animations have changed?)");
+        return;
+    }
+
+    char what[128];
+    bool draw_calls_match = golden_ro_count == ro_count;
+    if (!draw_calls_match)
+    {
+        snprintf(what, sizeof(what), "draw call count %u, expected %u", ro_count, golden_ro_count);
+        AddMismatch(result, animation, time, what);
+    }
+    for (uint32_t i = 0; i < golden_ro_count; ++i)
+    {
+        uint32_t golden[3] = {0, 0, 0};
+        text = ReadGoldenLine(f, "draw", line, sizeof(line));
+        if (!text || sscanf(text, "%u %u %u", &golden[0], &golden[1], &golden[2]) != 3)
+        {
+            AddMismatch(result, animation, time, "missing draw call");
+            return;
+        }
+        if (draw_calls_match && (ros[i].m_VertexStart != golden[0] || ros[i].m_VertexCount != golden[1] || ros[i].m_BlendFactor != golden[2]))
+        {
+            snprintf(what, sizeof(what), "draw call %u is (%u, %u, %u), expected (%u, %u, %u)", i,
+                     ros[i].m_VertexStart, ros[i].m_VertexCount, ros[i].m_BlendFactor, golden[0], golden[1], golden[2]);
+            AddMismatch(result, animation, time, what);
+            draw_calls_match = false;
+        }
+    }
+
+    GoldenSummary golden;
+    bool complete = ParseFloats(ReadGoldenLine(f, "min", line, sizeof(line)), golden.m_Min, GOLDEN_VERTEX_FLOATS);
+    complete = complete && ParseFloats(ReadGoldenLine(f, "max", line, sizeof(line)), golden.m_Max, GOLDEN_VERTEX_FLOATS);
+    complete = complete && ParseDoubles(ReadGoldenLine(f, "sum", line, sizeof(line)), golden.m_Sum, GOLDEN_VERTEX_FLOATS);
+    complete = complete && ParseDoubles(ReadGoldenLine(f, "weighted_sum", line, sizeof(line)), golden.m_WeightedSum, GOLDEN_VERTEX_FLOATS);
+    if (!complete)
+    {
+        AddMismatch(result, animation, time, "missing vertex summary");
+        return;
+    }
+
+    bool vertices_match = golden_vertex_count == vertex_count;
+    if (!vertices_match)
+    {
+        snprintf(what, sizeof(what), "vertex count %u, expected %u", vertex_count, golden_vertex_count);
+        AddMismatch(result, animation, time, what);
+    }
+    else
+    {
+        GoldenSummary summary;
+        SummarizeVertices(vertices, vertex_count, &summary);
+        vertices_match = VerifyFloats("min", summary.m_Min, golden.m_Min, tolerance, animation, time, result) &&
+                         VerifyFloats("max", summary.m_Max, golden.m_Max, tolerance, animation, time, result) &&
+                         VerifySums("sum", summary.m_Sum, golden.m_Sum, summary.m_Scale, 1.0, tolerance, animation, time, result) &&
+                         VerifySums("weighted sum", summary.m_WeightedSum, golden.m_WeightedSum, summary.m_Scale, GOLDEN_SUM_WEIGHTS, tolerance, animation, time, result);
+    }
+
+    uint32_t stride = GetVertexSampleStride(golden_vertex_count);
+    for (uint32_t i = 0; i < golden_vertex_count; i += stride)
+    {
+        uint32_t index = 0;
+        int offset = 0;
+        float golden_vertex[GOLDEN_VERTEX_FLOATS];
+        text = ReadGoldenLine(f, "vertex", line, sizeof(line));
+        if (!text || sscanf(text, "%u %n", &index, &offset) != 1 || index != i || !ParseFloats(text + offset, golden_vertex, GOLDEN_VERTEX_FLOATS))
+        {
+            AddMismatch(result, animation, time, "missing vertex");
+            return;
+        }
+        if (vertices_match)
+        {
+            snprintf(what, sizeof(what), "vertex %u", i);
+            vertices_match = VerifyFloats(what, &vertices[i * GOLDEN_VERTEX_FLOATS], golden_vertex, tolerance, animation, time, result);
+        }
+    }
+}
+
+static void WriteSample(FILE* f, const char* animation, float time, const float* vertices, uint32_t vertex_count,
+                        const PluginRenderObject* ros, uint32_t ro_count)
+{
+    fprintf(f, "\nsample %g %u %u %s\n", time, vertex_count, ro_count, animation);
+    for (uint32_t i = 0; i < ro_count; ++i)
+    {
+        fprintf(f, "draw %u %u %u\n", ros[i].m_VertexStart, ros[i].m_VertexCount, ros[i].m_BlendFactor);
+    }
+
+    GoldenSummary summary;
+    SummarizeVertices(vertices, vertex_count, &summary);
+    WriteFloats(f, "min", summary.m_Min);
+    WriteFloats(f, "max", summary.m_Max);
+    WriteDoubles(f, "sum", summary.m_Sum);
+    WriteDoubles(f, "weighted_sum", summary.m_WeightedSum);
+
+    uint32_t stride = GetVertexSampleStride(vertex_count);
+    for (uint32_t i = 0; i < vertex_count; i += stride)
+    {
+        char keyword[32];
+        snprintf(keyword, sizeof(keyword), "vertex %u", i);
+        WriteFloats(f, keyword, &vertices[i * GOLDEN_VERTEX_FLOATS]);
+    }
+}
+
+// Returns false if the golden file couldn't be read or written
+static bool RunGolden(const PluginApi* api, const BenchmarkParams* params, const GoldenParams* golden_params, const BenchmarkCase* test, GoldenResult* result)
+{
+    memset(result, 0, sizeof(*result));
+
+    CaseData data;
+    if (!LoadCaseData(api, params, test, &data))
+        return false;
+
+    bool write = golden_params->m_WritePath != 0;
+    char golden_path[1024];
+    snprintf(golden_path, sizeof(golden_path), "%s/%s.golden", write ? golden_params->m_WritePath : golden_params->m_VerifyPath, test->m_Name);
+    FILE* f = fopen(golden_path, write ? "w" : "r");
+    if (!f)
+    {
+        fprintf(stderr, "Failed to open '%s'\n", golden_path);
+        FreeCaseData(&data);
+        return false;
+    }
+
+    void* file = LoadInstance(api, &data);
+    int animation_count = 0;
+    if (file)
+        api->m_GetAnimationData(file, &animation_count);
+    api->m_Destroy(file);
+
+    const uint32_t time_count = sizeof(GOLDEN_TIMES) / sizeof(GOLDEN_TIMES[0]);
+    if (write)
+    {
+        fprintf(f, "# Spine golden samples of %s, written by spine_benchmark --write-golden (see utils/benchmark/spine_benchmark.cpp)\n", test->m_Path);
+        fprintf(f, "version %u\n", GOLDEN_VERSION);
+        fprintf(f, "samples %u\n", animation_count * time_count);
+    }
+    else
+    {
+        char line[256];
+        uint32_t version = 0;
+        uint32_t sample_count = 0;
+        const char* version_text = ReadGoldenLine(f, "version", line, sizeof(line));
+        if (!version_text || sscanf(version_text, "%u", &version) != 1 || version != GOLDEN_VERSION)
+        {
+            fprintf(stderr, "'%s' isn't a golden file, or has the wrong version\n", golden_path);
+            fclose(f);
+            FreeCaseData(&data);
+            return false;
+        }
+        const char* count_text = ReadGoldenLine(f, "samples", line, sizeof(line));
+        if (!count_text || sscanf(count_text, "%u", &sample_count) != 1 || sample_count != animation_count * time_count)
+        {
+            AddMismatch(result, "", 0, "the sample count doesn't match (the animations have changed?)");
+            animation_count = 0;
+        }
+    }
+
+    // The golden files are always written with new instances
+    bool reuse = params->m_ReuseInstances && !write;
+    file = 0;
+    for (int a = 0; a < animation_count; ++a)
+    {
+        if (reuse && file)
+        {
+            // Leave another skin set, and then reset the instance. It should play as a new instance.
+            int skin_count = 0;
+            const char** skins = api->m_GetSkinData(file, &skin_count);
+            if (skin_count > 0)
+                api->m_SetSkin(file, skins[skin_count - 1]);
+            api->m_ReuseInstance(file);
+        }
+        else
+        {
+            // A new instance for each animation, so that the result doesn't depend on the order
+            file = LoadInstance(api, &data);
+        }
+        if (!file)
+        {
+            AddMismatch(result, "", 0, "failed to load the scene");
+            break;
+        }
+        if (params->m_Precompiled && (api->m_IsPrecompiled(file) != 0) == params->m_ForeignVersion)
+        {
+            AddMismatch(result, "", 0, params->m_ForeignVersion ? "loaded a precompiled skeleton of another version"
+                                                                : "didn't load the precompiled skeleton");
+            break;
+        }
+        // The names are owned by the instance
+        int count = 0;
+        const char* animation = api->m_GetAnimationData(file, &count)[a];
+        api->m_SetAnimation(file, animation);
+
+        float time = 0.0f;
+        float instance_time = 0.0f;
+        for (uint32_t t = 0; t < time_count; ++t)
+        {
+            if (params->m_Pipelined)
+            {
+                api->m_UpdateAnimation(file, GOLDEN_TIMES[t] - instance_time);
+                api->m_UpdateWorldTransform(file);
+                SnapshotJob job = {api, &file, 1, pthread_t(), false};
+                StartSnapshotJob(&job);
+                // Change the instance while the vertices are generated, like the next frame does
+                float next_time = t + 1 < time_count ? GOLDEN_TIMES[t + 1] : GOLDEN_TIMES[t] + 1.0f;
+                instance_time = (GOLDEN_TIMES[t] + next_time) * 0.5f;
+                api->m_UpdateAnimation(file, instance_time - GOLDEN_TIMES[t]);
+                api->m_UpdateWorldTransform(file);
+                WaitSnapshotJob(&job);
+            }
+            else
+            {
+                api->m_UpdateVertices(file, GOLDEN_TIMES[t] - time);
+            }
+            time = GOLDEN_TIMES[t];
+
+            int vertex_count = 0;
+            int ro_count = 0;
+            const float* vertices = (const float*)api->m_GetVertexBufferData(file, &vertex_count);
+            const PluginRenderObject* ros = (const PluginRenderObject*)api->m_GetRenderObjectData(file, &ro_count);
+            if (write)
+                WriteSample(f, animation, time, vertices, vertex_count, ros, ro_count);
+            else
+                VerifySample(f, animation, time, vertices, vertex_count, ros, ro_count, golden_params->m_Tolerance, result);
+            result->m_Samples++;
+        }
+        if (!reuse)
+        {
+            api->m_Destroy(file);
+            file = 0;
+        }
+    }
+    api->m_Destroy(file);
+
+    fclose(f);
+    FreeCaseData(&data);
+    return true;
+}
+
+// *******************************************************************************************************
+// Performance regressions
+// The baseline is the output of an earlier run. As it's our own format, we only look for the
+// "name" and "total_ns" on each line
+
+static bool GetBaselineTotalNs(const Buffer* baseline, const char* name, double* total_ns)
+{
+    char key[128];
+    snprintf(key, sizeof(key), "{\"name\": \"%s\",", name);
+    const char* line = strstr(baseline->m_Data, key);
+    if (!line)
+        return false;
+    const char* end = strchr(line, '\n');
+    const char* value = strstr(line, "\"total_ns\": ");
+    if (!value || (end && value > end))
+        return false;
+    *total_ns = atof(value + strlen("\"total_ns\": "));
+    return *total_ns > 0.0;
+}
+
+static void PrintUsage()
+{
+    fprintf(stderr, "Usage: spine_benchmark [--lib <plugin library>] [--assets <folder>] [--instances <n>] [--frames <n>] [--dt <seconds>] [--case <name>]\n"
+                    "                       [--verify <golden folder>] [--write-golden <folder>] [--tolerance <relative error>]\n"
+                    "                       [--baseline <results.json>] [--max-slowdown <ratio>] [--precompiled] [--foreign-version] [--pipelined] [--reuse-instances] [--parse] [--keyframes]\n"
+                    "                       [--world-vertices]\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkParams params;
+    params.m_LibraryPath = DEFAULT_LIBRARY;
+    params.m_AssetsPath = "assets";
+    params.m_Instances = 100;
+    params.m_Frames = 300;
+    params.m_Dt = 1.0f / 60.0f;
+    params.m_Precompiled = false;
+    params.m_ForeignVersion = false;
+    params.m_Parse = false;
+    params.m_Keyframes = false;
+    params.m_WorldVertices = false;
+    params.m_Pipelined = false;
+    params.m_ReuseInstances = false;
+    const char* case_filter = 0;
+
+    GoldenParams golden_params;
+    golden_params.m_WritePath = 0;
+    golden_params.m_VerifyPath = 0;
+    golden_params.m_Tolerance = 0.001f;
+    const char* baseline_path = 0;
+    double max_slowdown = 1.25;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--precompiled") == 0)
+        {
+            params.m_Precompiled = true;
+            continue;
+        }
+        if (strcmp(arg, "--foreign-version") == 0)
+        {
+            params.m_Precompiled = true;
+            params.m_ForeignVersion = true;
+            continue;
+        }
+        if (strcmp(arg, "--pipelined") == 0)
+        {
+            params.m_Pipelined = true;
+            continue;
+        }
+        if (strcmp(arg, "--reuse-instances") == 0)
+        {
+            params.m_ReuseInstances = true;
+            continue;
+        }
+        if (strcmp(arg, "--parse") == 0)
+        {
+            params.m_Parse = true;
+            continue;
+        }
+        if (strcmp(arg, "--keyframes") == 0)
+        {
+            params.m_Keyframes = true;
+            continue;
+        }
+        if (strcmp(arg, "--world-vertices") == 0)
+        {
+            params.m_WorldVertices = true;
+            continue;
+        }
+        const char* value = i + 1 < argc ? argv[i + 1] : 0;
+        if (!value)
+        {
+            PrintUsage();
+            return 1;
+        }
+        if (strcmp(arg, "--lib") == 0)                  params.m_LibraryPath = value;
+        else if (strcmp(arg, "--assets") == 0)          params.m_AssetsPath = value;
+        else if (strcmp(arg, "--instances") == 0)       params.m_Instances = (uint32_t)atoi(value);
+        else if (strcmp(arg, "--frames") == 0)          params.m_Frames = (uint32_t)atoi(value);
+        else if (strcmp(arg, "--dt") == 0)              params.m_Dt = (float)atof(value);
+        else if (strcmp(arg, "--case") == 0)            case_filter = value;
+        else if (strcmp(arg, "--verify") == 0)          golden_params.m_VerifyPath = value;
+        else if (strcmp(arg, "--write-golden") == 0)    golden_params.m_WritePath = value;
+        else if (strcmp(arg, "--tolerance") == 0)       golden_params.m_Tolerance = (float)atof(value);
+        else if (strcmp(arg, "--baseline") == 0)        baseline_path = value;
+        else if (strcmp(arg, "--max-slowdown") == 0)    max_slowdown = atof(value);
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+        ++i;
+    }
+
+    if (params.m_Instances == 0 || params.m_Frames == 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Buffer baseline = {0, 0, 0};
+    if (baseline_path && !ReadFile(baseline_path, &baseline))
+        return 1;
+
+    PluginApi api;
+    if (!LoadPluginApi(params.m_LibraryPath, &api))
+        return 1;
+
+    if (params.m_Precompiled && (!api.m_CompileSkeletonBlob || !api.m_FreeSkeletonBlob || !api.m_LoadPrecompiledFromBuffer || !api.m_IsPrecompiled))
+    {
+        fprintf(stderr, "The plugin library '%s' can't precompile skeletons\n", params.m_LibraryPath);
+        return 1;
+    }
+
+    if (params.m_Pipelined && (!api.m_SnapshotPose || !api.m_UpdateRenderDataFromSnapshot || !HasPhaseApi(&api)))
+    {
+        fprintf(stderr, "The plugin library '%s' can't generate vertices from pose snapshots\n", params.m_LibraryPath);
+        return 1;
+    }
+
+    if (params.m_ReuseInstances && (!api.m_ReuseInstance || !api.m_GetSkinData || !api.m_SetSkin))
+    {
+        fprintf(stderr, "The plugin library '%s' can't reuse instances\n", params.m_LibraryPath);
+        return 1;
+    }
+
+    if (params.m_Parse && !api.m_ParseSkeleton)
+    {
+        fprintf(stderr, "The plugin library '%s' can't parse skeletons on their own\n", params.m_LibraryPath);
+        return 1;
+    }
+
+    bool phases = HasPhaseApi(&api);
+    if (params.m_Keyframes && !phases)
+    {
+        fprintf(stderr, "The plugin library '%s' has no per phase api, which the keyframe lookup is measured with\n", params.m_LibraryPath);
+        return 1;
+    }
+    if (params.m_WorldVertices && (!api.m_ComputeWorldVertices || !phases))
+    {
+        fprintf(stderr, "The plugin library '%s' can't compute the world vertices on their own\n", params.m_LibraryPath);
+        return 1;
+    }
+    if (!phases)
+    {
+        fprintf(stderr, "The plugin library has no per phase api. Only the total time is measured.\n");
+    }
+
+    printf("{\n");
+    printf("  \"library\": \"%s\",\n", params.m_LibraryPath);
+    printf("  \"instances\": %u,\n", params.m_Instances);
+    printf("  \"frames\": %u,\n", params.m_Frames);
+    printf("  \"dt\": %g,\n", params.m_Dt);
+    printf("  \"precompiled\": %s,\n", params.m_Precompiled ? "true" : "false");
+    printf("  \"foreign_version\": %s,\n", params.m_ForeignVersion ? "true" : "false");
+    printf("  \"parse\": %s,\n", params.m_Parse ? "true" : "false");
+    printf("  \"keyframes\": %s,\n", params.m_Keyframes ? "true" : "false");
+    printf("  \"world_vertices\": %s,\n", params.m_WorldVertices ? "true" : "false");
+    printf("  \"pipelined\": %s,\n", params.m_Pipelined ? "true" : "false");
+    printf("  \"reuse_instances\": %s,\n", params.m_ReuseInstances ? "true" : "false");
+#if defined(SPINE_BENCHMARK_COUNT_ALLOCATIONS)
+    printf("  \"allocations_tracked\": true,\n");
+#else
+    printf("  \"allocations_tracked\": false,\n");
+#endif
+    printf("  \"results\": [");
+
+    int result_code = 0;
+    bool first = true;
+    if (params.m_Parse)
+    {
+        nftw(params.m_AssetsPath, CollectSkeletonFile, 16, FTW_PHYS);
+        qsort(g_ParseFiles, g_ParseFileCount, sizeof(char*), ComparePaths);
+        if (g_ParseFileCount == 0)
+        {
+            fprintf(stderr, "Found no skeleton files in '%s'\n", params.m_AssetsPath);
+            result_code = 1;
+        }
+    }
+    for (uint32_t f = 0; params.m_Parse && f < g_ParseFileCount; ++f)
+    {
+        const char* path = g_ParseFiles[f];
+        ParseResult r;
+        if (!RunParse(&api, &params, path, &r))
+        {
+            result_code = 1;
+            continue;
+        }
+        printf("%s\n    {\"name\": \"%s\", \"bytes\": %llu, \"parse_ns\": %.1f, \"parse_allocations\": %llu, \"peak_heap_bytes\": %lld}",
+               first ? "" : ",", path, (unsigned long long)r.m_Bytes, r.m_ParseNs, (unsigned long long)r.m_Allocations, (long long)r.m_PeakHeapBytes);
+        first = false;
+        fflush(stdout);
+    }
+    for (uint32_t k = 0; params.m_Keyframes && k < sizeof(KEYFRAME_KEY_COUNTS) / sizeof(KEYFRAME_KEY_COUNTS[0]); ++k)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "keyframes_%u", KEYFRAME_KEY_COUNTS[k]);
+        if (case_filter && strcmp(case_filter, name) != 0)
+            continue;
+
+        BenchmarkCase test = {name, 0, "long", KEYFRAME_KEY_COUNTS[k]};
+        KeyframeResult r;
+        if (!RunKeyframes(&api, &params, &test, &r))
+        {
+            result_code = 1;
+            continue;
+        }
+
+        // Named total_ns, so that --baseline compares it
+        printf("%s\n    {\"name\": \"%s\", \"keys\": %u, \"duration\": %.2f, \"total_ns\": %.1f, \"timeline_ns\": %.1f",
+               first ? "" : ",", name, KEYFRAME_KEY_COUNTS[k], r.m_Duration, r.m_UpdateNs, r.m_TimelineNs);
+
+        double baseline_ns = 0.0;
+        if (baseline.m_Data && GetBaselineTotalNs(&baseline, name, &baseline_ns))
+        {
+            double slowdown = r.m_UpdateNs / baseline_ns;
+            printf(", \"slowdown\": %.3f", slowdown);
+            if (slowdown > max_slowdown)
+            {
+                fprintf(stderr, "%s: %.1f ns is %.2fx slower than the baseline (%.1f ns). The limit is %.2fx\n", name, r.m_UpdateNs, slowdown, baseline_ns, max_slowdown);
+                result_code = 1;
+            }
+        }
+        printf("}");
+        first = false;
+        fflush(stdout);
+    }
+    for (uint32_t c = 0; params.m_WorldVertices && c < sizeof(CASES) / sizeof(CASES[0]); ++c)
+    {
+        // The synthetic skeletons have no attachments
+        const BenchmarkCase* test = &CASES[c];
+        if (!test->m_Path || (case_filter && strcmp(case_filter, test->m_Name) != 0))
+            continue;
+
+        WorldVerticesResult r;
+        if (!RunWorldVertices(&api, &params, test, &r))
+        {
+            result_code = 1;
+            continue;
+        }
+
+        printf("%s\n    {\"name\": \"%s\", \"animation\": \"%s\", \"vertices\": %u, \"simd_ns\": %.1f, \"scalar_ns\": %.1f, \"speedup\": %.2f, \"max_error\": %g}",
+               first ? "" : ",", test->m_Name, test->m_Animation, r.m_VertexCount, r.m_SimdNs, r.m_ScalarNs, r.m_ScalarNs / r.m_SimdNs, r.m_MaxError);
+        if (r.m_MaxError > golden_params.m_Tolerance)
+        {
+            fprintf(stderr, "%s: The SIMD kernels differ from the scalar path by %g. The limit is %g\n", test->m_Name, r.m_MaxError, golden_params.m_Tolerance);
+            result_code = 1;
+        }
+        first = false;
+        fflush(stdout);
+    }
+    for (uint32_t c = 0; !params.m_Parse && !params.m_Keyframes && !params.m_WorldVertices && c < sizeof(CASES) / sizeof(CASES[0]); ++c)
+    {
+        const BenchmarkCase* test = &CASES[c];
+        if (case_filter && strcmp(case_filter, test->m_Name) != 0)
+            continue;
+
+        // Only the assets have vertices to compare
+        bool golden = (golden_params.m_WritePath || golden_params.m_VerifyPath) && test->m_Path;
+        GoldenResult g;
+        if (golden && !RunGolden(&api, &params, &golden_params, test, &g))
+        {
+            result_code = 1;
+            continue;
+        }
+
+        BenchmarkResult r;
+        if (!RunCase(&api, &params, test, &r))
+        {
+            result_code = 1;
+            continue;
+        }
+
+        printf("%s\n    {\"name\": \"%s\", \"animation\": \"%s\", \"vertices\": %u, \"load_ns\": %.1f, ",
+               first ? "" : ",", test->m_Name, test->m_Animation, r.m_VertexCount, r.m_LoadNs);
+        if (phases)
+            printf("\"update_ns\": %.1f, \"world_transform_ns\": %.1f, \"vertices_ns\": %.1f, ", r.m_UpdateNs, r.m_WorldTransformNs, r.m_VerticesNs);
+        else
+            printf("\"update_ns\": null, \"world_transform_ns\": null, \"vertices_ns\": null, ");
+        printf("\"total_ns\": %.1f, \"load_allocations\": %llu, \"frame_allocations\": %.3f, \"peak_heap_bytes\": %lld",
+               r.m_TotalNs, (unsigned long long)r.m_LoadAllocations, r.m_FrameAllocations, (long long)r.m_PeakHeapBytes);
+
+        if (golden && golden_params.m_VerifyPath)
+        {
+            printf(", \"golden_samples\": %u, \"golden_mismatches\": %u", g.m_Samples, g.m_Mismatches);
+            if (g.m_Mismatches)
+            {
+                fprintf(stderr, "%s: %u golden mismatches. First: %s\n", test->m_Name, g.m_Mismatches, g.m_FirstMismatch);
+                result_code = 1;
+            }
+        }
+
+        double baseline_ns = 0.0;
+        if (baseline.m_Data && GetBaselineTotalNs(&baseline, test->m_Name, &baseline_ns))
+        {
+            double slowdown = r.m_TotalNs / baseline_ns;
+            printf(", \"slowdown\": %.3f", slowdown);
+            if (slowdown > max_slowdown)
+            {
+                fprintf(stderr, "%s: %.1f ns is %.2fx slower than the baseline (%.1f ns). The limit is %.2fx\n", test->m_Name, r.m_TotalNs, slowdown, baseline_ns, max_slowdown);
+                result_code = 1;
+            }
+        }
+        printf("}");
+        first = false;
+        fflush(stdout);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    long max_rss_kb = usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    long max_rss_kb = usage.ru_maxrss;
+#endif
+    printf("\n  ],\n");
+    printf("  \"max_rss_kb\": %ld\n", max_rss_kb);
+    printf("}\n");
+
+    free(baseline.m_Data);
+    for (uint32_t f = 0; f < g_ParseFileCount; ++f)
+        free(g_ParseFiles[f]);
+    free(g_ParseFiles);
+
+    // The plugin library isn't unloaded, since it may have registered static destructors
+    return result_code;
+}
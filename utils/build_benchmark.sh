@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+
+# Run from the project folder (containing the game.project)
+# Builds the headless benchmark. It loads the editor plugin library, so build that first (see build_plugins.sh)
+# Usage: ./utils/build_benchmark.sh && ./build/benchmark/spine_benchmark --help
+
+set -e
+
+if [ "" == "${CXX}" ]; then
+    CXX=c++
+fi
+
+TARGET_DIR=./build/benchmark
+mkdir -p $TARGET_DIR
+
+# -rdynamic: The allocation functions in the executable are also used by the plugin library
+LIBS=
+if [ "$(uname)" == "Linux" ]; then
+    LIBS=-ldl
+fi
+
+${CXX} -O2 -g -rdynamic -pthread -o ${TARGET_DIR}/spine_benchmark ./utils/benchmark/spine_benchmark.cpp ${LIBS}
+
+echo "Built ${TARGET_DIR}/spine_benchmark"
@@ -0,0 +1,45 @@
+#!/usr/bin/env bash
+
+# Run from the project folder (containing the game.project)
+# Checks that the prebuilt runtime libraries in defold-spine/lib were rebuilt (see build_libs.sh) after the last
+# change to the sources they are built from: each library must hold an object for every source file in commonsrc,
+# and must not be older than the last commit that touched commonsrc or include.
+# Needs the full git history (e.g. fetch-depth: 0 on the checkout action).
+# Usage: ./utils/check_libs.sh
+
+set -e
+
+PROJECT_DIR=defold-spine
+SOURCE_DIRS="${PROJECT_DIR}/commonsrc ${PROJECT_DIR}/include"
+
+SOURCES=$(cd ${PROJECT_DIR}/commonsrc && ls *.cpp spine/*.c | xargs -n 1 basename)
+
+SOURCE_COMMIT=$(git log -1 --format=%H -- ${SOURCE_DIRS})
+SOURCE_TIME=$(git log -1 --format=%ct -- ${SOURCE_DIRS})
+
+echo "Last change to the library sources: ${SOURCE_COMMIT}"
+
+STALE=0
+for path in ${PROJECT_DIR}/lib/*/*spinec.*; do
+    OBJECTS=$(ar t ${path})
+
+    for source in ${SOURCES}; do
+        if ! echo "${OBJECTS}" | grep -q "^${source}_[0-9]*\.o$"; then
+            echo "${path}: missing ${source}"
+            STALE=1
+        fi
+    done
+
+    LIB_TIME=$(git log -1 --format=%ct -- ${path})
+    if [ "${LIB_TIME}" -lt "${SOURCE_TIME}" ]; then
+        echo "${path}: built before ${SOURCE_COMMIT} ($(git log -1 --format=%h -- ${path}))"
+        STALE=1
+    fi
+done
+
+if [ ${STALE} -ne 0 ]; then
+    echo "The libraries are out of date. Rebuild them with ./utils/build_libs.sh, and check them in."
+    exit 1
+fi
+
+echo "All libraries are up to date"
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+
+# Run from the project folder (containing the game.project)
+# Checks the output of the editor plugin library against the golden files, in each of the runtime modes.
+# Build the plugin library first (see build_plugins.sh), or pass the path to another build.
+# Usage: ./utils/test_benchmark.sh [<plugin library>]
+
+set -e
+
+BENCHMARK=./build/benchmark/spine_benchmark
+GOLDEN=./utils/benchmark/golden
+
+LIBRARY_ARGS=
+if [ "" != "$1" ]; then
+    LIBRARY_ARGS="--lib $1"
+fi
+
+./utils/build_benchmark.sh
+
+for MODE in "" "--precompiled" "--foreign-version" "--pipelined" "--reuse-instances"; do
+    echo "Verifying the golden files ${MODE}"
+    ${BENCHMARK} ${LIBRARY_ARGS} --verify ${GOLDEN} --instances 5 --frames 10 ${MODE} > /dev/null
+done
+
+echo "Comparing the world vertex kernels to the scalar path"
+${BENCHMARK} ${LIBRARY_ARGS} --world-vertices --instances 5 --frames 10 > /dev/null
+
+echo "All checks passed"